@@ -0,0 +1,200 @@
+/*
+ * cgstat.c - report cgroup v2 resource usage at an interval
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <getopt.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "c.h"
+#include "fileutils.h"
+#include "nls.h"
+#include "strutils.h"
+#include "xalloc.h"
+#include "proc/cgroup.h"
+
+static const char *top_cgroup = CGROUP_ROOT;
+static int max_depth = -1;
+static int one_header;
+static unsigned sleep_time = 1;
+static int infinite_updates;
+static unsigned long num_updates = 1;
+
+static void __attribute__ ((__noreturn__))
+    usage(FILE * out)
+{
+	fputs(USAGE_HEADER, out);
+	fprintf(out,
+	      _(" %s [options] [delay [count]]\n"),
+		program_invocation_short_name);
+	fputs(USAGE_OPTIONS, out);
+	fputs(_(" -c, --cgroup <path>    report on the subtree at path\n"), out);
+	fputs(_(" -l, --levels <num>     descend at most num levels\n"), out);
+	fputs(_(" -n, --one-header       do not redisplay header\n"), out);
+	fputs(USAGE_SEPARATOR, out);
+	fputs(USAGE_HELP, out);
+	fputs(USAGE_VERSION, out);
+	fprintf(out, USAGE_MAN_TAIL("cgstat(1)"));
+
+	exit(out == stderr ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+static void header(void)
+{
+	printf(_("%6s %6s %6s %6s %6s %10s %9s %8s %8s %9s %9s %6s %6s %6s %s\n"),
+	       "cpu%", "usr%", "sys%", "thr%", "tasks", "mem", "swap",
+	       "minflt", "majflt", "read", "write",
+	       "cpu-p", "mem-p", "io-p", "cgroup");
+}
+
+/* a counter's change over the interval as a percentage of that interval */
+static double pct(unsigned long long usecs, double elapsed)
+{
+	return elapsed > 0 ? usecs / elapsed / 1e4 : 0;
+}
+
+static double rate(unsigned long long count, double elapsed)
+{
+	return elapsed > 0 ? count / elapsed : 0;
+}
+
+static void report(struct cgroup_info *list, double elapsed)
+{
+	struct cgroup_stat d;
+
+	if (!one_header)
+		header();
+	for (; list; list = list->next) {
+		cgroup_delta(list, &d);
+		printf("%6.1f %6.1f %6.1f %6.1f %6llu %10llu %9llu %8.0f %8.0f %9.0f %9.0f %6.1f %6.1f %6.1f %s\n",
+		       pct(d.cpu_usage, elapsed),
+		       pct(d.cpu_user, elapsed),
+		       pct(d.cpu_system, elapsed),
+		       pct(d.cpu_throttled, elapsed),
+		       d.nr_tasks,
+		       d.mem_current >> 10,
+		       d.swap_current >> 10,
+		       rate(d.pgfault - d.pgmajfault, elapsed),
+		       rate(d.pgmajfault, elapsed),
+		       rate(d.io_rbytes >> 10, elapsed),
+		       rate(d.io_wbytes >> 10, elapsed),
+		       pct(d.cpu_some, elapsed),
+		       pct(d.mem_some, elapsed),
+		       pct(d.io_some, elapsed),
+		       list->name);
+	}
+}
+
+static double now_secs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+	struct cgroup_info *list = NULL;
+	double then, now;
+	unsigned long i;
+	long tmp;
+	int c;
+
+	static const struct option longopts[] = {
+		{"cgroup", required_argument, NULL, 'c'},
+		{"levels", required_argument, NULL, 'l'},
+		{"one-header", no_argument, NULL, 'n'},
+		{"help", no_argument, NULL, 'h'},
+		{"version", no_argument, NULL, 'V'},
+		{NULL, 0, NULL, 0}
+	};
+
+#ifdef HAVE_PROGRAM_INVOCATION_NAME
+	program_invocation_name = program_invocation_short_name;
+#endif
+	setlocale (LC_ALL, "");
+	bindtextdomain(PACKAGE, LOCALEDIR);
+	textdomain(PACKAGE);
+	atexit(close_stdout);
+
+	while ((c = getopt_long(argc, argv, "c:l:nhV", longopts, NULL)) != EOF)
+		switch (c) {
+		case 'V':
+			printf(PROCPS_NG_VERSION);
+			return EXIT_SUCCESS;
+		case 'h':
+			usage(stdout);
+		case 'c':
+			top_cgroup = optarg;
+			break;
+		case 'l':
+			max_depth = strtol_or_err(optarg, _("failed to parse argument"));
+			if (max_depth < 0)
+				xerrx(EXIT_FAILURE, _("levels must not be negative"));
+			break;
+		case 'n':
+			one_header = 1;
+			break;
+		default:
+			usage(stderr);
+		}
+
+	if (optind < argc) {
+		tmp = strtol_or_err(argv[optind++], _("failed to parse argument"));
+		if (tmp < 1)
+			xerrx(EXIT_FAILURE, _("delay must be positive integer"));
+		else if (UINT_MAX < tmp)
+			xerrx(EXIT_FAILURE, _("too large delay value"));
+		sleep_time = tmp;
+		infinite_updates = 1;
+	}
+	if (optind < argc) {
+		num_updates = strtol_or_err(argv[optind++], _("failed to parse argument"));
+		infinite_updates = 0;
+	}
+	if (optind < argc)
+		usage(stderr);
+
+	/* a relative path names a cgroup below the usual mount point */
+	if (*top_cgroup != '/') {
+		char *path = xmalloc(strlen(CGROUP_ROOT) + strlen(top_cgroup) + 2);
+		sprintf(path, "%s/%s", CGROUP_ROOT, top_cgroup);
+		top_cgroup = path;
+	}
+
+	setlinebuf(stdout);
+	if (get_cgroupinfo(&list, top_cgroup, max_depth) < 0)
+		xerr(EXIT_FAILURE, _("cannot open %s"), top_cgroup);
+	then = now_secs();
+	if (one_header)
+		header();
+	for (i = 0; infinite_updates || i < num_updates; i++) {
+		sleep(sleep_time);
+		if (get_cgroupinfo(&list, top_cgroup, max_depth) < 0)
+			xerr(EXIT_FAILURE, _("cannot open %s"), top_cgroup);
+		now = now_secs();
+		report(list, now - then);
+		then = now;
+	}
+	free_cgroupinfo(list);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "proc/sysinfo.h"
+
+struct cpustat_tests {
+    char *line;
+    int result;
+    int id;
+    jiff tics[8];
+    char *rest;
+};
+
+struct cpustat_tests tests[] = {
+    {"cpu  10 20 30 40 50 60 70 80 90 100\nintr 1\n",
+                                8, -1, {10, 20, 30, 40, 50, 60, 70, 80}, "intr 1\n"},
+    {"cpu12 1 2 3 4\ncpu13 5\n",
+                                4, 12, {1, 2, 3, 4},                     "cpu13 5\n"},
+    {"cpu0 18446744073709551615 0 0 0 0 0 0 0\n",
+                                8, 0,  {18446744073709551615ULL},        ""},
+    {"cpu3 5 6",                2, 3,  {5, 6},                           ""},
+    {"intr 1 2 3\n",           -1, 0,  {0},                              "intr 1 2 3\n"},
+    {"cpux 1\n",               -1, 0,  {0},                              "cpux 1\n"},
+    {"cpu",                    -1, 0,  {0},                              "cpu"},
+    {"",                       -1, 0,  {0},                              ""},
+    {NULL, 0, 0, {0}, NULL}
+};
+
+int main(int argc, char *argv[])
+{
+    const char *bp;
+    jiff tics[8];
+    int i, n, id;
+
+    for (i = 0; tests[i].line != NULL; i++) {
+        bp = tests[i].line;
+        id = 0;
+        memset(tics, 0, sizeof(tics));
+        n = stat_cpu_line(&bp, &id, tics);
+        if (n != tests[i].result || strcmp(bp, tests[i].rest)
+        || (n >= 0 && (id != tests[i].id || memcmp(tics, tests[i].tics, sizeof(tics))))) {
+            fprintf(stderr, "FAIL: stat_cpu_line(\"%s\") gave %d (cpu %d), expected %d (cpu %d)\n",
+                    tests[i].line, n, id, tests[i].result, tests[i].id);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
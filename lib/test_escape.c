@@ -0,0 +1,195 @@
+/*
+ * test_escape -- check escape_str() against the original byte-wise code
+ *
+ * With no arguments random strings are run through both the library
+ * escape_str() and a private copy of the original implementation, once
+ * in the C locale and once in a UTF-8 locale, and any difference fails.
+ * The sources start at every alignment and run to every length, so runs
+ * of ascii begin and end on both sides of each 16 byte block.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#include <ctype.h>
+#include <langinfo.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <sys/wait.h>
+#include "proc/escape.h"
+
+#define FUZZ_ROUNDS 50000
+
+/* the escape_str() of old, kept verbatim as the reference */
+static int ref_escape_str_utf8(char *dst, const char *src, int bufsize, int *maxcells){
+  int my_cells = 0;
+  int my_bytes = 0;
+  mbstate_t s;
+
+  memset(&s, 0, sizeof (s));
+  for(;;) {
+    wchar_t wc;
+    int len = 0;
+
+    if(my_cells >= *maxcells || my_bytes+1 >= bufsize)
+      break;
+    if (!(len = mbrtowc (&wc, src, MB_CUR_MAX, &s)))
+      break;
+    if (len < 0) {
+      memset (&s, 0, sizeof (s));
+      *(dst++) = '?';
+      src++;
+      my_cells++;
+      my_bytes++;
+    } else if (len==1) {
+      *(dst++) = isprint(*src) ? *src : '?';
+      src++;
+      my_cells++;
+      my_bytes++;
+    } else if (!iswprint(wc)) {
+      *(dst++) = '?';
+      src+=len;
+      my_cells++;
+      my_bytes++;
+    } else {
+      int wlen = wcwidth(wc);
+
+      if (wlen==0) {
+        *(dst++) = '?';
+        src+=len;
+        my_cells++;
+        my_bytes++;
+      } else {
+        if (my_cells+wlen > *maxcells || my_bytes+1+len >= bufsize) break;
+        if (memchr(src, 0x9B, len)) {
+          *(dst++) = '?';
+          src+=len;
+          my_cells++;
+          my_bytes++;
+        } else {
+          memcpy(dst, src, len);
+          my_cells += wlen;
+          dst += len;
+          my_bytes += len;
+          src += len;
+        }
+      }
+    }
+  }
+  *dst = '\0';
+  *maxcells -= my_cells;
+  return my_bytes;
+}
+
+static int ref_escape_str(char *dst, const char *src, int bufsize, int *maxcells){
+  unsigned char c;
+  int my_cells = 0;
+  int my_bytes = 0;
+  const char codes[] =
+  "Z..............................."
+  "||||||||||||||||||||||||||||||||"
+  "||||||||||||||||||||||||||||||||"
+  "|||||||||||||||||||||||||||||||."
+  "????????????????????????????????"
+  "????????????????????????????????"
+  "????????????????????????????????"
+  "????????????????????????????????";
+  static int utf_init=0;
+
+  if(utf_init==0){
+     char *enc = nl_langinfo(CODESET);
+     utf_init = enc && strcasecmp(enc, "UTF-8")==0 ? 1 : -1;
+  }
+  if (utf_init==1 && MB_CUR_MAX>1)
+     return ref_escape_str_utf8(dst, src, bufsize, maxcells);
+
+  if(bufsize > *maxcells+1) bufsize=*maxcells+1;
+  for(;;){
+    if(my_cells >= *maxcells || my_bytes+1 >= bufsize)
+      break;
+    c = (unsigned char) *(src++);
+    if(!c) break;
+    if(codes[c]!='|') c=codes[c];
+    my_cells++;
+    my_bytes++;
+    *(dst++) = c;
+  }
+  *dst = '\0';
+  *maxcells -= my_cells;
+  return my_bytes;
+}
+
+/* mostly printable ascii, with the odd control, high or utf-8 byte run */
+static void random_string(char *buf, int len)
+{
+    static const char *const odd[] = {
+        "\t", "\x7f", "\x9b", "\xff", "\xc3\xa9", "\xe2\x82\xac",
+        "\xf0\x9f\x98\x80", "\xcc\x81", "\xe3\x81\x82", "\xc3", "\xe2\x82"
+    };
+    int i = 0;
+
+    while (i < len) {
+        if (rand() % 24) {
+            buf[i++] = 0x20 + rand() % 0x5f;
+        } else {
+            const char *o = odd[rand() % (sizeof(odd) / sizeof(odd[0]))];
+            while (*o && i < len)
+                buf[i++] = *o++;
+        }
+    }
+    buf[i] = '\0';
+}
+
+static int fuzz(const char *locale)
+{
+    char src[512], want[600], got[600];
+    int i;
+
+    if (!setlocale(LC_ALL, locale)) {
+        fprintf(stderr, "SKIP: locale %s not available\n", locale);
+        return EXIT_SUCCESS;
+    }
+    srand(1);
+    for (i = 0; i < FUZZ_ROUNDS; i++) {
+        int bufsize = 1 + rand() % 300;
+        int cells = rand() % 300;
+        int wcells = cells, gcells = cells;
+        int wn, gn;
+
+        // leave the source unaligned so the vector path's head is exercised
+        random_string(src + (i & 15), rand() % 400);
+        wn = ref_escape_str(want, src + (i & 15), bufsize, &wcells);
+        gn = escape_str(got, src + (i & 15), bufsize, &gcells);
+        if (wn != gn || wcells != gcells || memcmp(want, got, wn + 1)) {
+            fprintf(stderr, "FAIL: %s: escape_str(\"%s\", %d, %d) gave %d/%d \"%s\", expected %d/%d \"%s\"\n",
+                    locale, src + (i & 15), bufsize, cells, gn, gcells, got, wn, wcells, want);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    pid_t child;
+    int status;
+
+    // escape_str() settles on a locale once per process, so fork for each
+    if ((child = fork()) == 0)
+        return fuzz("C");
+    if (child < 0 || waitpid(child, &status, 0) < 0
+    || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+    return fuzz("C.UTF-8");
+}
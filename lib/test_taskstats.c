@@ -0,0 +1,55 @@
+/*
+ * test_taskstats -- check get_delayacct() against a task of our own
+ *
+ * Needs CAP_NET_ADMIN, so without it (or without a taskstats family in
+ * the kernel) the test is skipped rather than failed.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "proc/readproc.h"
+#include "proc/taskstats.h"
+
+#define SKIP 77        /* automake's exit status for a skipped test */
+
+int main(int argc, char *argv[])
+{
+    proc_t task[3], *tasks[3];
+    int i, n;
+
+    // ourselves, something that can't exist and ourselves again, so a
+    // missing task in the middle of a batch is exercised too
+    memset(task, 0, sizeof(task));
+    task[0].tid = task[0].tgid = task[2].tid = task[2].tgid = getpid();
+    task[1].tid = task[1].tgid = 0x7ffffffe;
+    for (i = 0; i < 3; i++) {
+        task[i].delay_cpu = 42;
+        tasks[i] = &task[i];
+    }
+
+    n = get_delayacct(tasks, 3, 0);
+    if (n < 0) {
+        if (task[0].delay_cpu) {
+            fprintf(stderr, "FAIL: delays left set after failure\n");
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "SKIP: taskstats unavailable (not root?)\n");
+        return SKIP;
+    }
+    if (n != 2 || task[1].delay_cpu) {
+        fprintf(stderr, "FAIL: filled %d, expected 2 (the missing task has %llu)\n", n, task[1].delay_cpu);
+        return EXIT_FAILURE;
+    }
+    // the threads variant, for the one thread we have
+    if (get_delayacct(tasks, 1, 1) != 1) {
+        fprintf(stderr, "FAIL: lookup by tid\n");
+        return EXIT_FAILURE;
+    }
+    // and a frame with no tasks at all
+    if (get_delayacct(tasks, 0, 0) != 0) {
+        fprintf(stderr, "FAIL: no tasks\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -90,6 +90,7 @@ static struct el *opt_ruid = NULL;
 static struct el *opt_nslist = NULL;
 static char *opt_pattern = NULL;
 static char *opt_pidfile = NULL;
+static char **opt_cgroup = NULL;
 
 /* by default, all namespaces will be checked */
 static int ns_flags = 0x3f;
@@ -128,6 +129,7 @@ static int __attribute__ ((__noreturn__)) usage(int opt)
 	fputs(_(" -x, --exact               match exactly with the command name\n"), fp);
 	fputs(_(" -F, --pidfile <file>      read PIDs from file\n"), fp);
 	fputs(_(" -L, --logpidfile          fail if PID file is not locked\n"), fp);
+	fputs(_(" --cgroup <path>           match only processes in a cgroup v2 subtree\n"), fp);
 	fputs(_(" --ns <PID>                match the processes that belong to the same\n"
 		"                           namespace as <pid>\n"), fp);
 	fputs(_(" --nslist <ns,...>         list which namespaces will be considered for\n"
@@ -434,7 +436,10 @@ static PROCTAB *do_openproc (void)
 		flags |= PROC_FILLSTATUS;  /* FIXME: need one, and PROC_FILLANY broken */
 	if (opt_ns_pid)
 		flags |= PROC_FILLNS;
-	if (opt_euid && !opt_negate) {
+	if (opt_cgroup) {
+		flags |= PROC_CGROUP | PROC_CGRPTREE;
+		ptp = openproc (flags, opt_cgroup);
+	} else if (opt_euid && !opt_negate) {
 		int num = opt_euid[0].num;
 		int i = num;
 		uid_t *uids = xmalloc (num * sizeof (uid_t));
@@ -687,6 +692,7 @@ static void parse_opts (int argc, char **argv)
 		SIGNAL_OPTION = CHAR_MAX + 1,
 		NS_OPTION,
 		NSLIST_OPTION,
+		CGROUP_OPTION,
 	};
 	static const struct option longopts[] = {
 		{"signal", required_argument, NULL, SIGNAL_OPTION},
@@ -713,6 +719,7 @@ static void parse_opts (int argc, char **argv)
 		{"echo", no_argument, NULL, 'e'},
 		{"ns", required_argument, NULL, NS_OPTION},
 		{"nslist", required_argument, NULL, NSLIST_OPTION},
+		{"cgroup", required_argument, NULL, CGROUP_OPTION},
 		{"help", no_argument, NULL, 'h'},
 		{"version", no_argument, NULL, 'V'},
 		{NULL, 0, NULL, 0}
@@ -870,6 +877,24 @@ static void parse_opts (int argc, char **argv)
 			if (opt_nslist == NULL)
 				usage ('?');
 			break;
+		case CGROUP_OPTION:
+		{
+			int n = 0, rc;
+			if ((rc = check_cgroup (optarg)) == EXDEV)
+				xerrx(EXIT_USAGE, _("cgroup '%s' is not within /sys/fs/cgroup"), optarg);
+			else if (rc) {
+				errno = rc;
+				xerr(EXIT_USAGE, _("bad cgroup '%s'"), optarg);
+			}
+			if (opt_cgroup)
+				while (opt_cgroup[n])
+					n++;
+			opt_cgroup = xrealloc (opt_cgroup, (n + 2) * sizeof (char *));
+			opt_cgroup[n] = optarg;
+			opt_cgroup[n + 1] = NULL;
+			++criteria_count;
+			break;
+		}
 		case 'h':
 		case '?':
 			usage (opt);
@@ -0,0 +1,290 @@
+/*
+ * cgroup.c - cgroup v2 resource statistics for libproc
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+
+#include "cgroup.h"
+#include "procps.h"
+#include "alloc.h"
+
+/* memory.stat is the largest of the files we read, at about 1.5k */
+static char buf[16384];
+
+typedef struct cg_key {
+	const char *name;
+	unsigned len;
+	size_t offset;
+} cg_key;
+
+#define CG_KEY(n, m) { n, sizeof(n) - 1, offsetof(struct cgroup_stat, m) }
+#define CG_VAL(st, key) (*(unsigned long long *)((char *)(st) + (key)->offset))
+
+static const cg_key cpu_keys[] = {
+	CG_KEY("usage_usec",     cpu_usage),
+	CG_KEY("user_usec",      cpu_user),
+	CG_KEY("system_usec",    cpu_system),
+	CG_KEY("nr_throttled",   cpu_nr_throttled),
+	CG_KEY("throttled_usec", cpu_throttled),
+};
+
+/* in the order the kernel emits them */
+static const cg_key mem_keys[] = {
+	CG_KEY("anon",           mem_anon),
+	CG_KEY("file",           mem_file),
+	CG_KEY("kernel_stack",   mem_kernel_stack),
+	CG_KEY("sock",           mem_sock),
+	CG_KEY("shmem",          mem_shmem),
+	CG_KEY("slab",           mem_slab),
+	CG_KEY("pgfault",        pgfault),
+	CG_KEY("pgmajfault",     pgmajfault),
+};
+
+static const cg_key io_keys[] = {
+	CG_KEY("rbytes",         io_rbytes),
+	CG_KEY("wbytes",         io_wbytes),
+	CG_KEY("rios",           io_rios),
+	CG_KEY("wios",           io_wios),
+};
+
+/* read a cgroup interface file into buf, returning 0 if it isn't there */
+static int read_at(int dfd, const char *file)
+{
+	int fd, n;
+
+	if ((fd = openat(dfd, file, O_RDONLY)) == -1)
+		return 0;
+	n = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (n < 0)
+		n = 0;
+	buf[n] = '\0';
+	return n;
+}
+
+/*
+ * parse "key value" lines -- since the kernel always emits the keys in the
+ * same order, the key following the last one matched is tried first, so a
+ * line normally costs a single string compare
+ */
+static void parse_keyed(const cg_key *keys, int nkeys, char sep, struct cgroup_stat *st, int sum)
+{
+	char *p = buf, *end;
+	int k = 0, i;
+
+	while (*p) {
+		while (*p == ' ' || *p == '\n')
+			p++;
+		for (i = 0; i < nkeys; i++) {
+			const cg_key *key = &keys[(k + i) % nkeys];
+			if (!strncmp(p, key->name, key->len) && p[key->len] == sep) {
+				unsigned long long v = strtoull(p + key->len + 1, &end, 10);
+				if (sum) CG_VAL(st, key) += v;
+				else CG_VAL(st, key) = v;
+				k = (k + i + 1) % nkeys;
+				p = end;
+				break;
+			}
+		}
+		if (i == nkeys)
+			p += strcspn(p, sep == ' ' ? "\n" : " \n");
+	}
+}
+
+/* "some avg10=0.00 avg60=0.00 avg300=0.00 total=0" plus a "full ..." line */
+static void parse_pressure(unsigned long long *some, unsigned long long *full)
+{
+	char *p = buf, *total;
+
+	for (; p; p = strchr(p, '\n')) {
+		while (*p == '\n')
+			p++;
+		if (!(total = strstr(p, "total=")))
+			break;
+		if (!strncmp(p, "some", 4))
+			*some = strtoull(total + 6, &p, 10);
+		else
+			*full = strtoull(total + 6, &p, 10);
+	}
+}
+
+static unsigned long long read_number(int dfd, const char *file)
+{
+	if (!read_at(dfd, file))
+		return 0;
+	return strtoull(buf, NULL, 10);
+}
+
+static void sample_cgroup(int dfd, struct cgroup_stat *st)
+{
+	memset(st, 0, sizeof(*st));
+	if (read_at(dfd, "cpu.stat"))
+		parse_keyed(cpu_keys, sizeof(cpu_keys) / sizeof(cg_key), ' ', st, 0);
+	st->mem_current = read_number(dfd, "memory.current");
+	st->swap_current = read_number(dfd, "memory.swap.current");
+	if (read_at(dfd, "memory.stat"))
+		parse_keyed(mem_keys, sizeof(mem_keys) / sizeof(cg_key), ' ', st, 0);
+	if (read_at(dfd, "io.stat"))
+		parse_keyed(io_keys, sizeof(io_keys) / sizeof(cg_key), '=', st, 1);
+	st->nr_tasks = read_number(dfd, "pids.current");
+	if (read_at(dfd, "cpu.pressure"))
+		parse_pressure(&st->cpu_some, &st->cpu_full);
+	if (read_at(dfd, "memory.pressure"))
+		parse_pressure(&st->mem_some, &st->mem_full);
+	if (read_at(dfd, "io.pressure"))
+		parse_pressure(&st->io_some, &st->io_full);
+}
+
+struct cg_walk {
+	struct cgroup_info *old;        /* entries from the last sample not yet reclaimed */
+	struct cgroup_info **tail;      /* where the next entry of the new list goes */
+	int maxdepth;
+	int count;
+};
+
+/* find (and unlink) the entry for 'name' from the previous sample -- as the
+ * tree usually comes back in the same order, it's almost always the first */
+static struct cgroup_info *reclaim(struct cg_walk *w, const char *name)
+{
+	struct cgroup_info **pp, *cg;
+
+	for (pp = &w->old; (cg = *pp); pp = &cg->next) {
+		if (!strcmp(cg->name, name)) {
+			*pp = cg->next;
+			return cg;
+		}
+	}
+	return NULL;
+}
+
+static void walk_cgroup(struct cg_walk *w, int dfd, const char *name, int depth)
+{
+	struct cgroup_info *cg;
+	struct dirent *ent;
+	char path[PATH_MAX];
+	DIR *dir;
+	int fd;
+
+	if ((cg = reclaim(w, name))) {
+		cg->prev = cg->now;
+		sample_cgroup(dfd, &cg->now);
+		cg->seen++;
+	} else {
+		cg = xcalloc(sizeof(*cg));
+		cg->name = xstrdup(name);
+		cg->depth = depth;
+		sample_cgroup(dfd, &cg->now);
+		cg->prev = cg->now;
+		cg->seen = 1;
+	}
+	cg->next = NULL;
+	*w->tail = cg;
+	w->tail = &cg->next;
+	w->count++;
+
+	if (w->maxdepth >= 0 && depth >= w->maxdepth)
+		return;
+	if ((fd = dup(dfd)) == -1)
+		return;
+	if (!(dir = fdopendir(fd))) {
+		close(fd);
+		return;
+	}
+	while ((ent = readdir(dir))) {
+		if (ent->d_type != DT_DIR || ent->d_name[0] == '.')
+			continue;
+		if ((fd = openat(dfd, ent->d_name, O_RDONLY | O_DIRECTORY)) == -1)
+			continue;
+		snprintf(path, sizeof(path), "%s%s%s", name, depth ? "/" : "", ent->d_name);
+		walk_cgroup(w, fd, path, depth + 1);
+		close(fd);
+	}
+	closedir(dir);
+}
+
+/*
+ * get_cgroupinfo - sample every cgroup in a subtree
+ *
+ * The passed list (initially NULL) is rebuilt in depth first order.  Entries
+ * for cgroups seen last time are reused, keeping their previous sample, and
+ * those for cgroups which have since gone away are freed.  Returns the number
+ * of cgroups in the list, or -1 if 'top' could not be opened.
+ */
+int get_cgroupinfo(struct cgroup_info **list, const char *top, int maxdepth)
+{
+	struct cg_walk w;
+	int dfd;
+
+	if ((dfd = open(top ? top : CGROUP_ROOT, O_RDONLY | O_DIRECTORY)) == -1)
+		return -1;
+	w.old = *list;
+	w.tail = list;
+	w.maxdepth = maxdepth;
+	w.count = 0;
+	*list = NULL;
+	walk_cgroup(&w, dfd, "/", 0);
+	close(dfd);
+	free_cgroupinfo(w.old);
+	return w.count;
+}
+
+void free_cgroupinfo(struct cgroup_info *list)
+{
+	struct cgroup_info *next;
+
+	for (; list; list = next) {
+		next = list->next;
+		free(list->name);
+		free(list);
+	}
+}
+
+#define DELTA(f) delta->f = cg->now.f - prev->f
+
+void cgroup_delta(const struct cgroup_info *cg, struct cgroup_stat *delta)
+{
+	const struct cgroup_stat *prev = &cg->prev;
+
+	/* a counter can only go backwards if the cgroup was replaced */
+	if (cg->now.cpu_usage < prev->cpu_usage)
+		prev = &cg->now;
+	*delta = cg->now;
+	DELTA(cpu_usage);
+	DELTA(cpu_user);
+	DELTA(cpu_system);
+	DELTA(cpu_nr_throttled);
+	DELTA(cpu_throttled);
+	DELTA(pgfault);
+	DELTA(pgmajfault);
+	DELTA(io_rbytes);
+	DELTA(io_wbytes);
+	DELTA(io_rios);
+	DELTA(io_wios);
+	DELTA(cpu_some);
+	DELTA(cpu_full);
+	DELTA(mem_some);
+	DELTA(mem_full);
+	DELTA(io_some);
+	DELTA(io_full);
+}
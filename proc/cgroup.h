@@ -0,0 +1,63 @@
+#ifndef PROC_CGROUP_H
+#define PROC_CGROUP_H
+
+#include "procps.h"
+
+EXTERN_C_BEGIN
+
+#define CGROUP_ROOT "/sys/fs/cgroup"
+
+/* raw counters for one cgroup, straight from its cgroup v2 interface files */
+struct cgroup_stat {
+	/* cpu.stat (microseconds, except nr_throttled) */
+	unsigned long long cpu_usage;
+	unsigned long long cpu_user;
+	unsigned long long cpu_system;
+	unsigned long long cpu_nr_throttled;
+	unsigned long long cpu_throttled;
+	/* memory.current and memory.swap.current (bytes) */
+	unsigned long long mem_current;
+	unsigned long long swap_current;
+	/* memory.stat (bytes, except the fault counts) */
+	unsigned long long mem_anon;
+	unsigned long long mem_file;
+	unsigned long long mem_kernel_stack;
+	unsigned long long mem_shmem;
+	unsigned long long mem_slab;
+	unsigned long long mem_sock;
+	unsigned long long pgfault;
+	unsigned long long pgmajfault;
+	/* io.stat, summed over all devices */
+	unsigned long long io_rbytes;
+	unsigned long long io_wbytes;
+	unsigned long long io_rios;
+	unsigned long long io_wios;
+	/* the total= of cpu.pressure, memory.pressure and io.pressure (microseconds) */
+	unsigned long long cpu_some;
+	unsigned long long cpu_full;
+	unsigned long long mem_some;
+	unsigned long long mem_full;
+	unsigned long long io_some;
+	unsigned long long io_full;
+	/* pids.current */
+	unsigned long long nr_tasks;
+};
+
+struct cgroup_info {
+	char *name;                     /* path below the scanned top, "/" for the top itself */
+	struct cgroup_info *next;       /* depth first, parents ahead of children */
+	int depth;                      /* 0 for the top */
+	int seen;                       /* number of samples taken, 1 when new */
+	struct cgroup_stat now;         /* the latest sample */
+	struct cgroup_stat prev;        /* the sample before that (== now when new) */
+};
+
+/* (re)sample every cgroup in the tree below 'top' (NULL for CGROUP_ROOT) to at
+ * most 'maxdepth' levels (-1 for all), reusing and updating the passed list */
+extern int get_cgroupinfo(struct cgroup_info **list, const char *top, int maxdepth);
+extern void free_cgroupinfo(struct cgroup_info *list);
+/* counters as the change since the previous sample, gauges as is */
+extern void cgroup_delta(const struct cgroup_info *cg, struct cgroup_stat *delta);
+
+EXTERN_C_END
+#endif /* PROC_CGROUP_H */
@@ -20,6 +20,9 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <string.h>
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
 #include "procps.h"
 #include "escape.h"
 #include "readproc.h"
@@ -32,6 +35,34 @@
 # include <langinfo.h>
 #endif
 
+/* return the length of the leading run of printable ascii (0x20 - 0x7e)
+ * in 'src', looking at no more than 'max' bytes -- such bytes need neither
+ * translation nor multibyte handling and can be copied as a block */
+static inline int ascii_prefix(const char *restrict src, int max){
+  const unsigned char *p = (const unsigned char *)src;
+  int n = 0;
+
+#if defined(__SSE2__)
+  const __m128i lo = _mm_set1_epi8(0x20), hi = _mm_set1_epi8(0x7e);
+
+  // get aligned so a load can never cross into an unmapped page
+  while (n < max && ((unsigned long)(p + n) & 15)) {
+    if (p[n] < 0x20 || p[n] > 0x7e) return n;
+    n++;
+  }
+  while (n + 16 <= max) {
+    __m128i v = _mm_load_si128((const __m128i *)(p + n));
+    // as signed bytes, anything with the high bit set is less than 0x20
+    int m = _mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi8(v, lo), _mm_cmpgt_epi8(v, hi)));
+    if (m) return n + __builtin_ctz(m);
+    n += 16;
+  }
+#endif
+  while (n < max && p[n] >= 0x20 && p[n] <= 0x7e)
+    n++;
+  return n;
+}
+
 #if (__GNU_LIBRARY__ >= 6) && (!defined(__UCLIBC__) || defined(__UCLIBC_HAS_WCHAR__))
 static int escape_str_utf8(char *restrict dst, const char *restrict src, int bufsize, int *maxcells){
   int my_cells = 0;
@@ -40,6 +71,13 @@ static int escape_str_utf8(char *restrict dst, const char *restrict src, int buf
 
   memset(&s, 0, sizeof (s));
 
+  // the usual case: a clean ascii string needs no mbrtowc/wcwidth at all
+  my_bytes = ascii_prefix(src, *maxcells < bufsize-1 ? *maxcells : bufsize-1);
+  memcpy(dst, src, my_bytes);
+  my_cells = my_bytes;
+  dst += my_bytes;
+  src += my_bytes;
+
   for(;;) {
     wchar_t wc;
     int len = 0;
@@ -148,6 +186,13 @@ int escape_str(char *restrict dst, const char *restrict src, int bufsize, int *m
 
   if(bufsize > *maxcells+1) bufsize=*maxcells+1; // FIXME: assumes 8-bit locale
 
+  // printable ascii translates to itself, so copy any such run wholesale
+  my_bytes = ascii_prefix(src, bufsize-1);
+  memcpy(dst, src, my_bytes);
+  my_cells = my_bytes;
+  dst += my_bytes;
+  src += my_bytes;
+
   for(;;){
     if(my_cells >= *maxcells || my_bytes+1 >= bufsize)
       break;
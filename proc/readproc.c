@@ -25,6 +25,7 @@
 #include "escape.h"
 #include "pwcache.h"
 #include "devname.h"
+#include "taskstats.h"
 #include "procps.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -35,6 +36,7 @@
 #include <signal.h>
 #include <fcntl.h>
 #include <dirent.h>
+#include <limits.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #ifdef WITH_SYSTEMD
@@ -82,7 +84,7 @@ static unsigned long long unhex(const char *restrict cp){
 }
 #endif
 
-static int task_dir_missing;
+static __thread int task_dir_missing;   // per thread, as is openproc's stat of it
 
 // free any additional dynamically acquired storage associated with a proc_t
 // ( and if it's to be reused, refresh it otherwise destroy it )
@@ -103,6 +105,7 @@ static inline void free_acquired (proc_t *p, int reuse) {
         if (p->sd_slice) free(p->sd_slice);
         if (p->sd_unit)  free(p->sd_unit);
         if (p->sd_uunit) free(p->sd_uunit);
+        if (p->numa_nodes) free(p->numa_nodes);
 #ifdef QUICK_THREADS
     }
 #endif
@@ -477,6 +480,66 @@ static void oomadj2proc(const char* S, proc_t *restrict P)
 }
 ///////////////////////////////////////////////////////////////////////
 
+// Each numa_maps line is a mapping, whose resident pages on each node appear
+// as "N<node>=<pages>" and whose page size, which a line's counts are all in,
+// comes later as "kernelpagesize_kB=<kb>".  Those pages are summed by node,
+// as kb, with the node holding the most and the totals by node then noted.
+static void numamaps2proc(const char *S, proc_t *restrict P)
+{
+    static __thread unsigned long *kb, *pg;     // by node, all & one mapping
+    static __thread int max;                    // nodes those can hold
+    const char *nl, *s;
+    char *end, *str;
+    unsigned long psz, pages;
+    int node, lo, hi, top = -1, used = 0;
+
+    if (max) memset(kb, 0, sizeof(*kb) * max);
+    for (; *S; S = nl ? nl + 1 : S + strlen(S)) {
+        nl = strchr(S, '\n');
+        psz = getpagesize() >> 10;
+        lo = INT_MAX, hi = -1;
+        for (s = strchr(S, ' '); s && (!nl || s < nl); s = strchr(s + 1, ' ')) {
+            if (s[1] == 'N' && s[2] >= '0' && s[2] <= '9') {
+                node = strtol(s + 2, &end, 10);
+                if (*end != '=' || node > 0xffff)
+                    continue;
+                pages = strtoul(end + 1, NULL, 10);
+                if (node >= max) {
+                    int was = max;
+                    max = node + 8;
+                    kb = xrealloc(kb, sizeof(*kb) * max);
+                    pg = xrealloc(pg, sizeof(*pg) * max);
+                    memset(kb + was, 0, sizeof(*kb) * (max - was));
+                    memset(pg + was, 0, sizeof(*pg) * (max - was));
+                }
+                pg[node] += pages;
+                if (node < lo) lo = node;
+                if (node > hi) hi = node;
+            } else if (s[1] == 'k' && !strncmp(s + 1, "kernelpagesize_kB=", 18))
+                psz = strtoul(s + 19, NULL, 10);
+        }
+        for (node = lo; node <= hi; node++) {
+            kb[node] += pg[node] * psz;
+            pg[node] = 0;
+        }
+    }
+    P->numa_kb = 0;
+    for (node = 0; node < max; node++) {
+        if (!kb[node]) continue;
+        if (top < 0 || kb[node] > kb[top]) top = node;
+        P->numa_kb += kb[node];
+        used++;
+    }
+    P->numa_pref = top;
+    // as "node:kb", for those nodes used, 5 + 20 + 1 bytes apiece at most
+    P->numa_nodes = str = xmalloc(used * 26 + 1);
+    *str = '\0';
+    for (node = 0; node < max; node++)
+        if (kb[node])
+            str += sprintf(str, "%s%d:%lu", str == P->numa_nodes ? "" : " ", node, kb[node]);
+}
+///////////////////////////////////////////////////////////////////////
+
 static const char *ns_names[] = {
     [IPCNS] = "ipc",
     [MNTNS] = "mnt",
@@ -913,8 +976,8 @@ static const char *lxc_containers (const char *path) {
 // The pid (tgid? tid?) is already in p, and a path to it in path, with some
 // room to spare.
 static proc_t* simple_readproc(PROCTAB *restrict const PT, proc_t *restrict const p) {
-    static struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status
-    static struct stat sb;     // stat() buffer
+    static __thread struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status
+    static __thread struct stat sb;     // stat() buffer
     char *restrict const path = PT->path;
     unsigned flags = PT->flags;
 
@@ -1008,6 +1071,17 @@ static proc_t* simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
     if (unlikely(flags & PROC_FILL_LXC))        // value the lxc name
         p->lxcname = lxc_containers(path);
 
+    if (unlikely(flags & PROC_FILLNUMA)) {      // read /proc/#/numa_maps
+        p->numa_pref = -1;
+        if (likely(file2str(path, "numa_maps", &ub) != -1))
+            numamaps2proc(ub.buf, p);
+    }
+
+    if (unlikely(flags & PROC_FILLDELAY)) {     // ask taskstats, one at a time
+        proc_t *one = p;
+        get_delayacct(&one, 1, 0);
+    }
+
     return p;
 next_proc:
     return NULL;
@@ -1023,8 +1097,8 @@ next_proc:
 // t is the POSIX thread (task group member, generally not the leader)
 // path is a path to the task, with some room to spare.
 static proc_t* simple_readtask(PROCTAB *restrict const PT, const proc_t *restrict const p, proc_t *restrict const t, char *restrict const path) {
-    static struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status
-    static struct stat sb;     // stat() buffer
+    static __thread struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status
+    static __thread struct stat sb;     // stat() buffer
     unsigned flags = PT->flags;
 
     if (unlikely(stat(path, &sb) == -1))        /* no such dirent (anymore) */
@@ -1114,6 +1188,12 @@ static proc_t* simple_readtask(PROCTAB *restrict const PT, const proc_t *restric
         if (unlikely(flags & PROC_FILL_LXC))            // value the lxc name
             t->lxcname = lxc_containers(path);
 
+        if (unlikely(flags & PROC_FILLNUMA)) {          // read /proc/#/task/#/numa_maps
+            t->numa_pref = -1;
+            if (likely(file2str(path, "numa_maps", &ub) != -1))
+                numamaps2proc(ub.buf, t);
+        }
+
 #ifdef QUICK_THREADS
     } else {
         t->size     = p->size;
@@ -1138,6 +1218,9 @@ static proc_t* simple_readtask(PROCTAB *restrict const PT, const proc_t *restric
         t->sd_unit  = p->sd_unit;
         t->sd_uunit = p->sd_uunit;
         t->lxcname = p->lxcname;
+        t->numa_pref  = p->numa_pref;
+        t->numa_kb    = p->numa_kb;
+        t->numa_nodes = p->numa_nodes;
         MK_THREAD(t);
     }
 #endif
@@ -1152,6 +1235,11 @@ static proc_t* simple_readtask(PROCTAB *restrict const PT, const proc_t *restric
     if (unlikely(flags & PROC_FILLNS))                  // read /proc/#/task/#/ns/*
         ns2proc(path, t);
 
+    if (unlikely(flags & PROC_FILLDELAY)) {             // ask taskstats, one at a time
+        proc_t *one = t;
+        get_delayacct(&one, 1, 1);
+    }
+
     return t;
 next_task:
     return NULL;
@@ -1164,7 +1252,7 @@ next_task:
 // This finds processes in /proc in the traditional way.
 // Return non-zero on success.
 static int simple_nextpid(PROCTAB *restrict const PT, proc_t *restrict const p) {
-  static struct dirent *ent;		/* dirent handle */
+  static __thread struct dirent *ent;		/* dirent handle */
   char *restrict const path = PT->path;
   for (;;) {
     ent = readdir(PT->procfs);
@@ -1182,7 +1270,7 @@ static int simple_nextpid(PROCTAB *restrict const PT, proc_t *restrict const p)
 // This finds tasks in /proc/*/task/ in the traditional way.
 // Return non-zero on success.
 static int simple_nexttid(PROCTAB *restrict const PT, const proc_t *restrict const p, proc_t *restrict const t, char *restrict const path) {
-  static struct dirent *ent;		/* dirent handle */
+  static __thread struct dirent *ent;		/* dirent handle */
   if(PT->taskdir_user != p->tgid){
     if(PT->taskdir){
       closedir(PT->taskdir);
@@ -1219,6 +1307,118 @@ static int listed_nextpid(PROCTAB *restrict const PT, proc_t *restrict const p)
   return tgid;
 }
 
+//////////////////////////////////////////////////////////////////////////////////
+// PROC_CGROUP support -- the pids of interest are gathered from the cgroup v2
+// hierarchy once, at openproc() time, and then served up by listed_nextpid().
+
+typedef struct cgpids_s {
+    pid_t *pids;
+    int n, alloc;
+} cgpids_s;
+
+// return the tgid owning a tid, as reported by /proc/#/status (0 if gone)
+static pid_t tid_to_tgid(pid_t tid) {
+  char path[PROCPATHLEN], buf[512], *cp;
+  int fd, num;
+
+  snprintf(path, sizeof(path), "/proc/%d/status", tid);
+  if ((fd = open(path, O_RDONLY)) == -1) return 0;
+  num = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (num <= 0) return 0;
+  buf[num] = '\0';
+  if (!(cp = strstr(buf, "\nTgid:"))) return 0;
+  return strtol(cp + 6, NULL, 10);
+}
+
+// append the pids (or tids, as their tgids) listed in one cgroup file
+static int cgroup_read_pids(cgpids_s *cg, const char *dir, const char *file, int tids) {
+  char path[PATH_MAX];
+  FILE *fp;
+  int id, ok;
+
+  snprintf(path, sizeof(path), "%s/%s", dir, file);
+  if (!(fp = fopen(path, "r"))) return 0;
+  while (1 == fscanf(fp, "%d", &id)) {
+    if (tids && !(id = tid_to_tgid(id))) continue;
+    if (cg->n + 1 >= cg->alloc) {
+      cg->alloc = 64 + cg->alloc * 2;
+      cg->pids = xrealloc(cg->pids, sizeof(pid_t) * cg->alloc);
+    }
+    cg->pids[cg->n++] = id;
+  }
+  ok = !ferror(fp);
+  fclose(fp);
+  return ok;
+}
+
+// gather the members of one cgroup, and maybe those of its descendants
+static void cgroup_gather(cgpids_s *cg, const char *dir, int tree) {
+  char path[PATH_MAX];
+  struct dirent *ent;
+  DIR *d;
+
+  // a threaded (non-domain) cgroup refuses reads of cgroup.procs
+  if (!cgroup_read_pids(cg, dir, "cgroup.procs", 0))
+    cgroup_read_pids(cg, dir, "cgroup.threads", 1);
+  if (!tree || !(d = opendir(dir))) return;
+  while ((ent = readdir(d))) {
+    if (ent->d_type != DT_DIR || ent->d_name[0] == '.') continue;
+    snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+    cgroup_gather(cg, path, tree);
+  }
+  closedir(d);
+}
+
+static int cgroup_pidcmp(const void *a, const void *b) {
+  return *(const pid_t *)a - *(const pid_t *)b;
+}
+
+// resolve a cgroup directory (relative names are taken from /sys/fs/cgroup)
+// into 'real', which must then lie within /sys/fs/cgroup
+static int cgroup_resolve(const char *dir, char *real) {
+  char path[PATH_MAX];
+
+  if (*dir == '/') snprintf(path, sizeof(path), "%s", dir);
+  else snprintf(path, sizeof(path), "/sys/fs/cgroup/%s", dir);
+  if (!realpath(path, real)) return errno;
+  if (strncmp(real, "/sys/fs/cgroup", 14) || (real[14] && real[14] != '/'))
+    return EXDEV;
+  return 0;
+}
+
+// 0 if 'dir' is a usable cgroup directory, else an errno value (EXDEV for
+// a directory outside of /sys/fs/cgroup)
+int check_cgroup(const char *dir) {
+  char real[PATH_MAX], path[PATH_MAX + sizeof("/cgroup.procs")];
+  int fd, rc;
+
+  if ((rc = cgroup_resolve(dir, real))) return rc;
+  snprintf(path, sizeof(path), "%s/cgroup.procs", real);
+  if ((fd = open(path, O_RDONLY)) == -1) return errno;
+  close(fd);
+  return 0;
+}
+
+// build a 0 terminated, ascending and duplicate free pid list for the
+// passed cgroup directories, ignoring any that aren't in /sys/fs/cgroup
+static pid_t *cgroup_pidlist(char **dirs, int tree) {
+  char path[PATH_MAX];
+  cgpids_s cg = { NULL, 0, 0 };
+  int i, j;
+
+  for (; dirs && *dirs; dirs++) {
+    if (cgroup_resolve(*dirs, path)) continue;
+    cgroup_gather(&cg, path, tree);
+  }
+  if (!cg.pids) return xcalloc(sizeof(pid_t));
+  qsort(cg.pids, cg.n, sizeof(pid_t), cgroup_pidcmp);
+  for (i = j = 0; i < cg.n; i++)
+    if (!j || cg.pids[j-1] != cg.pids[i]) cg.pids[j++] = cg.pids[i];
+  cg.pids[j] = 0;
+  return cg.pids;
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 /* readproc: return a pointer to a proc_t filled with requested info about the
  * next process available matching the restriction set.  If no more such
@@ -1316,14 +1516,98 @@ out:
   return NULL;
 }
 
+//////////////////////////////////////////////////////////////////////////////////
+// readproc_more: fill in more of a proc_t already returned by readproc, readtask
+// or readeither.  Only those costlier flags which don't depend on stat or status
+// are honored (cmdline, environ, cgroup, oom, ns, systemd, lxc and numa) and any
+// such parts already present are left alone.  This lets a caller defer the reads
+// until it knows which tasks it'll actually be using.  The user and group names
+// can be resolved here too, from ids already read -- including the real, saved
+// and filesystem ones when PROC_FILLSTATUS is also passed (it's not re-read).
+proc_t* readproc_more (proc_t *restrict const p, unsigned flags) {
+    static __thread struct utlbuf_s ub = { NULL, 0 };    // buf for oom_*, numa_maps
+    char path[PROCPATHLEN];
+
+    if (p->tid == p->tgid)
+        snprintf(path, sizeof(path), "/proc/%d", p->tgid);
+    else
+        snprintf(path, sizeof(path), "/proc/%d/task/%d", p->tgid, p->tid);
+
+    if ((flags & PROC_FILLSUPGRP) && (flags & PROC_FILLSTATUS) && !p->supgrp)
+        supgrps_from_supgids(p);
+
+    if (flags & PROC_FILLUSR){
+        memcpy(p->euser, pwcache_get_user(p->euid), sizeof p->euser);
+        if(flags & PROC_FILLSTATUS) {
+            memcpy(p->ruser, pwcache_get_user(p->ruid), sizeof p->ruser);
+            memcpy(p->suser, pwcache_get_user(p->suid), sizeof p->suser);
+            memcpy(p->fuser, pwcache_get_user(p->fuid), sizeof p->fuser);
+        }
+    }
+
+    if (flags & PROC_FILLGRP){
+        memcpy(p->egroup, pwcache_get_group(p->egid), sizeof p->egroup);
+        if(flags & PROC_FILLSTATUS) {
+            memcpy(p->rgroup, pwcache_get_group(p->rgid), sizeof p->rgroup);
+            memcpy(p->sgroup, pwcache_get_group(p->sgid), sizeof p->sgroup);
+            memcpy(p->fgroup, pwcache_get_group(p->fgid), sizeof p->fgroup);
+        }
+    }
+
+    if ((flags & PROC_FILLENV) && !p->environ) {
+        if (flags & PROC_EDITENVRCVT)
+            fill_environ_cvt(path, p);
+        else
+            p->environ = file2strvec(path, "environ");
+    }
+
+    if ((flags & (PROC_FILLCOM|PROC_FILLARG)) && !p->cmdline) {
+        if (flags & PROC_EDITCMDLCVT)
+            fill_cmdline_cvt(path, p);
+        else
+            p->cmdline = file2strvec(path, "cmdline");
+    }
+
+    if ((flags & PROC_FILLCGROUP) && !p->cgroup) {
+        if (flags & PROC_EDITCGRPCVT)
+            fill_cgroup_cvt(path, p);
+        else
+            p->cgroup = file2strvec(path, "cgroup");
+    }
+
+    if (flags & PROC_FILLOOM) {
+        if (likely(file2str(path, "oom_score", &ub) != -1))
+            oomscore2proc(ub.buf, p);
+        if (likely(file2str(path, "oom_adj", &ub) != -1))
+            oomadj2proc(ub.buf, p);
+    }
+
+    if (flags & PROC_FILLNS)
+        ns2proc(path, p);
+
+    if ((flags & PROC_FILLSYSTEMD) && !p->sd_unit)
+        sd2proc(p);
+
+    if ((flags & PROC_FILL_LXC) && !p->lxcname)
+        p->lxcname = lxc_containers(path);
+
+    if ((flags & PROC_FILLNUMA) && !p->numa_nodes) {
+        p->numa_pref = -1;
+        if (likely(file2str(path, "numa_maps", &ub) != -1))
+            numamaps2proc(ub.buf, p);
+    }
+
+    return p;
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 // readeither: return a pointer to a proc_t filled with requested info about
 // the next unique process or task available.  If no more are available,
 // return a null pointer (boolean false).  Use the passed buffer instead
 // of allocating space if it is non-NULL.
 proc_t* readeither (PROCTAB *restrict const PT, proc_t *restrict x) {
-    static proc_t skel_p;    // skeleton proc_t, only uses tid + tgid
-    static proc_t *new_p;    // for process/task transitions
+    static __thread proc_t skel_p;    // skeleton proc_t, only uses tid + tgid
+    static __thread proc_t *new_p;    // for process/task transitions
     char path[PROCPATHLEN];
     proc_t *saved_x, *ret;
 
@@ -1362,7 +1646,7 @@ end_procs:
 PROCTAB* openproc(int flags, ...) {
     va_list ap;
     struct stat sbuf;
-    static int did_stat;
+    static __thread int did_stat;
     PROCTAB* PT = xmalloc(sizeof(PROCTAB));
 
     if (!did_stat){
@@ -1375,7 +1659,8 @@ PROCTAB* openproc(int flags, ...) {
     PT->taskreader = simple_readtask;
 
     PT->reader = simple_readproc;
-    if (flags & PROC_PID){
+    PT->cgpids = NULL;
+    if (flags & (PROC_PID | PROC_CGROUP)){
         PT->procfs = NULL;
         PT->finder = listed_nextpid;
     }else{
@@ -1388,6 +1673,8 @@ PROCTAB* openproc(int flags, ...) {
     va_start(ap, flags);
     if (flags & PROC_PID)
         PT->pids = va_arg(ap, pid_t*);
+    else if (flags & PROC_CGROUP)
+        PT->pids = PT->cgpids = cgroup_pidlist(va_arg(ap, char**), flags & PROC_CGRPTREE);
     else if (flags & PROC_UID){
         PT->uids = va_arg(ap, uid_t*);
         PT->nuid = va_arg(ap, int);
@@ -1406,6 +1693,7 @@ void closeproc(PROCTAB* PT) {
     if (PT){
         if (PT->procfs) closedir(PT->procfs);
         if (PT->taskdir) closedir(PT->taskdir);
+        free(PT->cgpids);
         memset(PT,'#',sizeof(PROCTAB));
         free(PT);
     }
@@ -1459,7 +1747,7 @@ proc_t** readproctab(int flags, ...) {
 	i = va_arg(ap, int);
 	PT = openproc(flags, u, i);
     }
-    else if (flags & PROC_PID)
+    else if (flags & (PROC_PID | PROC_CGROUP))
 	PT = openproc(flags, va_arg(ap, void*)); /* assume ptr sizes same */
     else
 	PT = openproc(flags);
@@ -183,6 +183,19 @@ typedef struct proc_t {
         *sd_uunit;      // n/a             systemd user unit id
     const char
         *lxcname;       // n/a             lxc container name
+    unsigned long long
+        delay_cpu,      // taskstats       time spent waiting for a cpu (ns)
+        delay_blkio,    // taskstats       time spent waiting on block io (ns)
+        delay_swapin,   // taskstats       time spent waiting on swap in (ns)
+        delay_freepages;// taskstats       time spent waiting on memory reclaim (ns)
+    int
+        numa_pref;      // numa_maps       node holding the most of its memory (or -1)
+    unsigned long
+        numa_kb;        // numa_maps       memory resident on any node (as kb)
+    char
+        *numa_nodes;    // numa_maps       that memory by node, as "node:kb ..."
+    int
+        hist_slot;      // (special)       top's history ring slot (is not filled in by readproc!!!)
 } proc_t;
 
 // PROCTAB: data structure holding the persistent information readproc needs
@@ -215,10 +228,11 @@ typedef struct PROCTAB {
     void *      vp; // generic
     char        path[PROCPATHLEN];  // must hold /proc/2000222000/task/2000222000/cmdline
     unsigned pathlen;        // length of string in the above (w/o '\0')
+    pid_t*      cgpids;      // PROC_CGROUP: the pid list gathered by openproc()
 } PROCTAB;
 
 // Initialize a PROCTAB structure holding needed call-to-call persistent data
-extern PROCTAB* openproc(int flags, ... /* pid_t*|uid_t*|dev_t*|char* [, int n] */ );
+extern PROCTAB* openproc(int flags, ... /* pid_t*|uid_t*|dev_t*|char*|char** [, int n] */ );
 
 typedef struct proc_data_t {  // valued by: (else zero)
     proc_t **tab;             //     readproctab2, readproctab3
@@ -251,10 +265,30 @@ extern void closeproc(PROCTAB* PT);
 //       only before first use.  Thereafter, the library will manage such
 //       a passed proc_t, freeing any additional acquired memory associated
 //       with the previous process or thread.
+//
+// Note: Distinct PROCTABs, each opened (and later closed) by one thread, may
+//       be read concurrently from several threads so long as no more than
+//       PROC_FILLSTAT, PROC_FILLMEM, PROC_FILLSTATUS, PROC_FILLOOM, PROC_FILLNS
+//       and PROC_PID were requested.  Anything else (names especially) can be
+//       filled in afterwards, from the one thread, via readproc_more.
 extern proc_t* readproc(PROCTAB *__restrict const PT, proc_t *__restrict p);
 extern proc_t* readtask(PROCTAB *__restrict const PT, const proc_t *__restrict const p, proc_t *__restrict t);
 extern proc_t* readeither(PROCTAB *__restrict const PT, proc_t *__restrict x);
 
+// Fill in more of a proc_t returned by one of the above, for just those flags
+// not needing stat or status (PROC_FILLENV, PROC_FILLARG, PROC_FILLCGROUP,
+// PROC_FILLOOM, PROC_FILLNS, PROC_FILLSYSTEMD, PROC_FILL_LXC, PROC_FILLNUMA,
+// plus any of the PROC_EDITxxxCVT flags).  This allows the reading of those
+// costlier parts to be put off until it's known just which tasks they're
+// needed for.  Also, PROC_FILLUSR, PROC_FILLGRP and PROC_FILLSUPGRP resolve
+// the ids already read (all of them if PROC_FILLSTATUS is passed too,
+// otherwise just the effective).
+extern proc_t* readproc_more(proc_t *__restrict const p, unsigned flags);
+
+// Check a directory meant for PROC_CGROUP: 0 if usable, else an errno value,
+// EXDEV when it isn't within /sys/fs/cgroup (relative names are taken from there)
+extern int check_cgroup(const char *dir);
+
 // warning: interface may change
 extern int read_cmdline(char *__restrict const dst, unsigned sz, unsigned pid);
 
@@ -294,12 +328,17 @@ extern proc_t * get_proc_stats(pid_t pid, proc_t *p);
 #define PROC_FILLNS          0x8000 // fill in proc_t namespace information
 #define PROC_FILLSYSTEMD    0x80000 // fill in proc_t systemd information
 #define PROC_FILL_LXC      0x800000 // fill in proc_t lxcname, if possible
+#define PROC_FILLDELAY     0x400000 // fill in proc_t delay_*, if taskstats permits
+#define PROC_FILLNUMA    0x10000000 // fill in proc_t numa_*, from numa_maps
 
 #define PROC_LOOSE_TASKS     0x2000 // treat threads as if they were processes
 
 // consider only processes with one of the passed:
 #define PROC_PID             0x1000  // process id numbers ( 0   terminated)
 #define PROC_UID             0x4000  // user id numbers    ( length needed )
+#define PROC_CGROUP        0x100000  // cgroup v2 directories ( NULL terminated )
+
+#define PROC_CGRPTREE      0x200000  // with PROC_CGROUP, include all descendant cgroups
 
 #define PROC_EDITCGRPCVT    0x10000 // edit `cgroup' as single vector
 #define PROC_EDITCMDLCVT    0x20000 // edit `cmdline' as single vector
@@ -20,11 +20,13 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <locale.h>
+#include <time.h>
 
 #include <unistd.h>
 #include <fcntl.h>
@@ -60,6 +62,12 @@ static int meminfo_fd = -1;
 static int vminfo_fd = -1;
 #define VM_MIN_FREE_FILE "/proc/sys/vm/min_free_kbytes"
 static int vm_min_free_fd = -1;
+#define PSI_CPU_FILE "/proc/pressure/cpu"
+#define PSI_MEM_FILE "/proc/pressure/memory"
+#define PSI_IO_FILE  "/proc/pressure/io"
+static int psi_fd[PSI_MAX] = { -1, -1, -1 };
+#define NODE_DIR     "/sys/devices/system/node"
+static int node_online_fd = -1;
 
 // As of 2.6.24 /proc/meminfo seems to need 888 on 64-bit,
 // and would need 1258 if the obsolete fields were there.
@@ -353,6 +361,46 @@ static void init_libproc(void){
   old_Hertz_hack();
 }
 
+/***********************************************************************
+ * Parse the /proc/stat cpu line at *bp, either the "cpu" summary (giving
+ * an id of -1) or one "cpuN", along with up to 8 of its tics (the rest are
+ * zeroed).  Returns the number of tics found, or -1 when that isn't a cpu
+ * line at all, and leaves *bp at the start of the next line.  This stands
+ * in for sscanf, which is far too slow for the thousand or so such lines
+ * on the largest machines.
+ */
+int stat_cpu_line(const char **bp, int *id, jiff *tics){
+    const char *p = *bp;
+    int n;
+
+    if (p[0] != 'c' || p[1] != 'p' || p[2] != 'u')
+        return -1;
+    p += 3;
+    if (*p == ' ')
+        *id = -1;
+    else if (*p >= '0' && *p <= '9')
+        for (*id = 0; *p >= '0' && *p <= '9'; p++)
+            *id = *id * 10 + (*p - '0');
+    else
+        return -1;
+    for (n = 0; n < 8; n++) {
+        while (*p == ' ')
+            p++;
+        if (*p < '0' || *p > '9')
+            break;
+        for (tics[n] = 0; *p >= '0' && *p <= '9'; p++)
+            tics[n] = tics[n] * 10 + (*p - '0');
+    }
+    memset(tics + n, 0, (8 - n) * sizeof(jiff));
+    // on past any guest tics, which are already counted in user and nice
+    if ((p = strchr(p, '\n')))
+        p++;
+    else
+        p = *bp + strlen(*bp);
+    *bp = p;
+    return n;
+}
+
 #if 0
 /***********************************************************************
  * The /proc filesystem calculates idle=jiffies-(user+nice+sys) and we
@@ -370,6 +418,9 @@ void eight_cpu_numbers(double *restrict uret, double *restrict nret, double *res
     static JT old_u, old_n, old_s, old_i, old_w, old_x, old_y, old_z;
     JT new_u, new_n, new_s, new_i, new_w, new_x, new_y, new_z;
     JT ticks_past; /* avoid div-by-0 by not calling too often :-( */
+    jiff tics[8];
+    const char *bp = buf;
+    int id;
 
     tmp_w = 0.0;
     new_w = 0;
@@ -381,7 +432,9 @@ void eight_cpu_numbers(double *restrict uret, double *restrict nret, double *res
     new_z = 0;
 
     FILE_TO_BUF(STAT_FILE,stat_fd);
-    sscanf(buf, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &new_u, &new_n, &new_s, &new_i, &new_w, &new_x, &new_y, &new_z);
+    stat_cpu_line(&bp, &id, tics);
+    new_u = tics[0]; new_n = tics[1]; new_s = tics[2]; new_i = tics[3];
+    new_w = tics[4]; new_x = tics[5]; new_y = tics[6]; new_z = tics[7];
     ticks_past = (new_u+new_n+new_s+new_i+new_w+new_x+new_y+new_z)-(old_u+old_n+old_s+old_i+old_w+old_x+old_y+old_z);
     if(ticks_past){
       scale = 100.0 / (double)ticks_past;
@@ -501,11 +554,17 @@ void getstat(jiff *restrict cuse, jiff *restrict cice, jiff *restrict csys, jiff
 	     unsigned int *restrict running, unsigned int *restrict blocked,
 	     unsigned int *restrict btime, unsigned int *restrict processes) {
   static int fd;
+  static char *sbuf;      /* with a line per cpu, this can outgrow buff */
+  static size_t ssiz;
   unsigned long long llbuf = 0;
   int need_vmstat_file = 0;
   int need_proc_scan = 0;
+  size_t tot = 0;
+  ssize_t n;
+  jiff tics[8];
   const char* b;
-  buff[BUFFSIZE-1] = 0;  /* ensure null termination in buffer */
+  const char* rest;
+  int id;
 
   if(fd){
     lseek(fd, 0L, SEEK_SET);
@@ -513,43 +572,52 @@ void getstat(jiff *restrict cuse, jiff *restrict cice, jiff *restrict csys, jiff
     fd = open("/proc/stat", O_RDONLY, 0);
     if(fd == -1) crash("/proc/stat");
   }
-  read(fd,buff,BUFFSIZE-1);
+  if(!sbuf) sbuf = xmalloc((ssiz = BUFFSIZE));
+  while((n = read(fd, sbuf + tot, ssiz - 1 - tot)) > 0){
+    tot += n;
+    if(tot == ssiz - 1) sbuf = xrealloc(sbuf, (ssiz *= 2));
+  }
+  sbuf[tot] = '\0';
   *intr = 0;
-  *ciow = 0;  /* not separated out until the 2.5.41 kernel */
-  *cxxx = 0;  /* not separated out until the 2.6.0-test4 kernel */
-  *cyyy = 0;  /* not separated out until the 2.6.0-test4 kernel */
-  *czzz = 0;  /* not separated out until the 2.6.11 kernel */
 
-  b = strstr(buff, "cpu ");
-  if(b) sscanf(b,  "cpu  %llu %llu %llu %llu %llu %llu %llu %llu", cuse, cice, csys, cide, ciow, cxxx, cyyy, czzz);
+  /* the summary line comes first, with every cpu's line right after it
+     (any tics not yet separated out by older kernels are left zeroed) */
+  b = sbuf;
+  if(stat_cpu_line(&b, &id, tics) >= 0){
+    *cuse = tics[0]; *cice = tics[1]; *csys = tics[2]; *cide = tics[3];
+    *ciow = tics[4]; *cxxx = tics[5]; *cyyy = tics[6]; *czzz = tics[7];
+  }
+  while(!strncmp(b, "cpu", 3) && (rest = strchr(b, '\n')))
+    b = rest + 1;
+  rest = b;
 
-  b = strstr(buff, "page ");
+  b = strstr(rest, "page ");
   if(b) sscanf(b,  "page %lu %lu", pin, pout);
   else need_vmstat_file = 1;
 
-  b = strstr(buff, "swap ");
+  b = strstr(rest, "swap ");
   if(b) sscanf(b,  "swap %lu %lu", s_in, sout);
   else need_vmstat_file = 1;
 
-  b = strstr(buff, "intr ");
+  b = strstr(rest, "intr ");
   if(b) sscanf(b,  "intr %llu", &llbuf);
   *intr = llbuf;
 
-  b = strstr(buff, "ctxt ");
+  b = strstr(rest, "ctxt ");
   if(b) sscanf(b,  "ctxt %llu", &llbuf);
   *ctxt = llbuf;
 
-  b = strstr(buff, "btime ");
+  b = strstr(rest, "btime ");
   if(b) sscanf(b,  "btime %u", btime);
 
-  b = strstr(buff, "processes ");
+  b = strstr(rest, "processes ");
   if(b) sscanf(b,  "processes %u", processes);
 
-  b = strstr(buff, "procs_running ");
+  b = strstr(rest, "procs_running ");
   if(b) sscanf(b,  "procs_running %u", running);
   else need_proc_scan = 1;
 
-  b = strstr(buff, "procs_blocked ");
+  b = strstr(rest, "procs_blocked ");
   if(b) sscanf(b,  "procs_blocked %u", blocked);
   else need_proc_scan = 1;
 
@@ -1126,6 +1194,196 @@ out:
   return ret;
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Pressure Stall Information
+//
+// Unlike the rest of /proc these files may legitimately be missing (no
+// CONFIG_PSI) or unreadable (booted with psi=0), so rather than exiting
+// the way FILE_TO_BUF does, getpressure() simply reports them unavailable.
+// Callers get the raw total= counters and pressure_pct() turns two of
+// those samples into the share of the interval spent stalled, which is
+// what the avg10/avg60/avg300 fields only approximate.
+
+static int psi_to_buf(const char *filename, int *fd){
+  int n;
+
+  if (*fd == -1 && (*fd = open(filename, O_RDONLY)) == -1)
+    return 0;
+  lseek(*fd, 0L, SEEK_SET);
+  if ((n = read(*fd, buf, sizeof buf - 1)) <= 0)
+    return 0;
+  buf[n] = '\0';
+  return 1;
+}
+
+// returns 1 with psi filled in, or 0 when the kernel offers no PSI
+int getpressure(psi_info *restrict psi){
+  static const char *const files[PSI_MAX] = { PSI_CPU_FILE, PSI_MEM_FILE, PSI_IO_FILE };
+  static int unavailable;
+  struct timespec ts;
+  char *head, *total;
+  int i;
+
+  memset(psi, 0, sizeof(*psi));
+  if (unavailable)
+    return 0;
+  for (i = 0; i < PSI_MAX; i++) {
+    if (!psi_to_buf(files[i], &psi_fd[i])) {
+      // they come and go together, so one failing means none will work
+      for (i = 0; i < PSI_MAX; i++)
+        if (psi_fd[i] != -1) { close(psi_fd[i]); psi_fd[i] = -1; }
+      unavailable = 1;
+      return 0;
+    }
+    // "some avg10=0.00 avg60=0.00 avg300=0.00 total=0" then a "full" line,
+    // the latter absent for cpu before 5.13
+    for (head = buf; head && (total = strstr(head, "total=")); head = strchr(total, '\n')) {
+      while (*head == '\n') head++;
+      if (!strncmp(head, "full", 4))
+        psi->full[i] = strtoull(total + 6, NULL, 10);
+      else
+        psi->some[i] = strtoull(total + 6, NULL, 10);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  psi->stamp = ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+  return 1;
+}
+
+// percentage of the time between two samples spent stalled, per resource;
+// with a zeroed prev, that's the average since boot
+void pressure_pct(const psi_info *restrict now, const psi_info *restrict prev, double *restrict some, double *restrict full){
+  double span = now->stamp > prev->stamp ? now->stamp - prev->stamp : 0;
+  int i;
+
+  for (i = 0; i < PSI_MAX; i++) {
+    some[i] = full[i] = 0;
+    if (!span) continue;
+    if (now->some[i] > prev->some[i])
+      some[i] = MIN(100.0, (now->some[i] - prev->some[i]) * 100.0 / span);
+    if (now->full[i] > prev->full[i])
+      full[i] = MIN(100.0, (now->full[i] - prev->full[i]) * 100.0 / span);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Per NUMA node memory
+//
+// Each node's meminfo ("Node 0 MemFree:  3665212 kB" and so on) and numastat
+// ("numa_hit 35765085") are read through fds kept open, two per node, with
+// just the few fields wanted picked out by their first letter then compared.
+// Like PSI these may be missing (no CONFIG_NUMA) so that's no reason to exit.
+
+static int node_to_buf(int node, const char *what, int *fd){
+  char path[64];
+  int n;
+
+  if (*fd == -1) {
+    snprintf(path, sizeof(path), NODE_DIR "/node%d/%s", node, what);
+    if ((*fd = open(path, O_RDONLY)) == -1)
+      return 0;
+  }
+  lseek(*fd, 0L, SEEK_SET);
+  if ((n = read(*fd, buf, sizeof buf - 1)) <= 0) {
+    // the node's gone (hot unplugged), though it may yet return
+    close(*fd);
+    *fd = -1;
+    return 0;
+  }
+  buf[n] = '\0';
+  return 1;
+}
+
+typedef struct node_key {
+  const char *name;        // the field, including its ':' if meminfo's
+  unsigned char len;       // and its length
+  unsigned char ofs;       // where in a node_mem it goes
+  unsigned char ull;       // as an unsigned long long, else unsigned long
+} node_key;
+
+static void node_keys(const char *s, const node_key *keys, int nkeys, node_mem *mem){
+  const char *nl;
+  char *val;
+  int i;
+
+  for (; *s; s = nl ? nl + 1 : s + strlen(s)) {
+    nl = strchr(s, '\n');
+    if (*s == 'N' && !strncmp(s, "Node ", 5)) {  // meminfo, past "Node # "
+      s = strchr(s + 5, ' ');
+      if (!s) break;
+      while (*s == ' ') s++;
+    }
+    for (i = 0; i < nkeys; i++) {
+      if (*s != keys[i].name[0] || strncmp(s, keys[i].name, keys[i].len))
+        continue;
+      val = (char *)mem + keys[i].ofs;
+      if (keys[i].ull)
+        *(unsigned long long *)val = strtoull(s + keys[i].len, NULL, 10);
+      else
+        *(unsigned long *)val = strtoul(s + keys[i].len, NULL, 10);
+      break;
+    }
+  }
+}
+
+// fills in mem[] for as many as max nodes (those offline or without memory
+// zeroed) and returns the highest node online + 1, which may well be more
+// than max, or 0 when there's no NUMA support at all
+int getnodemem(node_mem *restrict mem, int max){
+ #define NK(n,f,u) { n, sizeof(n) - 1, offsetof(node_mem, f), u }
+  static const node_key meminfo_keys[] = {
+    NK("MemTotal:", total, 0), NK("MemFree:", free, 0),
+    NK("FilePages:", file, 0), NK("AnonPages:", anon, 0)
+  };
+  static const node_key numastat_keys[] = {
+    NK("numa_hit ", hit, 1), NK("numa_miss ", miss, 1),
+    NK("local_node ", local, 1), NK("other_node ", other, 1)
+  };
+ #undef NK
+  static int *fds, nfds;
+  static int unavailable;
+  char online[1024], *s;
+  int i, lo, hi, nodes = 0;
+
+  if (max > 0)
+    memset(mem, 0, sizeof(*mem) * max);
+  if (unavailable)
+    return 0;
+  if (node_online_fd == -1
+  && (node_online_fd = open(NODE_DIR "/online", O_RDONLY)) == -1) {
+    unavailable = 1;
+    return 0;
+  }
+  lseek(node_online_fd, 0L, SEEK_SET);
+  if ((i = read(node_online_fd, online, sizeof online - 1)) <= 0)
+    return 0;
+  online[i] = '\0';
+
+  // as in "0-3,5" -- with just the nodes named being read
+  for (s = online; *s >= '0' && *s <= '9'; s++) {
+    lo = hi = strtol(s, &s, 10);
+    if (*s == '-')
+      hi = strtol(s + 1, &s, 10);
+    if (hi > 0xffff)
+      break;
+    nodes = hi + 1;
+    if (2 * nodes > nfds) {
+      fds = xrealloc(fds, sizeof(int) * 2 * nodes);
+      while (nfds < 2 * nodes)
+        fds[nfds++] = -1;
+    }
+    for (i = lo; i <= hi && i < max; i++) {
+      if (node_to_buf(i, "meminfo", &fds[2 * i]))
+        node_keys(buf, meminfo_keys, sizeof(meminfo_keys) / sizeof(node_key), &mem[i]);
+      if (node_to_buf(i, "numastat", &fds[2 * i + 1]))
+        node_keys(buf, numastat_keys, sizeof(numastat_keys) / sizeof(node_key), &mem[i]);
+    }
+    if (*s != ',')
+      break;
+  }
+  return nodes;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 
 void cpuinfo (void) {
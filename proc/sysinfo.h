@@ -63,6 +63,8 @@ extern void getstat(jiff *__restrict cuse, jiff *__restrict cice, jiff *__restri
 	     unsigned *__restrict intr, unsigned *__restrict ctxt,
 	     unsigned int *__restrict running, unsigned int *__restrict blocked,
 	     unsigned int *__restrict btime, unsigned int *__restrict processes);
+/* one /proc/stat "cpu" or "cpuN" line, returning its count of tics (or -1) */
+extern int stat_cpu_line(const char **bp, int *id, jiff *tics);
 
 extern void meminfo(void);
 
@@ -138,6 +140,31 @@ extern unsigned int getslabinfo (struct slab_cache**);
 
 extern unsigned get_pid_digits(void) FUNCTION;
 
+/* Pressure Stall Information, 4.20+ (needs CONFIG_PSI) */
+enum psi_res { PSI_CPU, PSI_MEM, PSI_IO, PSI_MAX };
+
+typedef struct psi_info {
+	unsigned long long some[PSI_MAX];  // total= of the 'some' lines, microseconds
+	unsigned long long full[PSI_MAX];  // total= of the 'full' lines, microseconds
+	unsigned long long stamp;          // CLOCK_MONOTONIC when read, microseconds
+} psi_info;
+
+extern int getpressure(psi_info *psi);
+extern void pressure_pct(const psi_info *now, const psi_info *prev, double *some, double *full);
+
+/* Per NUMA node memory, from /sys/devices/system/node/node#/ */
+typedef struct node_mem {
+	unsigned long total;     // meminfo MemTotal, as kb (0 if the node's offline)
+	unsigned long free;      // meminfo MemFree
+	unsigned long file;      // meminfo FilePages
+	unsigned long anon;      // meminfo AnonPages
+	unsigned long long hit;    // numastat numa_hit, pages allocated here as intended
+	unsigned long long miss;   // numastat numa_miss, here though intended elsewhere
+	unsigned long long local;  // numastat local_node, here by a task running here
+	unsigned long long other;  // numastat other_node, here by a task running elsewhere
+} node_mem;
+extern int getnodemem(node_mem *mem, int max);
+
 extern void cpuinfo (void);
 
 EXTERN_C_END
@@ -0,0 +1,222 @@
+/*
+ * taskstats.c - per task delay accounting through the taskstats netlink
+ *               family, as used by the kernel's getdelays example
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include <linux/taskstats.h>
+
+#include "taskstats.h"
+#include "procps.h"
+
+/* requests per send -- their replies, at around 500 bytes each, have to
+ * fit in the socket's receive buffer while we're still sending */
+#define TS_BATCH 64
+
+#define GENL_PAYLOAD(n) ((char *)NLMSG_DATA(n) + GENL_HDRLEN)
+#define NLA_OK(a,len)   ((len) >= (int)sizeof(struct nlattr) && (a)->nla_len >= sizeof(struct nlattr) && (a)->nla_len <= (len))
+#define NLA_NEXT(a,len) ((len) -= NLA_ALIGN((a)->nla_len), (struct nlattr *)((char *)(a) + NLA_ALIGN((a)->nla_len)))
+#define NLA_DATA(a)     ((void *)((char *)(a) + NLA_HDRLEN))
+#define NLA_LEN(a)      ((int)(a)->nla_len - NLA_HDRLEN)
+
+/* a TASKSTATS_CMD_GET for one pid, exactly as it goes on the wire */
+struct ts_req {
+	struct nlmsghdr n;
+	struct genlmsghdr g;
+	struct nlattr a;
+	__u32 pid;
+};
+
+static int ts_sock = -1;
+static int ts_family;           /* genetlink id, -1 once found unusable */
+static char ts_buf[16384];
+
+static int ts_recv(void)
+{
+	int len;
+
+	do
+		len = recv(ts_sock, ts_buf, sizeof(ts_buf), 0);
+	while (len < 0 && errno == EINTR);
+	return len;
+}
+
+/* open the socket and look up the TASKSTATS family, returning 0 when done */
+static int ts_open(void)
+{
+	struct sockaddr_nl addr;
+	struct timeval tv = { 1, 0 };
+	struct {
+		struct nlmsghdr n;
+		struct genlmsghdr g;
+		char attr[NLA_HDRLEN + NLA_ALIGN(sizeof(TASKSTATS_GENL_NAME))];
+	} req;
+	struct nlattr *a;
+	struct nlmsghdr *n;
+	int len;
+
+	if ((ts_sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC)) < 0)
+		return -1;
+	memset(&addr, 0, sizeof(addr));
+	addr.nl_family = AF_NETLINK;
+	if (bind(ts_sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		return -1;
+	/* never hang a caller should a reply go missing */
+	setsockopt(ts_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	memset(&req, 0, sizeof(req));
+	req.n.nlmsg_len = sizeof(req);
+	req.n.nlmsg_type = GENL_ID_CTRL;
+	req.n.nlmsg_flags = NLM_F_REQUEST;
+	req.g.cmd = CTRL_CMD_GETFAMILY;
+	req.g.version = 1;
+	a = (struct nlattr *)req.attr;
+	a->nla_type = CTRL_ATTR_FAMILY_NAME;
+	a->nla_len = NLA_HDRLEN + sizeof(TASKSTATS_GENL_NAME);
+	strcpy(NLA_DATA(a), TASKSTATS_GENL_NAME);
+	if (send(ts_sock, &req, sizeof(req), 0) < 0)
+		return -1;
+
+	if ((len = ts_recv()) < 0)
+		return -1;
+	n = (struct nlmsghdr *)ts_buf;
+	if (!NLMSG_OK(n, len) || n->nlmsg_type == NLMSG_ERROR)
+		return -1;
+	len = n->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+	for (a = (struct nlattr *)GENL_PAYLOAD(n); NLA_OK(a, len); a = NLA_NEXT(a, len)) {
+		if (a->nla_type == CTRL_ATTR_FAMILY_ID) {
+			ts_family = *(__u16 *)NLA_DATA(a);
+			return 0;
+		}
+	}
+	return -1;
+}
+
+static void ts_store(proc_t *p, const struct nlattr *stats)
+{
+	struct taskstats ts;
+	int len = NLA_LEN(stats);
+
+	/* the kernel's struct may be older (shorter) or newer than ours */
+	memset(&ts, 0, sizeof(ts));
+	memcpy(&ts, NLA_DATA(stats), len < (int)sizeof(ts) ? len : (int)sizeof(ts));
+	p->delay_cpu = ts.cpu_delay_total;
+	p->delay_blkio = ts.blkio_delay_total;
+	p->delay_swapin = ts.swapin_delay_total;
+	p->delay_freepages = ts.freepages_delay_total;
+}
+
+/* pick the stats out of a TASKSTATS_TYPE_AGGR_{PID,TGID} reply */
+static int ts_reply(proc_t *p, struct nlmsghdr *n)
+{
+	struct nlattr *a, *b;
+	int len, blen;
+
+	len = n->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+	for (a = (struct nlattr *)GENL_PAYLOAD(n); NLA_OK(a, len); a = NLA_NEXT(a, len)) {
+		if (a->nla_type != TASKSTATS_TYPE_AGGR_PID && a->nla_type != TASKSTATS_TYPE_AGGR_TGID)
+			continue;
+		blen = NLA_LEN(a);
+		for (b = NLA_DATA(a); NLA_OK(b, blen); b = NLA_NEXT(b, blen)) {
+			if (b->nla_type == TASKSTATS_TYPE_STATS) {
+				ts_store(p, b);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/* query one batch, returning the number filled or -1 if refused */
+static int ts_batch(proc_t *const *tasks, int n, int threads)
+{
+	struct ts_req req[TS_BATCH];
+	struct nlmsghdr *h;
+	int i, len, pending = n, filled = 0;
+
+	memset(req, 0, sizeof(struct ts_req) * n);
+	for (i = 0; i < n; i++) {
+		req[i].n.nlmsg_len = sizeof(struct ts_req);
+		req[i].n.nlmsg_type = ts_family;
+		req[i].n.nlmsg_flags = NLM_F_REQUEST;
+		req[i].n.nlmsg_seq = i;         /* so a reply leads back to its task */
+		req[i].g.cmd = TASKSTATS_CMD_GET;
+		req[i].g.version = TASKSTATS_GENL_VERSION;
+		req[i].a.nla_len = NLA_HDRLEN + sizeof(__u32);
+		req[i].a.nla_type = threads ? TASKSTATS_CMD_ATTR_PID : TASKSTATS_CMD_ATTR_TGID;
+		req[i].pid = threads ? tasks[i]->tid : tasks[i]->tgid;
+	}
+	/* the kernel works through every message in a single send */
+	if (send(ts_sock, req, sizeof(struct ts_req) * n, 0) < 0)
+		return -1;
+
+	while (pending > 0) {
+		if ((len = ts_recv()) < 0)
+			return -1;
+		for (h = (struct nlmsghdr *)ts_buf; NLMSG_OK(h, len); h = NLMSG_NEXT(h, len)) {
+			if (h->nlmsg_seq >= (unsigned)n)
+				continue;
+			pending--;
+			if (h->nlmsg_type == NLMSG_ERROR) {
+				int err = ((struct nlmsgerr *)NLMSG_DATA(h))->error;
+				/* a task may have exited, anything else won't get better */
+				if (err && err != -ESRCH)
+					return -1;
+				continue;
+			}
+			filled += ts_reply(tasks[h->nlmsg_seq], h);
+		}
+	}
+	return filled;
+}
+
+int get_delayacct(proc_t *const *tasks, int n, int threads)
+{
+	int i, k, got, filled = 0;
+
+	for (i = 0; i < n; i++) {
+		tasks[i]->delay_cpu = tasks[i]->delay_blkio = 0;
+		tasks[i]->delay_swapin = tasks[i]->delay_freepages = 0;
+	}
+	if (ts_family < 0)
+		return -1;
+	if (ts_sock < 0 && ts_open() < 0)
+		goto unusable;
+
+	for (i = 0; i < n; i += TS_BATCH) {
+		k = n - i < TS_BATCH ? n - i : TS_BATCH;
+		if ((got = ts_batch(tasks + i, k, threads)) < 0)
+			goto unusable;
+		filled += got;
+	}
+	return filled;
+
+unusable:
+	if (ts_sock >= 0)
+		close(ts_sock);
+	ts_sock = -1;
+	ts_family = -1;
+	return -1;
+}
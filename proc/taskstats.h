@@ -0,0 +1,18 @@
+#ifndef PROC_TASKSTATS_H
+#define PROC_TASKSTATS_H
+
+#include "procps.h"
+#include "readproc.h"
+
+EXTERN_C_BEGIN
+
+/* Fill in the delay_* members of each of the n tasks from the kernel's
+ * taskstats, per thread (by tid) when 'threads' is set or else summed over
+ * each thread group (by tgid).  The queries go out in batches over a single
+ * netlink socket that is kept open between calls.  Returns the number of
+ * tasks filled, or -1 (with the members zeroed) when taskstats can't be
+ * used -- no such genetlink family, or no CAP_NET_ADMIN. */
+extern int get_delayacct(proc_t *const *tasks, int n, int threads);
+
+EXTERN_C_END
+#endif /* PROC_TASKSTATS_H */
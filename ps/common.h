@@ -197,6 +197,8 @@ typedef struct selection_node {
   sel_union *u;  /* used if selection type has a list of values */
   int n;         /* used if selection type has a list of values */
   int typecode;
+  int *hash;     /* long lists only: index+1 into u by hash, 0 if empty */
+  unsigned mask; /* size of hash, less 1 */
 } selection_node;
 
 typedef struct sort_node {
@@ -207,6 +209,19 @@ typedef struct sort_node {
   int need;
 } sort_node;
 
+/* a sort function's column, taken once from a process: numbers, with
+   their sign folded in so they compare as unsigned, or up to 8 chars of a
+   string and where it carries on (NULL once it has ended) */
+typedef struct sort_key {
+  unsigned long long n;
+  const char *s;
+} sort_key;
+
+typedef struct key_struct {
+  int (* const sr)(const proc_t* P, const proc_t* Q); /* sort function */
+  void (* const key)(const proc_t* P, sort_key* K);   /* same order, by key */
+} key_struct;
+
 typedef struct format_node {
   struct format_node *next;
   char *name;                             /* user can override default name */
@@ -267,6 +282,7 @@ extern const aix_struct *search_aix_array(const int findme);
 extern const shortsort_struct *search_shortsort_array(const int findme);
 extern const format_struct *search_format_array(const char *findme);
 extern const macro_struct *search_macro_array(const char *findme);
+extern const key_struct *search_key_array(int (*sr)(const proc_t* P, const proc_t* Q));
 extern void init_output(void);
 extern int pr_nop(char *restrict const outbuf, const proc_t *restrict const pp);
 
@@ -284,6 +300,7 @@ extern int             bsd_c_option;
 extern int             bsd_e_option;
 extern uid_t           cached_euid;
 extern dev_t           cached_tty;
+extern char          **cgroup_list;
 extern char            forest_prefix[4 * 32*1024 + 100];
 extern int             forest_type;
 extern unsigned        format_flags;     /* -l -f l u s -j... */
@@ -362,7 +362,11 @@ static void simple_spew(void){
     }
   }
 
-  ptp = openproc(flags, pidlist);
+  if (cgroup_list) {
+    flags |= PROC_CGROUP | PROC_CGRPTREE;
+    ptp = openproc(flags, cgroup_list);
+  } else
+    ptp = openproc(flags, pidlist);
   if(!ptp) {
     fprintf(stderr, _("error: can not access /proc\n"));
     exit(1);
@@ -451,6 +455,64 @@ static int compare_two_procs(const void *a, const void *b){
   return 0; /* no conclusion */
 }
 
+/***** compare function for qsort, of the records made by sort_procs() */
+static int key_count;     /* the keys in a record, followed by its index */
+static int *key_reverse;
+
+static int compare_two_keys(const void *a, const void *b){
+  const sort_key *p = a;
+  const sort_key *q = b;
+  int i, result;
+  for(i = 0; i < key_count; i++){
+    if(p[i].n != q[i].n) result = (p[i].n < q[i].n) ? -1 : 1;
+    else if(p[i].s && q[i].s) result = strcmp(p[i].s, q[i].s);
+    else result = !!p[i].s - !!q[i].s;   /* one string ended sooner */
+    if(result) return key_reverse[i] ? -result : result;
+  }
+  return (p[i].n > q[i].n) - (p[i].n < q[i].n);  /* as read, if all else ties */
+}
+
+/***** sort processes[] by sort_list */
+/* Rather than compare two proc_t for each sort_node, each process has its
+   keys taken once, into a compact record, and those records are sorted. */
+static void sort_procs(const int n){
+  const key_struct **ks;
+  sort_node *walk;
+  sort_key *rec, *k;
+  proc_t **sorted;
+  int i, j;
+
+  key_count = 0;
+  for(walk = sort_list; walk; walk = walk->next) key_count++;
+  ks = xmalloc((key_count + 1) * sizeof(key_struct *));
+  key_reverse = xmalloc((key_count + 1) * sizeof(int));
+  for(i = 0, walk = sort_list; walk; i++, walk = walk->next){
+    ks[i] = search_key_array(walk->sr);
+    key_reverse[i] = walk->reverse;
+    if(!ks[i]){   /* no key, so compare the old way */
+      qsort(processes, n, sizeof(proc_t*), compare_two_procs);
+      goto done;
+    }
+  }
+  rec = xmalloc((size_t)n * (key_count + 1) * sizeof(sort_key));
+  for(i = 0, k = rec; i < n; i++){
+    for(j = 0; j < key_count; j++) ks[j]->key(processes[i], k++);
+    k->n = i;
+    k->s = NULL;
+    k++;
+  }
+  qsort(rec, n, (key_count + 1) * sizeof(sort_key), compare_two_keys);
+  sorted = xmalloc(n * sizeof(proc_t*));
+  for(i = 0, k = rec + key_count; i < n; i++, k += key_count + 1)
+    sorted[i] = processes[k->n];
+  memcpy(processes, sorted, n * sizeof(proc_t*));
+  free(sorted);
+  free(rec);
+done:
+  free(key_reverse);
+  free(ks);
+}
+
 /***** show pre-sorted array of process pointers */
 static void show_proc_array(PROCTAB *restrict ptp, int n){
   proc_t **p = processes;
@@ -465,11 +527,57 @@ static void show_proc_array(PROCTAB *restrict ptp, int n){
   }
 }
 
+/***** forest index */
+/* A pid hash, built once, gives each process its first child: the first of
+   processes[] whose ppid is its pid (the sort by ppid keeps any siblings
+   adjacent, following that first one).  The hash also knows which ppids are
+   the pid of some listed process, since any process without a listed parent
+   is the root of a tree.  Both were once found by scanning processes[]. */
+typedef struct forest_node {
+  int pid;
+  int child;     /* first of processes[] with this as its ppid, else -1 */
+  char used;
+  char listed;   /* this is the pid of one of processes[] */
+} forest_node;
+
+static forest_node *forest_hash;
+static unsigned forest_mask;
+static int *first_child;
+
+static forest_node *forest_slot(int pid){
+  unsigned h = ((unsigned)pid * 2654435761u) & forest_mask;
+  while(forest_hash[h].used && forest_hash[h].pid != pid)
+    h = (h + 1) & forest_mask;
+  if(!forest_hash[h].used){
+    forest_hash[h].used = 1;
+    forest_hash[h].pid = pid;
+    forest_hash[h].child = -1;
+  }
+  return &forest_hash[h];
+}
+
+static void forest_index(const int n){
+  forest_node *f;
+  int i;
+  /* each process brings at most 2 pids, so this stays half empty */
+  for(forest_mask = 1023; forest_mask < 4u * n; forest_mask = forest_mask * 2 + 1)
+    ;
+  forest_hash = xcalloc((forest_mask + 1) * sizeof(forest_node));
+  first_child = xmalloc(n * sizeof(int));
+  i = n;
+  while(i--)   /* backward, so each ppid is left with its first child */
+    forest_slot(processes[i]->ppid)->child = i;
+  for(i = 0; i < n; i++){
+    f = forest_slot(processes[i]->XXXID);
+    f->listed = 1;
+    first_child[i] = f->child;
+  }
+}
+
 /***** show tree */
-/* this needs some optimization work */
 #define ADOPTED(x) 1
 static void show_tree(const int self, const int n, const int level, const int have_sibling){
-  int i = 0;
+  int i;
   if(level){
     /* add prefix of "+" or "L" */
     if(have_sibling) forest_prefix[level-1] = '+';
@@ -477,11 +585,8 @@ static void show_tree(const int self, const int n, const int level, const int ha
     forest_prefix[level] = '\0';
   }
   show_one_proc(processes[self],format_list);  /* first show self */
-  for(;;){  /* look for children */
-    if(i >= n) return; /* no children */
-    if(processes[i]->ppid == processes[self]->XXXID) break;
-    i++;
-  }
+  i = first_child[self];  /* look for children */
+  if(i < 0) return; /* no children */
   if(level){
     /* change our prefix to "|" or " " for the children */
     if(have_sibling) forest_prefix[level-1] = '|';
@@ -511,15 +616,10 @@ static void show_tree(const int self, const int n, const int level, const int ha
 /***** show forest */
 static void show_forest(const int n){
   int i = n;
-  int j;
+  forest_index(n);
   while(i--){   /* cover whole array looking for trees */
-    j = n;
-    while(j--){   /* search for parent: if none, i is a tree! */
-      if(processes[j]->XXXID == processes[i]->ppid) goto not_root;
-    }
-    show_tree(i,n,0,0);
-not_root:
-    ;
+    if(forest_slot(processes[i]->ppid)->listed) continue;
+    show_tree(i,n,0,0);   /* no parent: i is a tree! */
   }
   /* don't free the array because it takes time and ps will exit anyway */
 }
@@ -536,8 +636,11 @@ static void fancy_spew(void){
   proc_data_t *pd = NULL;
   PROCTAB *restrict ptp;
   int n = 0;  /* number of processes & index into array */
+  int flags;
 
-  ptp = openproc(needs_for_format | needs_for_sort | needs_for_select | needs_for_threads);
+  flags = needs_for_format | needs_for_sort | needs_for_select | needs_for_threads;
+  if (cgroup_list) flags |= PROC_CGROUP | PROC_CGRPTREE;
+  ptp = openproc(flags, cgroup_list);
   if(!ptp) {
     fprintf(stderr, _("error: can not access /proc\n"));
     exit(1);
@@ -553,7 +656,7 @@ static void fancy_spew(void){
 
   if(!n) return;  /* no processes */
   if(forest_type) prep_forest_sort();
-  qsort(processes, n, sizeof(proc_t*), compare_two_procs);
+  sort_procs(n);
   if(forest_type) show_forest(n);
   else show_proc_array(ptp,n);
   closeproc(ptp);
@@ -60,6 +60,7 @@ const char     *bsd_v_format = (const char *)0xdeadbeef;
 int             bsd_c_option = -1;
 int             bsd_e_option = -1;
 uid_t           cached_euid = -1;
+char          **cgroup_list = (char **)0xdeadbeef;
 dev_t           cached_tty = -1;
 char            forest_prefix[4 * 32*1024 + 100];     // FIXME
 int             forest_type = -1;
@@ -102,6 +103,7 @@ static void reset_selection_list(void){
     old = walk;
     walk = old->next;
     free(old->u);
+    free(old->hash);
     free(old);
   }
   selection_list = NULL;
@@ -371,6 +373,7 @@ void reset_global(void){
   bsd_e_option          = 0;
   cached_euid           = geteuid();
   cached_tty            = p.tty;
+  cgroup_list           = NULL;  /* points into argv, nothing to free but the array */
 /* forest_prefix must be all zero because of POSIX */
   forest_type           = 0;
   format_flags          = 0;   /* -l -f l u s -j... */
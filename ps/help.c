@@ -109,6 +109,7 @@ void do_help (const char *opt, int rc) {
   if (section == HELP_LST || section == HELP_ALL) {
     fputs(_("\nSelection by list:\n"), out);
     fputs(_(" -C <command>         command name\n"), out);
+    fputs(_("     --cgroup <path>  only processes in a cgroup v2 subtree\n"), out);
     fputs(_(" -G, --Group <GID>    real group id or name\n"), out);
     fputs(_(" -g, --group <group>  session or effective group name\n"), out);
     fputs(_(" -p, p, --pid <PID>   process id\n"), out);
@@ -98,6 +98,32 @@ static int sr_nop(const proc_t* a, const proc_t* b){
   (void)a;(void)b; /* shut up gcc */
   return 0;
 }
+static void key_nop(const proc_t* P, sort_key* K){
+  (void)P; /* shut up gcc */
+  K->n = 0;
+  K->s = NULL;
+}
+
+/* Each sort function has a key function, which puts the column in a form
+ * where plain unsigned compares give the same order.  Signed numbers get
+ * their sign bit flipped (0 * X - 1 is only positive for unsigned X).  The
+ * sr_cgroup() has none, since it finds a NULL vector equal to any other.
+ */
+#define KEY_NUM(K,X) do{ \
+    (K)->n = (unsigned long long)(X) ^ (0 * (X) - 1 > 0 ? 0 : 1ULL << 63); \
+    (K)->s = NULL; \
+}while(0)
+
+static void key_str(const char *S, sort_key* K){
+  unsigned long long n = 0;
+  int i;
+  for(i = 0; i < 8; i++){   /* big-endian, so as to compare like strcmp */
+    n <<= 8;
+    if(*S) n |= (unsigned char)*S++;
+  }
+  K->n = n;
+  K->s = *S ? S : NULL;
+}
 
 static int sr_cgroup(const proc_t* a, const proc_t* b)
 {
@@ -110,6 +136,9 @@ static int sr_cgroup(const proc_t* a, const proc_t* b)
 #define CMP_STR(NAME) \
 static int sr_ ## NAME(const proc_t* P, const proc_t* Q) { \
     return strcmp(P->NAME, Q->NAME); \
+} \
+static void key_ ## NAME(const proc_t* P, sort_key* K) { \
+    key_str(P->NAME, K); \
 }
 
 #define CMP_INT(NAME) \
@@ -117,6 +146,9 @@ static int sr_ ## NAME (const proc_t* P, const proc_t* Q) { \
     if (P->NAME < Q->NAME) return -1; \
     if (P->NAME > Q->NAME) return  1; \
     return 0; \
+} \
+static void key_ ## NAME (const proc_t* P, sort_key* K) { \
+    KEY_NUM(K, P->NAME); \
 }
 
 /* fast versions, for values which either:
@@ -126,10 +158,16 @@ static int sr_ ## NAME (const proc_t* P, const proc_t* Q) { \
 #define CMP_SMALL(NAME) \
 static int sr_ ## NAME (const proc_t* P, const proc_t* Q) { \
     return (int)(P->NAME) - (int)(Q->NAME); \
+} \
+static void key_ ## NAME (const proc_t* P, sort_key* K) { \
+    KEY_NUM(K, (int)(P->NAME)); \
 }
 #define CMP_SMALL2(NAME,WHAT) \
 static int sr_ ## NAME (const proc_t* P, const proc_t* Q) { \
     return (int)(P->WHAT) - (int)(Q->WHAT); \
+} \
+static void key_ ## NAME (const proc_t* P, sort_key* K) { \
+    KEY_NUM(K, (int)(P->WHAT)); \
 }
 
 #define cook_time(P) (P->utime + P->stime) / Hertz
@@ -144,6 +182,10 @@ static int sr_ ## NAME (const proc_t* P, const proc_t* Q) { \
     if (p_time < q_time) return -1; \
     if (p_time > q_time) return 1; \
     return 0; \
+} \
+static void key_ ## NAME (const proc_t* P, sort_key* K) { \
+    unsigned long p_time = cook_ ##NAME (P); \
+    KEY_NUM(K, p_time); \
 }
 
 #define CMP_NS(NAME, ID) \
@@ -151,6 +193,9 @@ static int sr_ ## NAME (const proc_t* P, const proc_t* Q) { \
     if ((unsigned long)P->ns[ID] < (unsigned long)Q->ns[ID]) return -1; \
     if ((unsigned long)P->ns[ID] > (unsigned long)Q->ns[ID]) return  1; \
     return 0; \
+} \
+static void key_ ## NAME (const proc_t* P, sort_key* K) { \
+    KEY_NUM(K, (unsigned long)P->ns[ID]); \
 }
 
 CMP_INT(rtprio)
@@ -248,8 +293,132 @@ static int sr_swapable(const proc_t* P, const proc_t* Q) {
   if (p_swapable > q_swapable) return  1;
   return 0;
 }
+static void key_swapable(const proc_t* P, sort_key* K) {
+  unsigned long p_swapable = P->vm_data + P->vm_stack;
+  KEY_NUM(K, p_swapable);
+}
+
+/* every sort function with a key, for search_key_array() */
+#define KEY(NAME) {sr_ ## NAME, key_ ## NAME}
+static const key_struct key_array[] = {
+KEY(nop), KEY(rtprio), KEY(sched), KEY(cutime), KEY(priority), KEY(nlwp),
+KEY(nice), KEY(rss), KEY(alarm), KEY(size), KEY(resident), KEY(share),
+KEY(trs), KEY(lrs), KEY(drs), KEY(dt), KEY(vm_size), KEY(vm_lock),
+KEY(vm_rss), KEY(vm_data), KEY(vm_stack), KEY(vm_exe), KEY(vm_lib),
+KEY(vsize), KEY(rss_rlim), KEY(flags), KEY(min_flt), KEY(maj_flt),
+KEY(cmin_flt), KEY(cmaj_flt), KEY(utime), KEY(stime), KEY(start_code),
+KEY(end_code), KEY(start_stack), KEY(kstk_esp), KEY(kstk_eip),
+KEY(start_time), KEY(wchan), KEY(ruser), KEY(euser), KEY(suser),
+KEY(fuser), KEY(rgroup), KEY(egroup), KEY(sgroup), KEY(fgroup), KEY(cmd),
+KEY(ruid), KEY(rgid), KEY(euid), KEY(egid), KEY(suid), KEY(sgid),
+KEY(fuid), KEY(fgid), KEY(procs), KEY(tasks), KEY(ppid), KEY(pgrp),
+KEY(session), KEY(tty), KEY(tpgid), KEY(pcpu), KEY(state), KEY(time),
+KEY(etime), KEY(ipcns), KEY(mntns), KEY(netns), KEY(pidns), KEY(userns),
+KEY(utsns), KEY(lxcname), KEY(cgname), KEY(swapable),
+{NULL, NULL}
+};
+#undef KEY
 
 
+/***************************************************************************/
+/************ Numbers, for the format functions, without printf ************/
+
+/* These print like printf's %u, %d, %2u and so on, but with no format to
+ * parse and no locale to consult.  Digits are made two at a time.  Each one
+ * ends the text with a '\0' and returns its length, like snprintf().
+ */
+static const char digit_pairs[] =
+  "00010203040506070809" "10111213141516171819" "20212223242526272829"
+  "30313233343536373839" "40414243444546474849" "50515253545556575859"
+  "60616263646566676869" "70717273747576777879" "80818283848586878889"
+  "90919293949596979899";
+
+static int put_num(char *restrict const dst, unsigned long long n, int neg, int width){
+  char tmp[24];
+  char *p = tmp + sizeof(tmp);
+  int len, pad;
+  while(n >= 100){
+    p -= 2;
+    memcpy(p, digit_pairs + 2 * (n % 100), 2);
+    n /= 100;
+  }
+  if(n >= 10){
+    p -= 2;
+    memcpy(p, digit_pairs + 2 * n, 2);
+  }else{
+    *--p = '0' + n;
+  }
+  if(neg) *--p = '-';
+  len = tmp + sizeof(tmp) - p;
+  pad = (width > len) ? width - len : 0;   /* with spaces, as %5u would */
+  memset(dst, ' ', pad);
+  memcpy(dst + pad, p, len);
+  dst[pad + len] = '\0';
+  return pad + len;
+}
+
+/* %u, %lu and %llu, given a value of the type printf would have used */
+static int put_u(char *restrict const dst, unsigned long long n){
+  return put_num(dst, n, 0, 0);
+}
+/* %5u and the like */
+static int put_uw(char *restrict const dst, unsigned long long n, int width){
+  return put_num(dst, n, 0, width);
+}
+/* %d and %ld */
+static int put_d(char *restrict const dst, long long n){
+  return put_num(dst, n < 0 ? -(unsigned long long)n : (unsigned long long)n, n < 0, 0);
+}
+/* %5ld and the like */
+static int put_dw(char *restrict const dst, long long n, int width){
+  return put_num(dst, n < 0 ? -(unsigned long long)n : (unsigned long long)n, n < 0, width);
+}
+/* %02u, for anything under 100 (no '\0', since more is sure to follow) */
+static int put_02(char *restrict const dst, unsigned n){
+  memcpy(dst, digit_pairs + 2 * n, 2);
+  return 2;
+}
+/* %x, or %0*x when given a width */
+static int put_x(char *restrict const dst, unsigned long long n, int width){
+  char tmp[16];
+  int len = 0, pad, i;
+  do{
+    tmp[len++] = "0123456789abcdef"[n & 0xf];
+    n >>= 4;
+  }while(n);
+  pad = (width > len) ? width - len : 0;
+  memset(dst, '0', pad);
+  for(i = 0; i < len; i++) dst[pad + i] = tmp[len - 1 - i];
+  dst[pad + len] = '\0';
+  return pad + len;
+}
+
+/* a duration: [dd-]hh:mm:ss, or [[dd-]hh:]mm:ss if hours aren't a must */
+static int put_dhms(char *restrict const dst, unsigned long t, int hours){
+  unsigned dd,hh,mm,ss;
+  char *cp = dst;
+  ss = t%60;
+  t /= 60;
+  mm = t%60;
+  t /= 60;
+  hh = t%24;
+  t /= 24;
+  dd = t;
+  if(dd){
+    cp += put_u(cp, dd);
+    *cp++ = '-';
+  }
+  if(dd || hh || hours){
+    cp += put_02(cp, hh);
+    *cp++ = ':';
+  }
+  cp += put_02(cp, mm);
+  *cp++ = ':';
+  cp += put_02(cp, ss);
+  *cp = '\0';
+  return (int)(cp-dst);
+}
+
 /***************************************************************************/
 /************ Lots of format functions, starting with the NOP **************/
 
@@ -481,27 +650,13 @@ static int pr_fname(char *restrict const outbuf, const proc_t *restrict const pp
 
 /* elapsed wall clock time, [[dd-]hh:]mm:ss format (not same as "time") */
 static int pr_etime(char *restrict const outbuf, const proc_t *restrict const pp){
-  unsigned long t;
-  unsigned dd,hh,mm,ss;
-  char *cp = outbuf;
-  t = cook_etime(pp);
-  ss = t%60;
-  t /= 60;
-  mm = t%60;
-  t /= 60;
-  hh = t%24;
-  t /= 24;
-  dd = t;
-  cp +=(     dd      ?  snprintf(cp, COLWID, "%u-", dd)           :  0 );
-  cp +=( (dd || hh)  ?  snprintf(cp, COLWID, "%02u:", hh)         :  0 );
-  cp +=                 snprintf(cp, COLWID, "%02u:%02u", mm, ss)       ;
-  return (int)(cp-outbuf);
+  return put_dhms(outbuf, cook_etime(pp), 0);
 }
 
 /* elapsed wall clock time in seconds */
 static int pr_etimes(char *restrict const outbuf, const proc_t *restrict const pp){
   unsigned t = cook_etime(pp);
-  return snprintf(outbuf, COLWID, "%u", t);
+  return put_u(outbuf, t);
 }
 
 /* "Processor utilisation for scheduling."  --- we use %cpu w/o fraction */
@@ -514,20 +669,25 @@ static int pr_c(char *restrict const outbuf, const proc_t *restrict const pp){
   seconds = cook_etime(pp);
   if(seconds) pcpu = (total_time * 100ULL / Hertz) / seconds;
   if (pcpu > 99U) pcpu = 99U;
-  return snprintf(outbuf, COLWID, "%2u", pcpu);
+  return put_uw(outbuf, pcpu, 2);
 }
 /* normal %CPU in ##.# format. */
 static int pr_pcpu(char *restrict const outbuf, const proc_t *restrict const pp){
   unsigned long long total_time;   /* jiffies used by this process */
   unsigned pcpu = 0;               /* scaled %cpu, 999 means 99.9% */
   unsigned long long seconds;      /* seconds of process life */
+  int len;
   total_time = pp->utime + pp->stime;
   if(include_dead_children) total_time += (pp->cutime + pp->cstime);
   seconds = cook_etime(pp);
   if(seconds) pcpu = (total_time * 1000ULL / Hertz) / seconds;
   if (pcpu > 999U)
-    return snprintf(outbuf, COLWID, "%u", pcpu/10U);
-  return snprintf(outbuf, COLWID, "%u.%u", pcpu/10U, pcpu%10U);
+    return put_u(outbuf, pcpu/10U);
+  len = put_u(outbuf, pcpu/10U);
+  outbuf[len++] = '.';
+  outbuf[len++] = '0' + pcpu%10U;
+  outbuf[len] = '\0';
+  return len;
 }
 /* this is a "per-mill" format, like %cpu with no decimal point */
 static int pr_cp(char *restrict const outbuf, const proc_t *restrict const pp){
@@ -539,33 +699,20 @@ static int pr_cp(char *restrict const outbuf, const proc_t *restrict const pp){
   seconds = cook_etime(pp);
   if(seconds) pcpu = (total_time * 1000ULL / Hertz) / seconds;
   if (pcpu > 999U) pcpu = 999U;
-  return snprintf(outbuf, COLWID, "%3u", pcpu);
+  return put_uw(outbuf, pcpu, 3);
 }
 
 static int pr_pgid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%u", pp->pgrp);
+  return put_u(outbuf, (unsigned)pp->pgrp);
 }
 static int pr_ppid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%u", pp->ppid);
+  return put_u(outbuf, (unsigned)pp->ppid);
 }
 
 
 /* cumulative CPU time, [dd-]hh:mm:ss format (not same as "etime") */
 static int pr_time(char *restrict const outbuf, const proc_t *restrict const pp){
-  unsigned long t;
-  unsigned dd,hh,mm,ss;
-  int c;
-  t = cook_time(pp);
-  ss = t%60;
-  t /= 60;
-  mm = t%60;
-  t /= 60;
-  hh = t%24;
-  t /= 24;
-  dd = t;
-  c  =( dd ? snprintf(outbuf, COLWID, "%u-", dd) : 0              );
-  c +=( snprintf(outbuf+c, COLWID, "%02u:%02u:%02u", hh, mm, ss)    );
-  return c;
+  return put_dhms(outbuf, cook_time(pp), 1);
 }
 
 /* HP-UX puts this (I forget, vsz or vsize?) in kB and uses "sz" for pages.
@@ -577,7 +724,7 @@ static int pr_time(char *restrict const outbuf, const proc_t *restrict const pp)
  * TODO: add flag for "1.23M" behavior, on this and other columns.
  */
 static int pr_vsz(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%lu", pp->vm_size);
+  return put_u(outbuf, pp->vm_size);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////
@@ -627,44 +774,44 @@ static int pr_vsz(char *restrict const outbuf, const proc_t *restrict const pp){
 // legal as UNIX "PRI"
 // "priority"         (was -20..20, now -100..39)
 static int pr_priority(char *restrict const outbuf, const proc_t *restrict const pp){    /* -20..20 */
-    return snprintf(outbuf, COLWID, "%ld", pp->priority);
+    return put_d(outbuf, pp->priority);
 }
 
 // legal as UNIX "PRI"
 // "intpri" and "opri" (was 39..79, now  -40..99)
 static int pr_opri(char *restrict const outbuf, const proc_t *restrict const pp){        /* 39..79 */
-    return snprintf(outbuf, COLWID, "%ld", 60 + pp->priority);
+    return put_d(outbuf, 60 + pp->priority);
 }
 
 // legal as UNIX "PRI"
 // "pri_foo"   --  match up w/ nice values of sleeping processes (-120..19)
 static int pr_pri_foo(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%ld", pp->priority - 20);
+    return put_d(outbuf, pp->priority - 20);
 }
 
 // legal as UNIX "PRI"
 // "pri_bar"   --  makes RT pri show as negative       (-99..40)
 static int pr_pri_bar(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%ld", pp->priority + 1);
+    return put_d(outbuf, pp->priority + 1);
 }
 
 // legal as UNIX "PRI"
 // "pri_baz"   --  the kernel's ->prio value, as of Linux 2.6.8     (1..140)
 static int pr_pri_baz(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%ld", pp->priority + 100);
+    return put_d(outbuf, pp->priority + 100);
 }
 
 
 // not legal as UNIX "PRI"
 // "pri"               (was 20..60, now    0..139)
 static int pr_pri(char *restrict const outbuf, const proc_t *restrict const pp){         /* 20..60 */
-    return snprintf(outbuf, COLWID, "%ld", 39 - pp->priority);
+    return put_d(outbuf, 39 - pp->priority);
 }
 
 // not legal as UNIX "PRI"
 // "pri_api"   --  match up w/ RT API    (-40..99)
 static int pr_pri_api(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%ld", -1 - pp->priority);
+    return put_d(outbuf, -1 - pp->priority);
 }
 
 // Linux applies nice value in the scheduling policies (classes)
@@ -673,7 +820,7 @@ static int pr_pri_api(char *restrict const outbuf, const proc_t *restrict const
 // policies (-1).
 static int pr_nice(char *restrict const outbuf, const proc_t *restrict const pp){
   if(pp->sched!=0 && pp->sched!=3 && pp->sched!=-1) return snprintf(outbuf, COLWID, "-");
-  return snprintf(outbuf, COLWID, "%ld", pp->nice);
+  return put_d(outbuf, pp->nice);
 }
 
 // HP-UX   "cls": RT RR RR2 ???? HPUX FIFO KERN
@@ -710,11 +857,11 @@ static int pr_class(char *restrict const outbuf, const proc_t *restrict const pp
 // We just print the priority, and have other keywords for type.
 static int pr_rtprio(char *restrict const outbuf, const proc_t *restrict const pp){
   if(pp->sched==0 || pp->sched==(unsigned long)-1) return snprintf(outbuf, COLWID, "-");
-  return snprintf(outbuf, COLWID, "%ld", pp->rtprio);
+  return put_d(outbuf, (long)pp->rtprio);
 }
 static int pr_sched(char *restrict const outbuf, const proc_t *restrict const pp){
   if(pp->sched==(unsigned long)-1) return snprintf(outbuf, COLWID, "-");
-  return snprintf(outbuf, COLWID, "%ld", pp->sched);
+  return put_d(outbuf, (long)pp->sched);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -738,7 +885,7 @@ static int pr_wchan(char *restrict const outbuf, const proc_t *restrict const pp
   const char *w;
   size_t len;
   if(!(pp->wchan & 0xffffff)) return memcpy(outbuf,"-",2),1;
-  if(wchan_is_number) return snprintf(outbuf, COLWID, "%x", (unsigned)(pp->wchan) & 0xffffffu);
+  if(wchan_is_number) return put_x(outbuf, (unsigned)(pp->wchan) & 0xffffffu, 0);
   w = lookup_wchan(pp->XXXID);
   len = strlen(w);
   if(len>max_rightward) len=max_rightward;
@@ -770,7 +917,7 @@ static int pr_wname(char *restrict const outbuf, const proc_t *restrict const pp
 
 static int pr_nwchan(char *restrict const outbuf, const proc_t *restrict const pp){
   if(!(pp->wchan & 0xffffff)) return memcpy(outbuf,"-",2),1;
-  return snprintf(outbuf, COLWID, "%x", (unsigned)(pp->wchan) & 0xffffffu);
+  return put_x(outbuf, (unsigned)(pp->wchan) & 0xffffffu, 0);
 }
 
 /* Terrible trunctuation, like BSD crap uses: I999 J999 K999 */
@@ -844,33 +991,43 @@ tsiz	text size (in Kbytes)
 ***/
 
 static int pr_stackp(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%0*lx", (int)(2*sizeof(long)), pp->start_stack);
+    return put_x(outbuf, pp->start_stack, 2*sizeof(long));
 }
 
 static int pr_esp(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%0*lx", (int)(2*sizeof(long)), pp->kstk_esp);
+    return put_x(outbuf, pp->kstk_esp, 2*sizeof(long));
 }
 
 static int pr_eip(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%0*lx", (int)(2*sizeof(long)), pp->kstk_eip);
+    return put_x(outbuf, pp->kstk_eip, 2*sizeof(long));
 }
 
 /* This function helps print old-style time formats */
 static int old_time_helper(char *dst, unsigned long long t, unsigned long long rel) {
+  int len;
   if(!t)            return snprintf(dst, COLWID, "    -");
   if(t == ~0ULL)    return snprintf(dst, COLWID, "   xx");
   if((long long)(t-=rel) < 0)  t=0ULL;
-  if(t>9999ULL)     return snprintf(dst, COLWID, "%5llu", t/100ULL);
-  else              return snprintf(dst, COLWID, "%2u.%02u", (unsigned)t/100U, (unsigned)t%100U);
+  if(t>9999ULL)     return put_uw(dst, t/100ULL, 5);
+  len = put_uw(dst, (unsigned)t/100U, 2);
+  dst[len++] = '.';
+  len += put_02(dst+len, (unsigned)t%100U);
+  dst[len] = '\0';
+  return len;
 }
 
 static int pr_bsdtime(char *restrict const outbuf, const proc_t *restrict const pp){
     unsigned long long t;
     unsigned u;
+    int len;
     t = pp->utime + pp->stime;
     if(include_dead_children) t += (pp->cutime + pp->cstime);
     u = t / Hertz;
-    return snprintf(outbuf, COLWID, "%3u:%02u", u/60U, u%60U);
+    len = put_uw(outbuf, u/60U, 3);
+    outbuf[len++] = ':';
+    len += put_02(outbuf+len, u%60U);
+    outbuf[len] = '\0';
+    return len;
 }
 
 static int pr_bsdstart(char *restrict const outbuf, const proc_t *restrict const pp){
@@ -891,7 +1048,7 @@ static int pr_alarm(char *restrict const outbuf, const proc_t *restrict const pp
 
 /* HP-UX puts this in pages and uses "vsz" for kB */
 static int pr_sz(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%lu", (pp->vm_size)/(page_size/1024));
+  return put_u(outbuf, (pp->vm_size)/(page_size/1024));
 }
 
 
@@ -914,51 +1071,51 @@ static int pr_sz(char *restrict const outbuf, const proc_t *restrict const pp){
 static int pr_dsiz(char *restrict const outbuf, const proc_t *restrict const pp){
     long dsiz = 0;
     if(pp->vsize) dsiz += (pp->vsize - pp->end_code + pp->start_code) >> 10;
-    return snprintf(outbuf, COLWID, "%ld", dsiz);
+    return put_d(outbuf, dsiz);
 }
 
 /* kB text (code) size. See trs, dsiz & drs. */
 static int pr_tsiz(char *restrict const outbuf, const proc_t *restrict const pp){
     long tsiz = 0;
     if(pp->vsize) tsiz += (pp->end_code - pp->start_code) >> 10;
-    return snprintf(outbuf, COLWID, "%ld", tsiz);
+    return put_d(outbuf, tsiz);
 }
 
 /* kB _resident_ data size. See dsiz, tsiz & trs. */
 static int pr_drs(char *restrict const outbuf, const proc_t *restrict const pp){
     long drs = 0;
     if(pp->vsize) drs += (pp->vsize - pp->end_code + pp->start_code) >> 10;
-    return snprintf(outbuf, COLWID, "%ld", drs);
+    return put_d(outbuf, drs);
 }
 
 /* kB text _resident_ (code) size. See tsiz, dsiz & drs. */
 static int pr_trs(char *restrict const outbuf, const proc_t *restrict const pp){
     long trs = 0;
     if(pp->vsize) trs += (pp->end_code - pp->start_code) >> 10;
-    return snprintf(outbuf, COLWID, "%ld", trs);
+    return put_d(outbuf, trs);
 }
 
 /* approximation to: kB of address space that could end up in swap */
 static int pr_swapable(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%ld", pp->vm_data + pp->vm_stack);
+  return put_d(outbuf, (long)(pp->vm_data + pp->vm_stack));
 }
 
 /* nasty old Debian thing */
 static int pr_size(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%ld", pp->size);
+  return put_d(outbuf, pp->size);
 }
 
 
 static int pr_minflt(char *restrict const outbuf, const proc_t *restrict const pp){
     long flt = pp->min_flt;
     if(include_dead_children) flt += pp->cmin_flt;
-    return snprintf(outbuf, COLWID, "%ld", flt);
+    return put_d(outbuf, flt);
 }
 
 static int pr_majflt(char *restrict const outbuf, const proc_t *restrict const pp){
     long flt = pp->maj_flt;
     if(include_dead_children) flt += pp->cmaj_flt;
-    return snprintf(outbuf, COLWID, "%ld", flt);
+    return put_d(outbuf, flt);
 }
 
 static int pr_lim(char *restrict const outbuf, const proc_t *restrict const pp){
@@ -968,12 +1125,12 @@ static int pr_lim(char *restrict const outbuf, const proc_t *restrict const pp){
       outbuf[2] = '\0';
       return 2;
     }
-    return snprintf(outbuf, COLWID, "%5ld", pp->rss_rlim >> 10);
+    return put_dw(outbuf, (long)(pp->rss_rlim >> 10), 5);
 }
 
 /* should print leading tilde ('~') if process is bound to the CPU */
 static int pr_psr(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->processor);
+  return put_d(outbuf, pp->processor);
 }
 
 static int pr_numa(char *restrict const outbuf, const proc_t *restrict const pp){
@@ -983,15 +1140,20 @@ static int pr_numa(char *restrict const outbuf, const proc_t *restrict const pp)
 }
 
 static int pr_rss(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%lu", pp->vm_rss);
+  return put_u(outbuf, pp->vm_rss);
 }
 
 /* pp->vm_rss * 1000 would overflow on 32-bit systems with 64 GB memory */
 static int pr_pmem(char *restrict const outbuf, const proc_t *restrict const pp){
   unsigned long pmem = 0;
+  int len;
   pmem = pp->vm_rss * 1000ULL / kb_main_total;
   if (pmem > 999) pmem = 999;
-  return snprintf(outbuf, COLWID, "%2u.%u", (unsigned)(pmem/10), (unsigned)(pmem%10));
+  len = put_uw(outbuf, (unsigned)(pmem/10), 2);
+  outbuf[len++] = '.';
+  outbuf[len++] = '0' + (unsigned)(pmem%10);
+  outbuf[len] = '\0';
+  return len;
 }
 
 static int pr_lstart(char *restrict const outbuf, const proc_t *restrict const pp){
@@ -1089,29 +1251,29 @@ static int pr_sigcatch(char *restrict const outbuf, const proc_t *restrict const
  */
 
 static int pr_egid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->egid);
+  return put_d(outbuf, pp->egid);
 }
 static int pr_rgid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->rgid);
+  return put_d(outbuf, pp->rgid);
 }
 static int pr_sgid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->sgid);
+  return put_d(outbuf, pp->sgid);
 }
 static int pr_fgid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->fgid);
+  return put_d(outbuf, pp->fgid);
 }
 
 static int pr_euid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->euid);
+  return put_d(outbuf, pp->euid);
 }
 static int pr_ruid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->ruid);
+  return put_d(outbuf, pp->ruid);
 }
 static int pr_suid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->suid);
+  return put_d(outbuf, pp->suid);
 }
 static int pr_fuid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->fuid);
+  return put_d(outbuf, pp->fuid);
 }
 
 // The Open Group Base Specifications Issue 6 (IEEE Std 1003.1, 2004 Edition)
@@ -1141,7 +1303,7 @@ static int do_pr_name(char *restrict const outbuf, const char *restrict const na
     outbuf[len] = 0;
     return len;
   }
-  return snprintf(outbuf, COLWID, "%u", u);
+  return put_u(outbuf, u);
 }
 
 static int pr_ruser(char *restrict const outbuf, const proc_t *restrict const pp){
@@ -1173,19 +1335,19 @@ static int pr_sgroup(char *restrict const outbuf, const proc_t *restrict const p
 
 // PID pid, TGID tgid
 static int pr_procs(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%u", pp->tgid);
+  return put_u(outbuf, (unsigned)pp->tgid);
 }
 // LWP lwp, SPID spid, TID tid
 static int pr_tasks(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%u", pp->tid);
+  return put_u(outbuf, (unsigned)pp->tid);
 }
 // thcount THCNT
 static int pr_nlwp(char *restrict const outbuf, const proc_t *restrict const pp){
-    return snprintf(outbuf, COLWID, "%d", pp->nlwp);
+    return put_d(outbuf, pp->nlwp);
 }
 
 static int pr_sess(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%u", pp->session);
+  return put_u(outbuf, (unsigned)pp->session);
 }
 
 static int pr_supgid(char *restrict const outbuf, const proc_t *restrict const pp){
@@ -1201,12 +1363,12 @@ static int pr_supgrp(char *restrict const outbuf, const proc_t *restrict const p
 }
 
 static int pr_tpgid(char *restrict const outbuf, const proc_t *restrict const pp){
-  return snprintf(outbuf, COLWID, "%d", pp->tpgid);
+  return put_d(outbuf, pp->tpgid);
 }
 
 /* SGI uses "cpu" to print the processor ID with header "P" */
 static int pr_sgi_p(char *restrict const outbuf, const proc_t *restrict const pp){          /* FIXME */
-  if(pp->state == 'R') return snprintf(outbuf, COLWID, "%d", pp->processor);
+  if(pp->state == 'R') return put_d(outbuf, pp->processor);
   return snprintf(outbuf, COLWID, "*");
 }
 
@@ -1243,7 +1405,7 @@ static int pr_sd_slice(char *restrict const outbuf, const proc_t *restrict const
 #define _pr_ns(NAME, ID)\
 static int pr_##NAME(char *restrict const outbuf, const proc_t *restrict const pp) {\
   if (pp->ns[ID])\
-    return snprintf(outbuf, COLWID, "%lu", (unsigned long)pp->ns[ID]);\
+    return put_u(outbuf, (unsigned long)pp->ns[ID]);\
   else\
     return snprintf(outbuf, COLWID, "-");\
 }
@@ -1869,6 +2031,15 @@ const shortsort_struct *search_shortsort_array(const int findme){
   return NULL;
 }
 
+const key_struct *search_key_array(int (*sr)(const proc_t* P, const proc_t* Q)){
+  const key_struct *walk = key_array;
+  while(walk->sr){
+    if(walk->sr == sr) return walk;
+    walk++;
+  }
+  return NULL;
+}
+
 const aix_struct *search_aix_array(const int findme){
   const aix_struct *walk = aix_array;
   while(walk->desc != '~'){
@@ -1946,6 +2117,42 @@ static void check_header_width(void){
 
 static char *saved_outbuf;
 
+#ifndef HAVE_FWRITE_UNLOCKED
+# define fwrite_unlocked fwrite
+#endif
+
+/* Rows are gathered here and written a batch at a time, not a column at a
+ * time.  A batch is as big as stdio's own buffer, or bigger, so it goes
+ * straight out with one write().  On a tty, each row is written as soon as
+ * it's whole.  What remains goes out at exit, ahead of close_stdout(), so
+ * that still sees any error.  Nothing else may be sent to stdout once
+ * the first row (the header) is out, as it would get ahead of what's still
+ * gathered here.  Neither is stderr kept in order with the rows, but then
+ * stdio never did that for a pipe or a file.
+ */
+#define ROWS_SIZE (64*1024)
+
+static char rows[ROWS_SIZE];
+static size_t rows_len;
+static int rows_tty;
+
+static void rows_flush(void){
+  if(rows_len) fwrite_unlocked(rows, rows_len, 1, stdout);
+  rows_len = 0;
+}
+
+static void rows_add(const char *restrict const s, const size_t len){
+  if(unlikely(rows_len + len > ROWS_SIZE)){
+    rows_flush();
+    if(len > ROWS_SIZE){   /* a very wide row */
+      fwrite_unlocked(s, len, 1, stdout);
+      return;
+    }
+  }
+  memcpy(rows + rows_len, s, len);
+  rows_len += len;
+}
+
 void show_one_proc(const proc_t *restrict const p, const format_node *restrict fmt){
   /* unknown: maybe set correct & actual to 1, remove +/- 1 below */
   int correct  = 0;  /* screen position we should be at */
@@ -2076,11 +2283,12 @@ void show_one_proc(const proc_t *restrict const p, const format_node *restrict f
     if(unlikely(!fmt->next)){
       /* Last column. Write padding + data + newline all together. */
       outbuf[sz] = '\n';
-      fwrite(outbuf-space, space+sz+1, 1, stdout);
+      rows_add(outbuf-space, space+sz+1);
+      if(rows_tty) rows_flush();
       break;
     }
     /* Not the last column. Write padding + data together. */
-    fwrite(outbuf-space, space+sz, 1, stdout);
+    rows_add(outbuf-space, space+sz);
     actual  += space+amount;
     correct += fmt->width;
     correct += legit;        /* adjust for SIGNAL expansion */
@@ -2136,6 +2344,9 @@ void init_output(void){
   saved_outbuf = outbuf + SPACE_AMOUNT;
   // available space:  page_size*outbuf_pages-SPACE_AMOUNT
 
+  rows_tty = isatty(STDOUT_FILENO);
+  atexit(rows_flush);  /* before close_stdout(), registered earlier */
+
   seconds_since_1970 = time(NULL);
 
   meminfo();
@@ -21,6 +21,7 @@
  * #define Print(fmt, args...) printf("Debug: " fmt, ## args)
  */
 
+#include <errno.h>
 #include <grp.h>
 #include <pwd.h>
 #include <stdio.h>
@@ -186,6 +187,7 @@ static const char *parse_list(const char *arg, const char *(*parse_fn)(char *, s
   node = malloc(sizeof(selection_node));
   node->u = malloc(strlen(arg)*sizeof(sel_union)); /* waste is insignificant */
   node->n = 0;
+  node->hash = NULL;
   buf = strdup(arg);
   /*** sanity check and count items ***/
   need_item = 1; /* true */
@@ -574,6 +576,7 @@ static const char *parse_bsd_option(void){
         node->u[0].tty = cached_tty;
         node->typecode = SEL_TTY;
         node->n = 1;
+        node->hash = NULL;
         node->next = selection_list;
         selection_list = node;
       }
@@ -711,6 +714,7 @@ static const char *parse_bsd_option(void){
         node->u[0].tty = cached_tty;
         node->typecode = SEL_TTY;
         node->n = 1;
+        node->hash = NULL;
         node->next = selection_list;
         selection_list = node;
         return NULL;
@@ -790,6 +794,7 @@ static const char *parse_gnu_option(void){
   static const gnu_table_struct gnu_table[] = {
   {"Group",         &&case_Group},       /* rgid */
   {"User",          &&case_User},        /* ruid */
+  {"cgroup",        &&case_cgroup},
   {"cols",          &&case_cols},
   {"columns",       &&case_columns},
   {"context",       &&case_context},
@@ -861,6 +866,23 @@ static const char *parse_gnu_option(void){
     if(err) return err;
     selection_list->typecode = SEL_RUID;
     return NULL;
+  case_cgroup:
+    trace("--cgroup\n");
+    arg = grab_gnu_arg();
+    if(!arg || !*arg) return _("cgroup directory must follow --cgroup");
+    switch(check_cgroup(arg)){
+    case 0:       break;
+    case EXDEV:   return _("cgroup directory must be within /sys/fs/cgroup");
+    default:      return _("cgroup directory has no readable cgroup.procs");
+    }
+    {
+      int n = 0;
+      if(cgroup_list) while(cgroup_list[n]) n++;
+      cgroup_list = xrealloc(cgroup_list, (n+2) * sizeof(char*));
+      cgroup_list[n] = (char *)arg;
+      cgroup_list[n+1] = NULL;
+    }
+    return NULL;
   case_cols:
   case_width:
   case_columns:
@@ -1033,14 +1055,17 @@ static const char *parse_trailing_pids(void){
   pidnode = malloc(sizeof(selection_node));
   pidnode->u = malloc(i*sizeof(sel_union)); /* waste is insignificant */
   pidnode->n = 0;
+  pidnode->hash = NULL;
 
   grpnode = malloc(sizeof(selection_node));
   grpnode->u = malloc(i*sizeof(sel_union)); /* waste is insignificant */
   grpnode->n = 0;
+  grpnode->hash = NULL;
 
   sidnode = malloc(sizeof(selection_node));
   sidnode->u = malloc(i*sizeof(sel_union)); /* waste is insignificant */
   sidnode->n = 0;
+  sidnode->hash = NULL;
 
   while(i--){
     char *data;
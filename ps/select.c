@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../proc/alloc.h"
 #include "../proc/procps.h"
 #include "../proc/readproc.h"
 
@@ -36,9 +37,102 @@
 
 static unsigned long select_bits = 0;
 
+/* Lists longer than this are looked up by hash, not scanned. */
+#define SEL_HASH_MIN 8
+
+/***** the value a list holds, as compared: all but comm are unsigned */
+static unsigned listed_value(const selection_node *sn, const sel_union *u){
+  switch(sn->typecode){
+  case SEL_RUID: case SEL_EUID: case SEL_SUID: case SEL_FUID:
+    return (unsigned)u->uid;
+  case SEL_RGID: case SEL_EGID: case SEL_SGID: case SEL_FGID:
+    return (unsigned)u->gid;
+  case SEL_PPID: return (unsigned)u->ppid;
+  case SEL_TTY:  return (unsigned)u->tty;
+  default:       return (unsigned)u->pid;
+  }
+}
+
+/***** and the process's value, for that same list */
+static unsigned proc_value(const selection_node *sn, const proc_t *buf){
+  switch(sn->typecode){
+  case SEL_RUID: return (unsigned)buf->ruid;
+  case SEL_EUID: return (unsigned)buf->euid;
+  case SEL_SUID: return (unsigned)buf->suid;
+  case SEL_FUID: return (unsigned)buf->fuid;
+  case SEL_RGID: return (unsigned)buf->rgid;
+  case SEL_EGID: return (unsigned)buf->egid;
+  case SEL_SGID: return (unsigned)buf->sgid;
+  case SEL_FGID: return (unsigned)buf->fgid;
+  case SEL_PGRP: return (unsigned)buf->pgrp;
+  case SEL_PPID: return (unsigned)buf->ppid;
+  case SEL_TTY:  return (unsigned)buf->tty;
+  case SEL_SESS: return (unsigned)buf->session;
+  default:       return (unsigned)buf->tgid;
+  }
+}
+
+/***** a command name hashes as strncmp() compares it: 15 bytes, or to the '\0' */
+static unsigned cmd_hash(const char *cmd){
+  unsigned h = 2166136261u;
+  int i;
+  for(i = 0; i < 15 && cmd[i]; i++){
+    h ^= (unsigned char)cmd[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/***** index a long list by hash, open addressed, at most half full */
+static void hash_list(selection_node *sn){
+  unsigned size = 16;
+  unsigned h;
+  int i;
+  if(sn->hash || sn->n <= SEL_HASH_MIN) return;
+  while(size < 2u * sn->n) size <<= 1;
+  sn->mask = size - 1;
+  sn->hash = xcalloc(size * sizeof(int));
+  for(i = 0; i < sn->n; i++){
+    if(sn->typecode == SEL_COMM) h = cmd_hash(sn->u[i].cmd);
+    else                         h = listed_value(sn, &sn->u[i]) * 2654435761u;
+    h &= sn->mask;
+    while(sn->hash[h]) h = (h + 1) & sn->mask;
+    sn->hash[h] = i + 1;
+  }
+}
+
+/***** is the process on a hashed list? */
+static int hash_match(const selection_node *sn, const proc_t *buf){
+  unsigned v, h;
+  int i;
+  if(sn->typecode == SEL_COMM){
+    h = cmd_hash(buf->cmd) & sn->mask;
+    while((i = sn->hash[h])){
+      if(!strncmp(buf->cmd, sn->u[i-1].cmd, 15)) return 1;
+      h = (h + 1) & sn->mask;
+    }
+    return 0;
+  }
+  v = proc_value(sn, buf);
+  h = (v * 2654435761u) & sn->mask;
+  while((i = sn->hash[h])){
+    if(listed_value(sn, &sn->u[i-1]) == v) return 1;
+    h = (h + 1) & sn->mask;
+  }
+  return 0;
+}
+
 /***** prepare select_bits for use */
 const char *select_bits_setup(void){
+  selection_node *sn;
   int switch_val = 0;
+  for(sn = selection_list; sn; sn = sn->next) hash_list(sn);
+  if(cgroup_list){
+    if(selection_list && selection_list->typecode == SEL_PID_QUICK)
+      return _("--cgroup conflicts with quick pid selection");
+    /* all by itself, --cgroup means everything within the cgroup(s) */
+    if(!selection_list && !simple_select) all_processes = 1;
+  }
   /* don't want a 'g' screwing up simple_select */
   if(!simple_select && !prefer_bsd_defaults){
     select_bits = 0xaa00; /* the STANDARD selection */
@@ -90,6 +184,11 @@ static int proc_was_listed(proc_t *buf){
   int i;
   if(!sn) return 0;
   while(sn){
+    if(sn->hash){
+      if(hash_match(sn, buf)) return 1;
+      sn = sn->next;
+      continue;
+    }
     switch(sn->typecode){
     default:
       catastrophic_failure(__FILE__, __LINE__, _("please report this bug"));
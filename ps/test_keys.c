@@ -0,0 +1,113 @@
+/*
+ * test_keys -- check ps's sort by keys against the sort functions
+ *
+ * With no arguments random process tables, whose numbers have few enough
+ * distinct values to tie often and whose strings share long prefixes, are
+ * sorted by random lists of columns, each forward or reversed.  They are
+ * sorted by sort_procs() and by qsort() with compare_two_procs(), with any
+ * ties left in their first order.  Any difference in the orders fails.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of display.c, just so its statics are within reach */
+#define main ps_main
+#include "display.c"
+#undef main
+
+#define FUZZ_ROUNDS 600
+#define FUZZ_PROCS  200
+
+static const char *columns[] = {
+  "pcpu", "rss", "vsz", "pid", "tid", "ppid", "pgid", "sid", "tpgid", "tty",
+  "user", "ruser", "group", "comm", "ni", "pri", "rtprio", "policy", "nlwp",
+  "stat", "time", "etime", "start_time", "uid", "gid", "maj_flt", "min_flt",
+  "wchan", "flags", "ipcns", "netns", "lxc", "cgname", "size", "_left",
+};
+#define COLUMNS (int)(sizeof(columns) / sizeof(columns[0]))
+
+static const char *names[] = {
+  "", "a", "root", "rootkit", "rootkit0", "rootkit01", "rootkit012",
+  "systemd-journal", "systemd-journald", "systemd-logind", "\xe9t\xe9",
+};
+#define NAMES (int)(sizeof(names) / sizeof(names[0]))
+
+/* numbers with few values, some negative when signed, none far apart */
+static void scramble(void *p, size_t len){
+  unsigned char *c = p;
+  static const unsigned char bytes[] = { 0, 0, 1, 3, 0xff };
+  while(len--) *c++ = bytes[rand() % 5];
+}
+
+static void table(proc_t *procs, const int n){
+  int i;
+  for(i = 0; i < n; i++){
+    proc_t *p = &procs[i];
+    scramble(p, sizeof(proc_t));
+    strcpy(p->euser, names[rand() % NAMES]);
+    strcpy(p->ruser, names[rand() % NAMES]);
+    strcpy(p->suser, names[rand() % NAMES]);
+    strcpy(p->fuser, names[rand() % NAMES]);
+    strcpy(p->egroup, names[rand() % NAMES]);
+    strcpy(p->rgroup, names[rand() % NAMES]);
+    strcpy(p->sgroup, names[rand() % NAMES]);
+    strcpy(p->fgroup, names[rand() % NAMES]);
+    strcpy(p->cmd, names[rand() % NAMES]);
+    p->lxcname = (char *)names[rand() % NAMES];
+    p->cgname = (char *)names[rand() % NAMES];
+    p->start_time %= 1000;   /* so etime is never negative */
+    processes[i] = p;
+  }
+}
+
+static void pick_columns(int count){
+  sort_node *node;
+  sort_list = NULL;
+  while(count--){
+    node = xmalloc(sizeof(sort_node));
+    node->sr = search_format_array(columns[rand() % COLUMNS])->sr;
+    node->reverse = rand() % 2;
+    node->next = sort_list;
+    sort_list = node;
+  }
+}
+
+/* compare_two_procs(), with ties left in the order of the table */
+static int compare_in_order(const void *a, const void *b){
+  int result = compare_two_procs(a, b);
+  if(result) return result;
+  return (*(proc_t *const*)a > *(proc_t *const*)b) - (*(proc_t *const*)a < *(proc_t *const*)b);
+}
+
+static int fuzz(void){
+  static proc_t procs[FUZZ_PROCS];
+  static proc_t *want[FUZZ_PROCS];
+  int r, n;
+  srand(1);
+  processes = xmalloc(FUZZ_PROCS * sizeof(proc_t *));
+  for(r = 0; r < FUZZ_ROUNDS; r++){
+    n = 1 + rand() % FUZZ_PROCS;
+    table(procs, n);
+    pick_columns(1 + rand() % 4);
+    memcpy(want, processes, n * sizeof(proc_t *));
+    qsort(want, n, sizeof(proc_t *), compare_in_order);
+    sort_procs(n);
+    if(memcmp(want, processes, n * sizeof(proc_t *))){
+      fprintf(stderr, "FAIL: round %d, %d processes\n", r, n);
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]){
+  return fuzz();
+}
@@ -0,0 +1,395 @@
+/*
+ * test_pr -- check that every ps column still prints byte for byte the same
+ *
+ * Random processes, with numbers of every size and sign, are printed by
+ * each print function in format_array, once as ps does by default and once
+ * with numeric users and wchans, dead children included and wide signals.
+ * A checksum of each column's text, and of the widths returned, must match
+ * the one below, taken before the columns had their own number formatters.
+ * The few columns depending on this system (the clock, wchan names, numa
+ * nodes and security contexts) are left out.  With -g the checksums are
+ * printed, in the form of the table below.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#include <stdlib.h>
+#include "../proc/alloc.h"
+
+/* all of output.c, just so its statics are within reach */
+#include "output.c"
+
+#define FUZZ_PROCS  5000
+
+char *myname = "test_pr";   /* as display.c would have it */
+
+static const struct {
+  const char *spec;
+  unsigned long long sum[2];
+} golden[] = {
+  {"%cpu",        {0xb9c967c70cb41584ULL, 0xfcd57346c17f8876ULL}},
+  {"%mem",        {0x26d55ca176e5c11cULL, 0x26d55ca176e5c11cULL}},
+  {"_left",       {0xc4f5095edb244b25ULL, 0xc4f5095edb244b25ULL}},
+  {"_left2",      {0xc4f5095edb244b25ULL, 0xc4f5095edb244b25ULL}},
+  {"_right",      {0x14ee6e8198431115ULL, 0x14ee6e8198431115ULL}},
+  {"_right2",     {0x14ee6e8198431115ULL, 0x14ee6e8198431115ULL}},
+  {"_unlimited",  {0xcf1b3e6968171b3dULL, 0xcf1b3e6968171b3dULL}},
+  {"_unlimited2", {0x2bd9b8dcb5a11e15ULL, 0x2bd9b8dcb5a11e15ULL}},
+  {"acflag",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"acflg",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"addr",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"addr_1",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"alarm",       {0x8f4829e44fe80d09ULL, 0x8f4829e44fe80d09ULL}},
+  {"argc",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"args",        {0x80657725f7bb2219ULL, 0x80657725f7bb2219ULL}},
+  {"atime",       {0x5f8a9318e7c92e71ULL, 0x5f8a9318e7c92e71ULL}},
+  {"blocked",     {0x214a9981f88e9155ULL, 0xeb6b13612cef5dedULL}},
+  {"bnd",         {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"bsdtime",     {0x7e025e431872a81cULL, 0xfca61189d1b301efULL}},
+  {"c",           {0xf7848aa25efa929bULL, 0xf7848aa25efa929bULL}},
+  {"caught",      {0xc59d6a55f1988a35ULL, 0xd2762f208260005dULL}},
+  {"cgname",      {0x622d880a5a293af5ULL, 0x622d880a5a293af5ULL}},
+  {"cgroup",      {0x9a60f2ca2c9f1385ULL, 0x9a60f2ca2c9f1385ULL}},
+  {"class",       {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"cls",         {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"cmaj_flt",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"cmd",         {0x80657725f7bb2219ULL, 0x80657725f7bb2219ULL}},
+  {"cmin_flt",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"cnswap",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"comm",        {0xec74d4d91a83c4acULL, 0xec74d4d91a83c4acULL}},
+  {"command",     {0x80657725f7bb2219ULL, 0x80657725f7bb2219ULL}},
+  {"cp",          {0x5e680033041b0efeULL, 0x5e680033041b0efeULL}},
+  {"cpu",         {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"cpuid",       {0xc08019a870799391ULL, 0xc08019a870799391ULL}},
+  {"cputime",     {0x5f8a9318e7c92e71ULL, 0x5f8a9318e7c92e71ULL}},
+  {"ctid",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"cursig",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"cutime",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"cwd",         {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"drs",         {0xd2b9fdc3858ce88eULL, 0xd2b9fdc3858ce88eULL}},
+  {"dsiz",        {0xd2b9fdc3858ce88eULL, 0xd2b9fdc3858ce88eULL}},
+  {"egid",        {0x606e493d31596f46ULL, 0x606e493d31596f46ULL}},
+  {"egroup",      {0x21bbff153a184457ULL, 0x0c3cd10818e06802ULL}},
+  {"eip",         {0x307a63f721ba51dfULL, 0x307a63f721ba51dfULL}},
+  {"emul",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"end_code",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"environ",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"esp",         {0xfcf3f365fbad6eddULL, 0xfcf3f365fbad6eddULL}},
+  {"etime",       {0xf3fae1b6af25d33aULL, 0xf3fae1b6af25d33aULL}},
+  {"etimes",      {0x2a1b7fc418dc6647ULL, 0x2a1b7fc418dc6647ULL}},
+  {"euid",        {0xe2e79b7ec6f27347ULL, 0xe2e79b7ec6f27347ULL}},
+  {"euser",       {0x25d62b94035c692bULL, 0xc6218272e83cb9dfULL}},
+  {"f",           {0x5d3afdfc31150addULL, 0x5d3afdfc31150addULL}},
+  {"fgid",        {0x0cc47854260b2341ULL, 0x0cc47854260b2341ULL}},
+  {"fgroup",      {0x0a0ad7d87e2208f9ULL, 0x329edb0ba765bfd0ULL}},
+  {"flag",        {0x5d3afdfc31150addULL, 0x5d3afdfc31150addULL}},
+  {"flags",       {0x5d3afdfc31150addULL, 0x5d3afdfc31150addULL}},
+  {"fname",       {0x3611b447a56a6530ULL, 0x3611b447a56a6530ULL}},
+  {"fsgid",       {0x0cc47854260b2341ULL, 0x0cc47854260b2341ULL}},
+  {"fsgroup",     {0x0a0ad7d87e2208f9ULL, 0x329edb0ba765bfd0ULL}},
+  {"fsuid",       {0x6b599cdeb6615c09ULL, 0x6b599cdeb6615c09ULL}},
+  {"fsuser",      {0x8701baf3478995f4ULL, 0x5c50fbdde7970ecdULL}},
+  {"fuid",        {0x6b599cdeb6615c09ULL, 0x6b599cdeb6615c09ULL}},
+  {"fuser",       {0x8701baf3478995f4ULL, 0x5c50fbdde7970ecdULL}},
+  {"gid",         {0x606e493d31596f46ULL, 0x606e493d31596f46ULL}},
+  {"group",       {0x21bbff153a184457ULL, 0x0c3cd10818e06802ULL}},
+  {"ignored",     {0x7e031c5b4e0274fdULL, 0x8864808187d28a2dULL}},
+  {"inblk",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"inblock",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"intpri",      {0x3120569b2b379016ULL, 0x3120569b2b379016ULL}},
+  {"ipcns",       {0x25a374cdd0bcb84eULL, 0x25a374cdd0bcb84eULL}},
+  {"jid",         {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"jobc",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"ktrace",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"ktracep",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"lastcpu",     {0xc08019a870799391ULL, 0xc08019a870799391ULL}},
+  {"lim",         {0x427865c3b55dfb73ULL, 0x427865c3b55dfb73ULL}},
+  {"login",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"logname",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"longtname",   {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"lsession",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"luid",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"luser",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"lwp",         {0xf54bcd9b9e8c7898ULL, 0xf54bcd9b9e8c7898ULL}},
+  {"lxc",         {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"m_drs",       {0xd2b9fdc3858ce88eULL, 0xd2b9fdc3858ce88eULL}},
+  {"m_dt",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"m_lrs",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"m_resident",  {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"m_share",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"m_size",      {0xccd668c1200538b7ULL, 0xccd668c1200538b7ULL}},
+  {"m_swap",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"m_trs",       {0x9e6105fdb2c0c4acULL, 0x9e6105fdb2c0c4acULL}},
+  {"machine",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"maj_flt",     {0x5d5d35315c287d66ULL, 0xf2412cc570bce2d2ULL}},
+  {"majflt",      {0x5d5d35315c287d66ULL, 0xf2412cc570bce2d2ULL}},
+  {"min_flt",     {0xc76a8265908fb874ULL, 0x77aae62edc7e2dcfULL}},
+  {"minflt",      {0xc76a8265908fb874ULL, 0x77aae62edc7e2dcfULL}},
+  {"mntns",       {0x7f12f37a461e61ddULL, 0x7f12f37a461e61ddULL}},
+  {"msgrcv",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"msgsnd",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"mwchan",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"netns",       {0x5a6fd43aaac3a0daULL, 0x5a6fd43aaac3a0daULL}},
+  {"ni",          {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"nice",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"nivcsw",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"nlwp",        {0xb0a43d1533a49e76ULL, 0xb0a43d1533a49e76ULL}},
+  {"nsignals",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"nsigs",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"nswap",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"nvcsw",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"nwchan",      {0xd1fa9c3d772a4428ULL, 0xd1fa9c3d772a4428ULL}},
+  {"opri",        {0x3120569b2b379016ULL, 0x3120569b2b379016ULL}},
+  {"osz",         {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"oublk",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"oublock",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"ouid",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"p_ru",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"paddr",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"pagein",      {0x5d5d35315c287d66ULL, 0xf2412cc570bce2d2ULL}},
+  {"pcpu",        {0xb9c967c70cb41584ULL, 0xfcd57346c17f8876ULL}},
+  {"pending",     {0x70fb6dc8ffc20845ULL, 0xa922ba55bca49045ULL}},
+  {"pgid",        {0x53a687dacd3c1cb9ULL, 0x53a687dacd3c1cb9ULL}},
+  {"pgrp",        {0x53a687dacd3c1cb9ULL, 0x53a687dacd3c1cb9ULL}},
+  {"pid",         {0x4433d2994c642322ULL, 0x4433d2994c642322ULL}},
+  {"pidns",       {0x0ce8101c188cdfc7ULL, 0x0ce8101c188cdfc7ULL}},
+  {"pmem",        {0x26d55ca176e5c11cULL, 0x26d55ca176e5c11cULL}},
+  {"poip",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"policy",      {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"ppid",        {0xe3f5f00f9404729bULL, 0xe3f5f00f9404729bULL}},
+  {"pri",         {0x3a0a68a6692d3a01ULL, 0x3a0a68a6692d3a01ULL}},
+  {"pri_api",     {0xd4ff9ad94f7b2bf8ULL, 0xd4ff9ad94f7b2bf8ULL}},
+  {"pri_bar",     {0x65a298f11cb20ae2ULL, 0x65a298f11cb20ae2ULL}},
+  {"pri_baz",     {0x273554a63f3a115aULL, 0x273554a63f3a115aULL}},
+  {"pri_foo",     {0xb7587000915e4057ULL, 0xb7587000915e4057ULL}},
+  {"priority",    {0xe17d57a0a6868f9dULL, 0xe17d57a0a6868f9dULL}},
+  {"prmgrp",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"prmid",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"project",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"projid",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"pset",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"psr",         {0xc08019a870799391ULL, 0xc08019a870799391ULL}},
+  {"psxpri",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"re",          {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"resident",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"rgid",        {0xd054fadfacd2b7bfULL, 0xd054fadfacd2b7bfULL}},
+  {"rgroup",      {0xf4a02be8832f24c4ULL, 0x088e626e9a90d1ceULL}},
+  {"rlink",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"rss",         {0xbce97068d41cd1c3ULL, 0xbce97068d41cd1c3ULL}},
+  {"rssize",      {0xbce97068d41cd1c3ULL, 0xbce97068d41cd1c3ULL}},
+  {"rsz",         {0xbce97068d41cd1c3ULL, 0xbce97068d41cd1c3ULL}},
+  {"rtprio",      {0x3c28ea0e87a334adULL, 0x3c28ea0e87a334adULL}},
+  {"ruid",        {0x74254f60786fa80eULL, 0x74254f60786fa80eULL}},
+  {"ruser",       {0xfc8d05d4a3467423ULL, 0x23ce8dc2db70d2daULL}},
+  {"s",           {0x9edf197c0e1a6ea7ULL, 0x9edf197c0e1a6ea7ULL}},
+  {"sched",       {0x451c24cbadc6f646ULL, 0x451c24cbadc6f646ULL}},
+  {"scnt",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"scount",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"seat",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"sess",        {0x1976abf5bd3afc66ULL, 0x1976abf5bd3afc66ULL}},
+  {"session",     {0x1976abf5bd3afc66ULL, 0x1976abf5bd3afc66ULL}},
+  {"sgi_p",       {0xfce81afc4f85705bULL, 0xfce81afc4f85705bULL}},
+  {"sgi_rss",     {0xbce97068d41cd1c3ULL, 0xbce97068d41cd1c3ULL}},
+  {"sgid",        {0xb930d91d68ce6ea5ULL, 0xb930d91d68ce6ea5ULL}},
+  {"sgroup",      {0x70b6fa4455f570bbULL, 0x64ba887070aab4c5ULL}},
+  {"share",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"sid",         {0x1976abf5bd3afc66ULL, 0x1976abf5bd3afc66ULL}},
+  {"sig",         {0x70fb6dc8ffc20845ULL, 0xa922ba55bca49045ULL}},
+  {"sig_block",   {0x214a9981f88e9155ULL, 0xeb6b13612cef5dedULL}},
+  {"sig_catch",   {0xc59d6a55f1988a35ULL, 0xd2762f208260005dULL}},
+  {"sig_ignore",  {0x7e031c5b4e0274fdULL, 0x8864808187d28a2dULL}},
+  {"sig_pend",    {0x70fb6dc8ffc20845ULL, 0xa922ba55bca49045ULL}},
+  {"sigcatch",    {0xc59d6a55f1988a35ULL, 0xd2762f208260005dULL}},
+  {"sigignore",   {0x7e031c5b4e0274fdULL, 0x8864808187d28a2dULL}},
+  {"sigmask",     {0x214a9981f88e9155ULL, 0xeb6b13612cef5dedULL}},
+  {"size",        {0x213a9beea47e051bULL, 0x213a9beea47e051bULL}},
+  {"sl",          {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"slice",       {0x622d880a5a293af5ULL, 0x622d880a5a293af5ULL}},
+  {"spid",        {0xf54bcd9b9e8c7898ULL, 0xf54bcd9b9e8c7898ULL}},
+  {"stackp",      {0x6e5975b40d7d5dd1ULL, 0x6e5975b40d7d5dd1ULL}},
+  {"start_code",  {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"start_stack", {0x6e5975b40d7d5dd1ULL, 0x6e5975b40d7d5dd1ULL}},
+  {"stat",        {0xebc57d53803bab32ULL, 0xebc57d53803bab32ULL}},
+  {"state",       {0x9edf197c0e1a6ea7ULL, 0x9edf197c0e1a6ea7ULL}},
+  {"status",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"suid",        {0x71c38f36106a3fc4ULL, 0x71c38f36106a3fc4ULL}},
+  {"supgid",      {0xbdf245b135fa09c5ULL, 0xbdf245b135fa09c5ULL}},
+  {"supgrp",      {0x01862d8ed743d9e5ULL, 0x01862d8ed743d9e5ULL}},
+  {"suser",       {0x44473298e37fc4e2ULL, 0x019eba60f809ad8fULL}},
+  {"svgid",       {0xb930d91d68ce6ea5ULL, 0xb930d91d68ce6ea5ULL}},
+  {"svgroup",     {0x70b6fa4455f570bbULL, 0x64ba887070aab4c5ULL}},
+  {"svuid",       {0x71c38f36106a3fc4ULL, 0x71c38f36106a3fc4ULL}},
+  {"svuser",      {0x44473298e37fc4e2ULL, 0x019eba60f809ad8fULL}},
+  {"systime",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"sz",          {0x955ddae08e474b9bULL, 0x955ddae08e474b9bULL}},
+  {"taskid",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"tdev",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"tgid",        {0x4433d2994c642322ULL, 0x4433d2994c642322ULL}},
+  {"thcount",     {0xb0a43d1533a49e76ULL, 0xb0a43d1533a49e76ULL}},
+  {"tid",         {0xf54bcd9b9e8c7898ULL, 0xf54bcd9b9e8c7898ULL}},
+  {"time",        {0x5f8a9318e7c92e71ULL, 0x5f8a9318e7c92e71ULL}},
+  {"timeout",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"tmout",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"tname",       {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"tpgid",       {0x51d62672203fb873ULL, 0x51d62672203fb873ULL}},
+  {"trs",         {0x9e6105fdb2c0c4acULL, 0x9e6105fdb2c0c4acULL}},
+  {"trss",        {0x9e6105fdb2c0c4acULL, 0x9e6105fdb2c0c4acULL}},
+  {"tsess",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"tsession",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"tsid",        {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"tsig",        {0x07ba6c206d634b5dULL, 0x5ad145cf30fef47dULL}},
+  {"tsiz",        {0x9e6105fdb2c0c4acULL, 0x9e6105fdb2c0c4acULL}},
+  {"tt",          {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"tty",         {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"tty4",        {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"tty8",        {0xc9567986f6551de5ULL, 0xc9567986f6551de5ULL}},
+  {"u_procp",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"ucmd",        {0xec74d4d91a83c4acULL, 0xec74d4d91a83c4acULL}},
+  {"ucomm",       {0xec74d4d91a83c4acULL, 0xec74d4d91a83c4acULL}},
+  {"uid",         {0xe2e79b7ec6f27347ULL, 0xe2e79b7ec6f27347ULL}},
+  {"uid_hack",    {0x25d62b94035c692bULL, 0xc6218272e83cb9dfULL}},
+  {"umask",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"uname",       {0x25d62b94035c692bULL, 0xc6218272e83cb9dfULL}},
+  {"unit",        {0x622d880a5a293af5ULL, 0x622d880a5a293af5ULL}},
+  {"upr",         {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"uprocp",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"user",        {0x25d62b94035c692bULL, 0xc6218272e83cb9dfULL}},
+  {"userns",      {0x16e64d626ddceb94ULL, 0x16e64d626ddceb94ULL}},
+  {"usertime",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"usrpri",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"util",        {0xf7848aa25efa929bULL, 0xf7848aa25efa929bULL}},
+  {"utime",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"utsns",       {0xb32575ab842a03d8ULL, 0xb32575ab842a03d8ULL}},
+  {"uunit",       {0x622d880a5a293af5ULL, 0x622d880a5a293af5ULL}},
+  {"vm_data",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"vm_exe",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"vm_lib",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"vm_lock",     {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"vm_stack",    {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"vsize",       {0xaae968dc397e7c4aULL, 0xaae968dc397e7c4aULL}},
+  {"vsz",         {0xaae968dc397e7c4aULL, 0xaae968dc397e7c4aULL}},
+  {"xstat",       {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"zoneid",      {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+  {"~",           {0x5b20b555c681d725ULL, 0x5b20b555c681d725ULL}},
+};
+#define GOLDEN (int)(sizeof(golden) / sizeof(golden[0]))
+
+static char *args[] = { "/usr/sbin/sshd", "-D", "-o", "a b\tc", NULL };
+static char *envs[] = { "HOME=/root", "TERM=xterm-256color", NULL };
+static char *cgrp[] = { "0::/system.slice/ssh.service", NULL };
+static const char *names[] = {
+  "", "a", "root", "systemd-network", "a-very-long-user-name", "\xe9t\xe9",
+};
+#define NAMES (int)(sizeof(names) / sizeof(names[0]))
+
+/* print functions whose output isn't up to the process alone */
+static int depends_on_system(int (*pr)(char *restrict const, const proc_t *restrict const)){
+  return pr == pr_wchan || pr == pr_wname || pr == pr_bsdstart || pr == pr_lstart
+      || pr == pr_stime || pr == pr_start || pr == pr_numa || pr == pr_context;
+}
+
+/* a number with some random bytes, sometimes all ones or a sign bit */
+static void scramble(void *p, size_t len){
+  unsigned char *c = p;
+  static const unsigned char bytes[] = { 0, 0, 0, 1, 9, 0x7f, 0x80, 0xff };
+  while(len--) *c++ = rand() % 3 ? bytes[rand() % 8] : rand();
+}
+
+static void random_proc(proc_t *p){
+  scramble(p, sizeof(proc_t));
+  /* all the strings are pointed at something, or are strings */
+  p->cmdline = args + rand() % 4;
+  p->environ = envs + rand() % 2;
+  p->cgroup = cgrp;
+  p->cgname = "ssh.service";
+  p->supgid = "4,24,27";
+  p->supgrp = "adm,cdrom,sudo";
+  p->sd_mach = p->sd_ouid = p->sd_seat = p->sd_sess = "-";
+  p->sd_slice = p->sd_unit = p->sd_uunit = "ssh.service";
+  p->lxcname = "-";
+  p->numa_nodes = "0:123 1:4";
+  strcpy(p->euser, names[rand() % NAMES]);
+  strcpy(p->ruser, names[rand() % NAMES]);
+  strcpy(p->suser, names[rand() % NAMES]);
+  strcpy(p->fuser, names[rand() % NAMES]);
+  strcpy(p->egroup, names[rand() % NAMES]);
+  strcpy(p->rgroup, names[rand() % NAMES]);
+  strcpy(p->sgroup, names[rand() % NAMES]);
+  strcpy(p->fgroup, names[rand() % NAMES]);
+  strcpy(p->cmd, names[rand() % NAMES]);
+  strcpy(p->signal, "0000000000000000");
+  strcpy(p->blocked, "fffffffe7ffbfeff");
+  strcpy(p->sigignore, "0000000000001000");
+  strcpy(p->sigcatch, "00000001800004ec");
+  strcpy(p->_sigpnd, "0000000000000100");
+  p->tty = 0;  /* others are looked up under /dev */
+}
+
+static unsigned long long fnv(unsigned long long h, const void *p, size_t len){
+  const unsigned char *c = p;
+  while(len--) h = (h ^ *c++) * 0x100000001b3ULL;
+  return h;
+}
+
+static void setup(int pass){
+  reset_global();
+  init_output();
+  Hertz = 100;
+  page_size = 4096;
+  kb_main_total = 8000000;
+  seconds_since_boot = 1234567;
+  seconds_since_1970 = 1700000000;
+  max_rightward = 40;
+  user_is_number = pass;
+  wchan_is_number = pass;
+  include_dead_children = pass;
+  wide_signals = pass;
+}
+
+int main(int argc, char *argv[]){
+  static unsigned long long sums[2][sizeof(format_array) / sizeof(format_struct)];
+  proc_t *procs;
+  int pass, f, i, g, len, bad = 0;
+
+  procs = xmalloc(FUZZ_PROCS * sizeof(proc_t));
+  srand(1);
+  for(i = 0; i < FUZZ_PROCS; i++)
+    random_proc(&procs[i]);
+  for(pass = 0; pass < 2; pass++){
+    setup(pass);
+    for(f = 0; f < format_array_count; f++){
+      unsigned long long h = 0xcbf29ce484222325ULL;
+      if(depends_on_system(format_array[f].pr)) continue;
+      for(i = 0; i < FUZZ_PROCS; i++){
+        len = format_array[f].pr(saved_outbuf, &procs[i]);
+        h = fnv(h, &len, sizeof(len));
+        h = fnv(h, saved_outbuf, strlen(saved_outbuf) + 1);
+      }
+      sums[pass][f] = h;
+    }
+  }
+  if(argc > 1 && !strcmp(argv[1], "-g")){
+    for(f = 0; f < format_array_count; f++)
+      if(!depends_on_system(format_array[f].pr))
+        printf("  {\"%s\",%*s{0x%016llxULL, 0x%016llxULL}},\n", format_array[f].spec
+          , (int)(12 - strlen(format_array[f].spec)), "", sums[0][f], sums[1][f]);
+    return EXIT_SUCCESS;
+  }
+  for(f = 0; f < format_array_count; f++){
+    if(depends_on_system(format_array[f].pr)) continue;
+    for(g = 0; g < GOLDEN && strcmp(golden[g].spec, format_array[f].spec); g++)
+      ;
+    if(g == GOLDEN || golden[g].sum[0] != sums[0][f] || golden[g].sum[1] != sums[1][f]){
+      fprintf(stderr, "FAIL: \"%s\" prints differently\n", format_array[f].spec);
+      bad = 1;
+    }
+  }
+  return bad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
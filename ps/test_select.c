@@ -0,0 +1,112 @@
+/*
+ * test_select -- check ps's hashed selection lists against a plain scan
+ *
+ * With no arguments random selection lists, of every type and of lengths
+ * on both sides of SEL_HASH_MIN, are matched against random processes,
+ * first by scanning the lists as ps always had and then again once the
+ * lists are hashed.  Values are few enough that most processes match some
+ * list and many lists hold repeats, and command names share long prefixes
+ * and run past the 15 bytes compared.  Any process matched by one way but
+ * not by the other fails.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of select.c, just so its statics are within reach */
+#include "select.c"
+
+#define FUZZ_ROUNDS 2000
+#define FUZZ_PROCS  200
+
+char *myname = "test_select";   /* as display.c would have it */
+
+static const int types[] = {
+  SEL_RUID, SEL_EUID, SEL_SUID, SEL_FUID, SEL_RGID, SEL_EGID, SEL_SGID,
+  SEL_FGID, SEL_PGRP, SEL_PID, SEL_PID_QUICK, SEL_PPID, SEL_TTY, SEL_SESS,
+  SEL_COMM,
+};
+#define TYPES (int)(sizeof(types) / sizeof(types[0]))
+
+static const char *names[] = {
+  "", "a", "bash", "bash-", "kworker/0:1", "kworker/0:1H-ev",
+  "kworker/0:1H-events", "kworker/0:1H-events_highpri", "systemd-journal",
+  "systemd-journald", "\xe9t\xe9",
+};
+#define NAMES (int)(sizeof(names) / sizeof(names[0]))
+
+/* numbers with few values, some of them wider than an int */
+static unsigned long long value(void){
+  static const unsigned long long v[] = {
+    0, 1, 2, 3, 100, 65534, 65535, 0xffffffffULL, 0x100000001ULL,
+  };
+  return rand() % 2 ? v[rand() % 9] : (unsigned long long)(rand() % 64);
+}
+
+static selection_node *list(void){
+  selection_node *sn = xmalloc(sizeof(selection_node));
+  int i;
+  sn->typecode = types[rand() % TYPES];
+  sn->n = 1 + rand() % (4 * SEL_HASH_MIN);
+  sn->u = xcalloc(sn->n * sizeof(sel_union));
+  sn->hash = NULL;
+  for(i = 0; i < sn->n; i++){
+    if(sn->typecode == SEL_COMM)     strncpy(sn->u[i].cmd, names[rand() % NAMES], 15);
+    else if(sn->typecode == SEL_TTY) sn->u[i].tty = value();
+    else                             sn->u[i].pid = value();
+  }
+  sn->next = selection_list;
+  return sn;
+}
+
+static void process(proc_t *p){
+  memset(p, 0, sizeof(proc_t));
+  p->ruid = value(); p->euid = value(); p->suid = value(); p->fuid = value();
+  p->rgid = value(); p->egid = value(); p->sgid = value(); p->fgid = value();
+  p->pgrp = value(); p->tgid = value(); p->ppid = value(); p->tty = value();
+  p->session = value();
+  strcpy(p->cmd, names[rand() % NAMES]);
+}
+
+static int fuzz(void){
+  static proc_t procs[FUZZ_PROCS];
+  static char want[FUZZ_PROCS];
+  selection_node *sn;
+  int r, i, lists;
+  srand(1);
+  for(r = 0; r < FUZZ_ROUNDS; r++){
+    selection_list = NULL;
+    lists = 1 + rand() % 3;
+    while(lists--) selection_list = list();
+    for(i = 0; i < FUZZ_PROCS; i++){
+      process(&procs[i]);
+      want[i] = proc_was_listed(&procs[i]);
+    }
+    for(sn = selection_list; sn; sn = sn->next) hash_list(sn);
+    for(i = 0; i < FUZZ_PROCS; i++){
+      if(proc_was_listed(&procs[i]) != want[i]){
+        fprintf(stderr, "FAIL: round %d, process %d\n", r, i);
+        return EXIT_FAILURE;
+      }
+    }
+    while(selection_list){
+      sn = selection_list;
+      selection_list = sn->next;
+      free(sn->u);
+      free(sn->hash);
+      free(sn);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]){
+  return fuzz();
+}
@@ -0,0 +1,147 @@
+/*
+ * test_tree -- check ps's forest against the nested scans it replaced
+ *
+ * With no arguments random process tables, where parents come before their
+ * children, some parents are not listed, pid 1 has children and a few tids
+ * show up twice, are sorted as for a forest and shown by show_forest() and
+ * by a private copy of the old code, in both the 'b' and 'u' styles (only
+ * the first shows the children pid 1 adopted level with it).  Any
+ * difference in the order of the rows or in their prefixes fails.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of display.c, with each row logged rather than printed */
+#define main ps_main
+#define show_one_proc log_one_proc
+#include "display.c"
+#undef main
+#undef show_one_proc
+
+#define FUZZ_ROUNDS 2000
+#define FUZZ_PROCS  400
+
+static char *log_at;
+
+void log_one_proc(const proc_t *restrict const p, const format_node *restrict fmt){
+  (void)fmt;
+  if(!log_at) return;
+  log_at += sprintf(log_at, "%d %s\n", p->XXXID, forest_prefix);
+}
+
+/* show_tree() and show_forest() of old, as the reference */
+static void ref_tree(const int self, const int n, const int level, const int have_sibling){
+  int i = 0;
+  if(level){
+    if(have_sibling) forest_prefix[level-1] = '+';
+    else             forest_prefix[level-1] = 'L';
+    forest_prefix[level] = '\0';
+  }
+  log_one_proc(processes[self],format_list);
+  for(;;){
+    if(i >= n) return;
+    if(processes[i]->ppid == processes[self]->XXXID) break;
+    i++;
+  }
+  if(level){
+    if(have_sibling) forest_prefix[level-1] = '|';
+    else             forest_prefix[level-1] = ' ';
+    forest_prefix[level] = '\0';
+  }
+  for(;;){
+    int self_pid;
+    int more_children = 1;
+    if(i >= n) break;
+    self_pid=processes[self]->XXXID;
+    if(i+1 >= n)
+      more_children = 0;
+    else
+      if(processes[i+1]->ppid != self_pid) more_children = 0;
+    if(self_pid==1 && ADOPTED(processes[i]) && forest_type!='u')
+      ref_tree(i++, n, level,   more_children);
+    else
+      ref_tree(i++, n, level+1, more_children);
+    if(!more_children) break;
+  }
+  forest_prefix[level] = '\0';
+}
+
+static void ref_forest(const int n){
+  int i = n;
+  int j;
+  while(i--){
+    j = n;
+    while(j--){
+      if(processes[j]->XXXID == processes[i]->ppid) goto not_root;
+    }
+    ref_tree(i,n,0,0);
+not_root:
+    ;
+  }
+}
+
+static int by_ppid(const void *a, const void *b){
+  const proc_t *p = *(proc_t *const *)a, *q = *(proc_t *const *)b;
+  if(p->ppid != q->ppid) return p->ppid < q->ppid ? -1 : 1;
+  if(p->start_time != q->start_time) return p->start_time < q->start_time ? -1 : 1;
+  return 0;
+}
+
+/* a table much like /proc, with parents started before their children */
+static void table(proc_t *procs, const int n, const int fuzz){
+  int i, pid = 1;
+  for(i = 0; i < n; i++){
+    memset(&procs[i], 0, sizeof(proc_t));
+    procs[i].start_time = i;
+    if(fuzz && i > 2 && !(rand() % 50)){
+      /* now and then a tid listed twice, with the same parent */
+      procs[i].XXXID = procs[i-1].XXXID;
+      procs[i].ppid = procs[i-1].ppid;
+    }else{
+      procs[i].XXXID = pid;
+      if(pid == 1)                procs[i].ppid = 0;
+      else if(!(rand() % 20))     procs[i].ppid = 100000 + rand() % 5;  /* not listed */
+      else if(!(rand() % 4))      procs[i].ppid = 1;
+      else                        procs[i].ppid = procs[rand() % i].XXXID;
+      pid += fuzz ? 1 + rand() % 3 : 1;
+    }
+    processes[i] = &procs[i];
+  }
+  qsort(processes, n, sizeof(proc_t *), by_ppid);
+}
+
+static int fuzz(void){
+  static proc_t procs[FUZZ_PROCS];
+  static char want[FUZZ_PROCS * 64], got[FUZZ_PROCS * 64];
+  int r, n;
+  srand(1);
+  for(r = 0; r < FUZZ_ROUNDS; r++){
+    n = 1 + rand() % FUZZ_PROCS;
+    table(procs, n, 1);
+    forest_type = r % 2 ? 'u' : 'b';
+    log_at = want;
+    ref_forest(n);
+    log_at = got;
+    show_forest(n);
+    free(forest_hash);
+    free(first_child);
+    if(strcmp(want, got)){
+      fprintf(stderr, "FAIL: round %d, %d processes, forest_type '%c'\n", r, n, forest_type);
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]){
+  processes = xcalloc(FUZZ_PROCS * sizeof(proc_t *));
+  return fuzz();
+}
@@ -0,0 +1,144 @@
+/*
+ * test_forest -- check top's forest view against the original full scans
+ *
+ * With no arguments random task tables, complete with threads, orphans,
+ * reused pids, duplicate tids and nests deeper than the 100 level limit,
+ * are arranged by top's forest_create() and by a private copy of the
+ * original recursive implementation.  Any difference in the order or the
+ * nesting levels fails.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of top, just so its statics are within reach */
+#define main top_main
+#include "top.c"
+#undef main
+
+#define FUZZ_ROUNDS 500
+
+/* the forest_adds() of old, kept verbatim (but for names) as the reference */
+static proc_t **Ref_ppt;
+static int      Ref_idx;
+
+static void ref_adds (const int self, int level) {
+   int i;
+
+   if (Ref_idx < Frame_maxtask) {          // immunize against insanity
+      if (level > 100) level = 101;         // our arbitrary nests limit
+      Ref_ppt[Ref_idx] = Seed_ppt[self];    // add this as root or child
+      Ref_ppt[Ref_idx++]->pad_3 = level;    // borrow 1 byte, 127 levels
+#ifdef TREE_SCANALL
+      for (i = 0; i < Frame_maxtask; i++) {
+         if (i == self) continue;
+#else
+      for (i = self + 1; i < Frame_maxtask; i++) {
+#endif
+         if (Seed_ppt[self]->tid == Seed_ppt[i]->tgid
+         || (Seed_ppt[self]->tid == Seed_ppt[i]->ppid && Seed_ppt[i]->tid == Seed_ppt[i]->tgid))
+            ref_adds(i, level + 1);      // got one child any others?
+      }
+   }
+}
+
+static void ref_create (proc_t **ppt) {
+   int i;
+
+   Seed_ppt = ppt;
+   Ref_idx = 0;
+#ifndef TREE_SCANALL
+   qsort(Seed_ppt, Frame_maxtask, sizeof(proc_t*), (QFP_t)forest_based);
+#endif
+   for (i = 0; i < Frame_maxtask; i++)
+      if (!Seed_ppt[i]->pad_3)
+         ref_adds(i, 0);
+   memcpy(Seed_ppt, Ref_ppt, sizeof(proc_t*) * Frame_maxtask);
+}
+
+static proc_t *Tasks;
+
+/* fill in a table of n tasks, as processes with a few threads each */
+static void make_tasks (int n, int deep) {
+   int i, j, pid = 1, nproc = 0;
+
+   for (i = 0; i < n; ) {
+      proc_t *p = &Tasks[i++];
+
+      memset(p, 0, sizeof(*p));
+      p->tid = p->tgid = pid++;
+      if (deep)                             // one long chain
+         p->ppid = nproc ? Tasks[i - 2].tgid : 0;
+      else if (nproc && rand() % 8)         // some parent so far
+         p->ppid = Tasks[rand() % (i - 1)].tgid;
+      else                                  // a parent we can't see
+         p->ppid = rand() % 3 ? 0 : pid + rand() % 100;
+      p->start_time = deep ? i : rand() % (n / 2 + 1);
+      if (!(rand() % 50))                   // a reused pid
+         p->tid = p->tgid = rand() % pid + 1;
+      nproc++;
+      for (j = deep ? 0 : rand() % 4; j > 0 && i < n; j--) {
+         proc_t *t = &Tasks[i++];
+         memset(t, 0, sizeof(*t));
+         t->tid = pid++;
+         t->tgid = p->tgid;
+         t->ppid = p->ppid;
+         t->start_time = p->start_time + rand() % 3;
+         if (!(rand() % 20))                // its leader is hidden from us
+            t->tgid = pid + 100;
+      }
+   }
+}
+
+/* arrange the table both ways, returning the index of any difference */
+static int compare (int n) {
+   static proc_t **a, **b;
+   static char *lvl;
+   WIN_t w;
+   int i;
+
+   a = realloc(a, sizeof(proc_t*) * n);
+   b = realloc(b, sizeof(proc_t*) * n);
+   lvl = realloc(lvl, n);
+   Ref_ppt = realloc(Ref_ppt, sizeof(proc_t*) * n);
+   for (i = 0; i < n; i++)
+      a[i] = b[i] = &Tasks[i];
+   Frame_maxtask = n;
+
+   ref_create(a);
+   // a task may be listed twice, given duplicate tids
+   for (i = 0; i < n; i++)
+      lvl[i] = a[i]->pad_3;
+   for (i = 0; i < n; i++)
+      a[i]->pad_3 = 0;
+   w.ppt = b;
+   Tree_idx = 0;
+   forest_create(&w);
+   for (i = 0; i < n; i++)
+      if (a[i] != b[i] || lvl[i] != b[i]->pad_3)
+         return i;
+   return -1;
+}
+
+int main (int argc, char **argv) {
+   int round, n, bad;
+
+   srand(1);
+   Tasks = calloc(2000, sizeof(proc_t));
+   for (round = 0; round < FUZZ_ROUNDS; round++) {
+      n = 1 + rand() % 2000;
+      make_tasks(n, round % 50 == 0);
+      if ((bad = compare(n)) >= 0) {
+         fprintf(stderr, "round %d, %d tasks: differ at %d\n", round, n, bad);
+         return EXIT_FAILURE;
+      }
+   }
+   return EXIT_SUCCESS;
+}
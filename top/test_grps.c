@@ -0,0 +1,160 @@
+/*
+ * test_grps -- check top's task groups, the totals of tasks by cgroup
+ *
+ * With no arguments a table of tasks evolves over many frames, with tasks
+ * exiting, new ones arriving and each task in one of many cgroups (and lxc
+ * containers), some of which are used for a while and then abandoned.
+ * Each frame is handed to procs_hlp(), sometimes as threads, and both
+ * bases' groups are checked against totals found by a simple search of
+ * the frame: one group for each name, with its first task's pid and the
+ * sums of its tasks' %CPU tics, memory (once per process) and faults.
+ * Groups abandoned for long enough must also have been let go.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of top, just so its statics are within reach */
+#define main top_main
+#include "top.c"
+#undef main
+
+#define FUZZ_FRAMES 200
+#define FUZZ_TASKS  3000
+#define FUZZ_NAMES  400
+
+static proc_t *Tasks;
+static int     Ntasks, Next_pid;
+static char   *Names[FUZZ_NAMES + 1], *Vecs[FUZZ_NAMES][2];
+static int     Last_used[FUZZ_NAMES];
+
+static void names (int n) {
+   char buf[SMLBUFSIZ];
+   int i;
+
+   for (i = 0; i < n; i++) {
+      snprintf(buf, sizeof(buf), "0::/system.slice/unit-%d.service", i);
+      Names[i] = Vecs[i][0] = strdup(buf);
+   }
+}
+
+/* a task, in some cgroup and container -- though, as time goes by, the
+   lower numbered cgroups are abandoned, as are the containers now and then */
+static void born (proc_t *p, int frame) {
+   int n = frame / 4 + rand() % (FUZZ_NAMES / 2);
+
+   memset(p, 0, sizeof(*p));
+   p->tid = p->tgid = ++Next_pid;
+   // some tasks are another's threads (which then must follow it)
+   if (Ntasks && !(rand() % 4) && Tasks[Ntasks - 1].tgid == Tasks[Ntasks - 1].tid) {
+      p->tgid = Tasks[Ntasks - 1].tgid;
+      p->cgroup = Tasks[Ntasks - 1].cgroup;
+   } else
+      p->cgroup = rand() % 20 ? Vecs[n % FUZZ_NAMES] : NULL;
+   p->lxcname = frame / 50 % 2 && rand() % 3 ? Names[rand() % 5] : "-";
+   p->start_time = frame;
+   p->utime = rand() % 1000;
+   p->min_flt = rand() % 1000;
+   p->resident = rand() % 5000;
+   p->vm_swap = rand() % 3000;
+   p->nlwp = 1 + rand() % 4;
+   p->state = "RSDTZ"[rand() % 5];
+}
+
+/* on to the next frame, where some tasks exit, some are born and the rest
+   age a little (or not at all) */
+static void evolve (int frame) {
+   int i, n;
+
+   for (i = n = 0; i < Ntasks; i++) {
+      if (!(rand() % 20)) continue;
+      Tasks[n] = Tasks[i];
+      Tasks[n].utime += rand() % 3 ? rand() % 50 : 0;
+      Tasks[n].min_flt += rand() % 100;
+      Tasks[n].resident += rand() % 10;
+      n++;
+   }
+   Ntasks = n;
+   while (Ntasks < FUZZ_TASKS && rand() % 8)
+      born(&Tasks[Ntasks++], frame);
+}
+
+/* what a group should hold, found by a simple search of the frame */
+static int check (int b, const proc_t *g, const proc_t *work) {
+   const char *name = g->cmdline[0];
+   unsigned long tics = 0, min = 0, res = 0, swp = 0;
+   int i, first = -1, thds = 0;
+
+   for (i = 0; i < Ntasks; i++) {
+      const char *n = b ? work[i].lxcname : work[i].cgroup ? work[i].cgroup[0] : "-";
+      if (strcmp(n, name)) continue;
+      if (first < 0) first = i;
+      tics += work[i].pcpu;
+      min += work[i].min_delta;
+      thds += Thread_mode ? 1 : work[i].nlwp;
+      if (Thread_mode && work[i].tid != work[i].tgid) continue;
+      res += work[i].resident;
+      swp += work[i].vm_swap;
+   }
+   return first >= 0 && g->tid == work[first].tid && g->pcpu == tics
+      && g->min_delta == min && g->resident == (long)res && g->vm_swap == swp
+      && g->nlwp == thds && g->pad_2 && g->hist_slot == -1;
+}
+
+static int fuzz (void) {
+   static proc_t work[FUZZ_TASKS];
+   static proc_t *ppt[FUZZ_TASKS];
+   static char seen[FUZZ_NAMES + 1];
+   int frame, b, i, n, want;
+
+   Frames_grpflags = Show_GROUPS;
+   Tasks = calloc(FUZZ_TASKS, sizeof(proc_t));
+   for (frame = 0; frame < FUZZ_FRAMES; frame++) {
+      evolve(frame);
+      Thread_mode = frame % 7 < 2;
+      memcpy(work, Tasks, sizeof(proc_t) * Ntasks);
+      procs_hlp(NULL);
+      for (i = 0; i < Ntasks; i++)
+         procs_hlp(&work[i]);
+      for (b = 0; b < GRP_BASES; b++) {
+         // just one group for each name, with all of that name's totals
+         memset(seen, 0, sizeof(seen));
+         for (i = want = 0; i < Ntasks; i++) {
+            const char *name = b ? work[i].lxcname : work[i].cgroup ? work[i].cgroup[0] : "-";
+            int x;
+            for (x = 0; x < FUZZ_NAMES && strcmp(name, Names[x]); x++) ;
+            if (!seen[x]++) want++;
+            if (!b && x < FUZZ_NAMES) Last_used[x] = frame;
+         }
+         n = groups_ppt(b, ppt);
+         if (n != want)
+            return fprintf(stderr, "frame %d: %d groups, not %d\n", frame, n, want), 0;
+         for (i = 0; i < n; i++)
+            if (!check(b, ppt[i], work))
+               return fprintf(stderr, "frame %d: group %s, wrong totals\n", frame, ppt[i]->cmdline[0]), 0;
+      }
+      // and those cgroups long abandoned are gone
+      for (i = 0; i < Grps[0].used; i++) {
+         const char *name = Grps[0].tab[i]->name;
+         int x;
+         for (x = 0; x < FUZZ_NAMES && strcmp(name, Names[x]); x++) ;
+         if (x < FUZZ_NAMES && frame - Last_used[x] > GRP_STALE)
+            return fprintf(stderr, "frame %d: group %s kept\n", frame, name), 0;
+      }
+   }
+   return 1;
+}
+
+int main (int argc, char **argv) {
+   srand(1);
+   names(FUZZ_NAMES);
+   Names[FUZZ_NAMES] = "-";
+   return fuzz() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+/*
+ * test_hist -- check top's history table, which yields the %CPU deltas
+ *
+ * With no arguments a table of tasks evolves over many frames, with tasks
+ * exiting, new ones arriving and some pids being reused (with a later start
+ * time).  Each frame is handed to procs_hlp() and every task's elapsed tics
+ * and fault counts are checked against those found by a simple search of
+ * the prior frame.  Each task's history ring slot must be its own, holding
+ * one sample for every frame it has lived through (up to HRING_len), while
+ * the slots of tasks that exit are reused.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of top, just so its statics are within reach */
+#define main top_main
+#include "top.c"
+#undef main
+
+#define FUZZ_FRAMES 300
+#define FUZZ_TASKS  3000
+
+static proc_t *Tasks, *Prior;
+static int     Ntasks, Nprior, Next_pid;
+
+/* a new task, perhaps reusing the pid of one that's gone */
+static void born (proc_t *p, int frame, int live) {
+   int i, pid = 0;
+
+   if (Next_pid > 100 && !(rand() % 10)) {
+      pid = 1 + rand() % Next_pid;
+      for (i = 0; i < live; i++)
+         if (Tasks[i].tid == pid) pid = 0;
+   }
+   memset(p, 0, sizeof(*p));
+   p->tid = p->tgid = pid ? pid : ++Next_pid;
+   p->start_time = frame;
+   p->utime = rand() % 1000;
+   p->stime = rand() % 1000;
+   p->min_flt = rand() % 1000;
+   p->maj_flt = rand() % 10;
+   p->state = "RSDTZ"[rand() % 5];
+   // (and the frames it's lived through are counted in an unused field)
+   p->pgrp = 0;
+}
+
+/* on to the next frame, where some tasks exit, some are born and the rest
+   age a little (or not at all) */
+static void evolve (int frame, int max) {
+   int i, n;
+
+   memcpy(Prior, Tasks, sizeof(proc_t) * Ntasks);
+   Nprior = Ntasks;
+   for (i = n = 0; i < Ntasks; i++) {
+      if (!(rand() % 20)) continue;
+      Tasks[n] = Prior[i];
+      Tasks[n].utime += rand() % 3 ? rand() % 50 : 0;
+      Tasks[n].stime += rand() % 2 ? rand() % 20 : 0;
+      Tasks[n].min_flt += rand() % 100;
+      Tasks[n].pgrp++;
+      n++;
+   }
+   for (; n < max && rand() % 8; n++)
+      born(&Tasks[n], frame, n);
+   Ntasks = n;
+}
+
+/* what procs_hlp should have made of a task */
+static int check (const proc_t *p, const proc_t *orig) {
+   TIC_t tics = orig->utime + orig->stime;
+   unsigned long min = 0;
+   int i;
+
+   for (i = 0; i < Nprior; i++)
+      if (Prior[i].tid == orig->tid && Prior[i].start_time == orig->start_time) {
+         tics -= Prior[i].utime + Prior[i].stime;
+         min = orig->min_flt - Prior[i].min_flt;
+         break;
+      }
+   return p->pcpu == (unsigned)tics && p->min_delta == min;
+}
+
+/* what the history ring should hold, with every slot a task's own */
+static int ring (const proc_t *work) {
+   static char *taken;
+   int i, s, want;
+
+   taken = realloc(taken, Hring_used + 1);
+   memset(taken, 0, Hring_used + 1);
+   for (i = 0; i < Ntasks; i++) {
+      s = work[i].hist_slot;
+      want = Tasks[i].pgrp < HRING_len ? Tasks[i].pgrp : HRING_len;
+      if (s < 0 || s >= Hring_used || taken[s]++ || Hring_cnt[s] != want)
+         return 0;
+   }
+   // with the slots of tasks which exit freed (at the next frame)
+   return Hring_used - Hring_nfree <= Ntasks + Nprior;
+}
+
+static int fuzz (void) {
+   static proc_t work[FUZZ_TASKS];
+   int frame, i;
+
+   Frames_libflags = L_RING;
+   Tasks = calloc(FUZZ_TASKS, sizeof(proc_t));
+   Prior = calloc(FUZZ_TASKS, sizeof(proc_t));
+   for (frame = 0; frame < FUZZ_FRAMES; frame++) {
+      // now and then the table is much smaller, or much larger
+      evolve(frame, frame % 50 < 25 ? FUZZ_TASKS : FUZZ_TASKS / 10);
+      memcpy(work, Tasks, sizeof(proc_t) * Ntasks);
+      procs_hlp(NULL);
+      for (i = 0; i < Ntasks; i++)
+         procs_hlp(&work[i]);
+      if (Frame_maxtask != Ntasks)
+         return fprintf(stderr, "frame %d: %d tasks, not %d\n", frame, Frame_maxtask, Ntasks), 0;
+      for (i = 0; i < Ntasks; i++)
+         if (!check(&work[i], &Tasks[i]))
+            return fprintf(stderr, "frame %d: pid %d, wrong deltas\n", frame, Tasks[i].tid), 0;
+      if (!ring(work))
+         return fprintf(stderr, "frame %d: wrong history ring\n", frame), 0;
+   }
+   return 1;
+}
+
+int main (int argc, char **argv) {
+   srand(1);
+   return fuzz() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,254 @@
+/*
+ * test_paint -- check that top's changed rows, sent in part, still paint
+ *               the very same screen as sending them whole
+ *
+ * With no arguments random frames of summary and task rows, using xterm's
+ * colors and attributes, slowly evolve.  Each frame goes through PUFF, as
+ * top would send it, and separately is sent whole.  A tiny emulation of
+ * xterm paints both and any difference in the resulting screens (chars or
+ * attributes) fails.
+ *
+ * When there's no xterm terminfo entry the test is skipped.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of top, just so its statics are within reach */
+#define main top_main
+#include "top.c"
+#undef main
+
+#define COLS        80
+#define ROWS        30
+#define SUMS        5
+#define FUZZ_FRAMES 3000
+
+/* ------ a very small xterm, as far as top needs one ------ */
+typedef struct {
+   char ch;
+   signed char bold, rev, fg;
+} CELL;
+
+typedef struct {
+   CELL grid[ROWS][COLS];
+   int row, col;
+   CELL atr;
+} TERM;
+
+static TERM Whole, Parts;
+
+static void sgr (TERM *t, const char *p, const char *e) {
+   int v[16], n = 0, i;
+
+   while (p < e && n < 16) {
+      v[n++] = atoi(p);
+      while (p < e && ';' != *p) p++;
+      if (p < e) p++;
+   }
+   if (!n) v[n++] = 0;
+   for (i = 0; i < n; i++) {
+      if (0 == v[i]) t->atr.bold = t->atr.rev = t->atr.fg = 0;
+      else if (1 == v[i]) t->atr.bold = 1;
+      else if (7 == v[i]) t->atr.rev = 1;
+      else if (22 == v[i]) t->atr.bold = 0;
+      else if (27 == v[i]) t->atr.rev = 0;
+      else if (30 <= v[i] && v[i] <= 37) t->atr.fg = v[i] - 29;
+      else if (90 <= v[i] && v[i] <= 97) t->atr.fg = v[i] - 81;
+      else if (38 == v[i] && i + 2 < n) { t->atr.fg = v[i + 2] + 1; i += 2; }
+      else if (39 == v[i]) t->atr.fg = 0;
+   }
+}
+
+static int paint (TERM *t, const char *s, size_t len) {
+   const char *e = s + len, *p;
+   int i;
+
+   while (s < e) {
+      if ('\n' == *s) { t->row++; t->col = 0; s++; continue; }
+      if ('\r' == *s) { t->col = 0; s++; continue; }
+      if ('\033' == *s && '(' == s[1]) { s += 3; continue; }
+      if ('\033' == *s && '[' == s[1]) {
+         for (p = s += 2; s < e && !isalpha((unsigned char)*s); s++) ;
+         switch (*s++) {
+            case 'm':
+               sgr(t, p, s - 1);
+               break;
+            case 'K':
+               for (i = t->col; i < COLS; i++) {
+                  memset(&t->grid[t->row][i], 0, sizeof(CELL));
+                  t->grid[t->row][i].ch = ' ';
+               }
+               break;
+            case 'G':
+               t->col = atoi(p) - 1;
+               break;
+            case 'H':
+               t->row = t->col = 0;
+               break;
+            default:
+               return fprintf(stderr, "unexpected escape '%c'\n", s[-1]), 0;
+         }
+         if (t->col >= COLS) t->col = COLS - 1;
+         continue;
+      }
+      if (*s < ' ') return fprintf(stderr, "unexpected control %d\n", *s), 0;
+      if (t->row >= ROWS) return fprintf(stderr, "off the screen\n"), 0;
+      if (t->col < COLS) {              // like top, with no auto margins
+         t->grid[t->row][t->col] = t->atr;
+         t->grid[t->row][t->col++].ch = *s;
+      }
+      s++;
+   }
+   return 1;
+}
+
+/* ------ the frames, as top would make them ------ */
+typedef struct {
+   int nseg;
+   int cap[8];
+   char txt[8][96];
+} ROW;
+
+static ROW Rows[ROWS];
+static char Caps[8][CAPBUFSIZ * 2];
+
+static void random_text (char *txt, int max) {
+   static const char chars[] = " 0123456789abcdefmKG%.:[";
+   int i, n = rand() % max;
+
+   for (i = 0; i < n; i++)
+      txt[i] = chars[rand() % (sizeof(chars) - 1)];
+   txt[n] = '\0';
+}
+
+static void random_row (ROW *r) {
+   int i;
+
+   r->nseg = 1 + rand() % 8;
+   for (i = 0; i < r->nseg; i++) {
+      r->cap[i] = rand() % 8;
+      random_text(r->txt[i], 30);
+   }
+}
+
+static void evolve_row (ROW *r) {
+   int s = rand() % r->nseg, n = strlen(r->txt[s]);
+
+   switch (rand() % 8) {
+      case 0: case 1: case 2:                   // unchanged
+         break;
+      case 3: case 4:                           // a char or two change
+         if (n) r->txt[s][rand() % n] = '0' + rand() % 10;
+         if (n) r->txt[s][rand() % n] = '0' + rand() % 10;
+         break;
+      case 5:                                   // some other attribute
+         r->cap[s] = rand() % 8;
+         break;
+      case 6:                                   // grown or shrunk
+         random_text(r->txt[s], 30);
+         break;
+      default:                                  // something else entirely
+         random_row(r);
+   }
+}
+
+static void row_make (const ROW *r, char *buf) {
+   int i;
+
+   *buf = '\0';
+   for (i = 0; i < r->nseg; i++) {
+      strcat(buf, Caps[r->cap[i]]);
+      strcat(buf, r->txt[i]);
+   }
+}
+
+/* send a frame, both whole and through PUFF, returning the bytes of each */
+static int frame (size_t *whole, size_t *parts) {
+   char row[ROWMAXSIZ], str[ROWMAXSIZ], *buf;
+   FILE *real = stdout;
+   size_t len;
+   int i, ok;
+
+   paint(&Whole, "\033[H", 3);
+   paint(&Parts, "\033[H", 3);
+   *whole = 3;
+   for (i = 0; i < ROWS - 1; i++) {
+      row_make(&Rows[i], row);
+      if (i < SUMS) snprintf(str, sizeof(str), "%s%s\n", row, Caps_endline);
+      else snprintf(str, sizeof(str), "\n%s%s", row, Caps_endline);
+      if (!paint(&Whole, str, strlen(str)))
+         return 0;
+      *whole += strlen(str);
+   }
+   stdout = open_memstream(&buf, &len);
+   putp("\033[H");
+   Pseudo_row = 0;
+   for (i = 0; i < ROWS - 1; i++) {
+      row_make(&Rows[i], row);
+      if (i < SUMS) PUFF("%s%s\n", row, Caps_endline);
+      else PUFF("\n%s%s", row, Caps_endline);
+   }
+   fclose(stdout);
+   stdout = real;
+   ok = paint(&Parts, buf, len);
+   *parts = len;
+   free(buf);
+   return ok;
+}
+
+static int same (void) {
+   int r, c;
+
+   for (r = 0; r < ROWS; r++)
+      for (c = 0; c < COLS; c++)
+         if (memcmp(&Whole.grid[r][c], &Parts.grid[r][c], sizeof(CELL)))
+            return fprintf(stderr, "row %d, col %d: '%c' vs '%c'\n", r, c
+               , Whole.grid[r][c].ch, Parts.grid[r][c].ch), 0;
+   return 1;
+}
+
+int main (int argc, char **argv) {
+   size_t whole, parts;
+   int f, i, err;
+
+   if (OK != setupterm("xterm", -1, &err))
+      return 77;                                // automake's 'skipped'
+   Screen_cols = COLS;
+   Screen_rows = ROWS;
+   Pseudo_screen = alloc_c(ROWS * ROWMAXSIZ);
+   snprintf(Cap_norm, sizeof(Cap_norm), "%s", exit_attribute_mode);
+   snprintf(Cap_clr_eol, sizeof(Cap_clr_eol), "%s", clr_eol);
+   strcat(strcpy(Caps_off, Cap_norm), orig_pair);
+   strcat(strcpy(Caps_endline, Caps_off), Cap_clr_eol);
+   Cap_can_goto = 1;
+   snprintf(Caps[1], sizeof(Caps[1]), "%s", Cap_norm);
+   snprintf(Caps[2], sizeof(Caps[2]), "%s", Caps_off);
+   snprintf(Caps[3], sizeof(Caps[3]), "%s", enter_bold_mode);
+   snprintf(Caps[4], sizeof(Caps[4]), "%s", enter_reverse_mode);
+   snprintf(Caps[5], sizeof(Caps[5]), "%s", tparm(set_a_foreground, 1, 0, 0, 0, 0, 0, 0, 0, 0));
+   snprintf(Caps[6], sizeof(Caps[6]), "%s", tparm(set_a_foreground, 2, 0, 0, 0, 0, 0, 0, 0, 0));
+   strcat(strcpy(Caps[7], Caps[3]), Caps[5]);
+
+   srand(1);
+   for (i = 0; i < ROWS; i++)
+      random_row(&Rows[i]);
+   for (f = 0; f < FUZZ_FRAMES; f++) {
+      for (i = 0; i < ROWS; i++)
+         evolve_row(&Rows[i]);
+      // now and then, as after a resize, everything is repainted
+      if (!(rand() % 200)) PSU_CLREOS(0);
+      if (!frame(&whole, &parts) || !same()) {
+         fprintf(stderr, "frame %d differs\n", f);
+         return EXIT_FAILURE;
+      }
+   }
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+/*
+ * test_pool -- check top's worker pool against a lone thread reading /proc
+ *
+ * The process table is read by procs_refresh() with the pool and then
+ * without it, as processes and as threads, under flags which the pool can
+ * satisfy by itself and flags which leave work for readproc_more().  Each
+ * task is rendered as a row of the fields that can't change from one moment
+ * to the next, and any difference in those rows, or in their order, fails.
+ * Since tasks will come and go between the reads, a few tries are allowed.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of top, just so its statics are within reach */
+#define main top_main
+#include "top.c"
+#undef main
+
+#define POOL_SIZE   4
+#define TRIES       10
+
+static const int Flagsets[] = {
+   L_stat,
+   L_stat | L_statm | L_status,
+   L_stat | L_EUSER | L_OUSER | L_EGROUP | L_SUPGRP,
+   L_stat | L_CMDLINE | L_CGROUP | L_OOM | L_NS,
+   L_stat | L_NUMA,
+};
+
+static const char *vec (char **v) {
+   return v && *v ? *v : "";
+}
+
+/* read the table, with or without the pool, and render its rows */
+static char *rows (int pooled) {
+   static char buf[1024];
+   char *all = NULL;
+   size_t len = 0;
+   proc_t *p;
+   int i, n;
+
+   Pool_threads = pooled ? POOL_SIZE : 1;
+   procs_refresh();
+   for (i = 0; i < Frame_maxtask; i++) {
+      p = Winstk[0].ppt[i];
+      n = snprintf(buf, sizeof(buf), "%d %d %d %llu %s|%s %s %s %s|%s|%s|%s|%d %lu %d\n"
+         , p->tid, p->tgid, p->ppid, p->start_time, p->cmd
+         , p->euser, p->ruser, p->egroup, p->supgrp ? p->supgrp : ""
+         , vec(p->cmdline), vec(p->cgroup), p->lxcname ? p->lxcname : ""
+         , p->oom_adj, p->ns[0], p->numa_pref);
+      all = realloc(all, len + n + 1);
+      memcpy(all + len, buf, n + 1);
+      len += n;
+   }
+   return all ? all : strdup("");
+}
+
+/* the first line in which a and b differ, for the failure report */
+static void differ (const char *a, const char *b) {
+   const char *na, *nb;
+
+   for (;;) {
+      na = strchr(a, '\n');
+      nb = strchr(b, '\n');
+      if (!na || !nb || na - a != nb - b || memcmp(a, b, na - a))
+         break;
+      a = na + 1;
+      b = nb + 1;
+   }
+   fprintf(stderr, "  single: %.*s\n  pooled: %.*s\n"
+      , na ? (int)(na - a) : (int)strlen(a), a
+      , nb ? (int)(nb - b) : (int)strlen(b), b);
+}
+
+static int compare (int flags, int threads) {
+   char *one, *many;
+   int try, ok = 0;
+
+   Frames_libflags = flags;
+   Thread_mode = threads;
+   for (try = 0; try < TRIES && !ok; try++) {
+      one = rows(0);
+      many = rows(1);
+      if (!(ok = !strcmp(one, many)) && try == TRIES - 1) {
+         fprintf(stderr, "flags %08x%s: differ\n", flags, threads ? " (threads)" : "");
+         differ(one, many);
+      }
+      free(one);
+      free(many);
+   }
+   return ok;
+}
+
+int main (int argc, char **argv) {
+   unsigned i;
+
+   // start the workers, which are also some threads worth reading
+   Rc.pool_threads = POOL_SIZE;
+   pool_init();
+   if (Pool_threads != POOL_SIZE) {
+      fprintf(stderr, "only %d of %d pool threads\n", Pool_threads, POOL_SIZE);
+      return EXIT_FAILURE;
+   }
+   for (i = 0; i < sizeof(Flagsets) / sizeof(Flagsets[0]); i++)
+      if (!compare(Flagsets[i], 0) || !compare(Flagsets[i], 1))
+         return EXIT_FAILURE;
+   return EXIT_SUCCESS;
+}
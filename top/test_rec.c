@@ -0,0 +1,271 @@
+/*
+ * test_rec -- check that top's recordings replay just what was recorded
+ *
+ * With no arguments a series of frames is recorded, with tasks that come
+ * and go (now and then all of them), fields that change every frame, every
+ * few frames or never, some strings absent, the order of the tasks shifting
+ * now and then and the number of cpus changing midway.  The recording is
+ * then replayed and each frame's tasks, summary values and cpu tics must
+ * be exactly those which were recorded.  Lastly the replay is positioned
+ * at random frames, which must then be the ones shown (after the priming
+ * frame).
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of top, just so its statics are within reach */
+#define main top_main
+#include "top.c"
+#undef main
+
+#define FUZZ_FRAMES 300
+#define FUZZ_TASKS  3000
+#define FUZZ_SEEKS  40
+#define MAX_CPUS    8
+
+static proc_t *Tasks, **Ppt;
+static int     Ntasks, Ntotal, Life;
+static const char *Pool[64];
+static char    Path[] = "/tmp/test_rec.XXXXXX";
+
+/* the same few bits, every time they're asked for */
+static unsigned long long mix (unsigned long long a, unsigned long long b, unsigned long long c) {
+   unsigned long long z = a * 0x9e3779b97f4a7c15ull ^ b * 0xbf58476d1ce4e5b9ull ^ c * 0x94d049bb133111ebull;
+
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+   return z ^ (z >> 31);
+}
+
+/* a field's value in some frame, which changes every frame, every 4 or
+   16 frames or not at all (and is sometimes small, sometimes not) */
+static unsigned long long value (int t, int fld, int frame) {
+   static const int shifts[] = { 0, 2, 4, 30 };
+   unsigned long long v = mix(t, fld, frame >> shifts[mix(t, fld, 0) % 4]);
+
+   return v % 3 ? v % 1000 : v;
+}
+
+/* a task's strings, from the pool or (for pointers and vectors) NULL */
+static const char *string (int t, int fld, int frame) {
+   unsigned long long v = value(t, fld, frame) % 70;
+
+   return v < 64 ? Pool[v] : NULL;
+}
+
+/* the tasks of a frame, each alive for a while, and in an order that
+   now and then shifts around (with every 100th frame empty) */
+static void make_frame (int frame) {
+   static char *vecs[FUZZ_TASKS][3][2];
+   const char *s;
+   proc_t *p;
+   char *a;
+   int i, t, f, born;
+
+   for (i = Ntasks = 0; i < Ntotal; i++) {
+      t = (i + frame / 50 * 37) % Ntotal;
+      born = Life ? mix(t, 1, 1) % FUZZ_FRAMES : 0;
+      if (99 == frame % 100
+      || (Life && (frame < born || frame >= born + 1 + (int)(mix(t, 2, 2) % Life))))
+         continue;
+      p = &Tasks[Ntasks];
+      memset(p, 0, sizeof(*p));
+      for (f = 0; f < REC_NFLD; f++) {
+         a = (char *)p + Rec_flds[f].ofs;
+         switch (Rec_flds[f].typ) {
+            case RF_num:
+               memcpy(a, &(unsigned long long){ value(t, f, frame) }, Rec_flds[f].siz);
+               break;
+            case RF_arr:
+               s = string(t, f, frame);
+               snprintf(a, Rec_flds[f].siz, "%s", s ? s : "");
+               break;
+            case RF_ptr:
+               *(const char **)a = string(t, f, frame);
+               break;
+            default:
+               if ((s = string(t, f, frame))) {
+                  vecs[t][f % 3][0] = (char *)s;
+                  *(char ***)a = vecs[t][f % 3];
+               }
+               break;
+         }
+      }
+      p->tid = 1 + t;
+      Ppt[Ntasks++] = p;
+   }
+   // and the system at large, with a couple more cpus later on
+   Thread_mode = mix(frame, 3, 3) % 2;
+   smp_num_cpus = frame < FUZZ_FRAMES / 2 ? MAX_CPUS - 2 : MAX_CPUS;
+   Cpu_faux_tot = smp_num_cpus - mix(frame, 4, 4) % 2;
+   Numa_cpu_tot = smp_num_cpus;
+   Numa_cpu_node = alloc_r(Numa_cpu_node, sizeof(int) * MAX_CPUS);
+   for (i = 0; i <= MAX_CPUS; i++) {
+      Cpu_tics[i].id = i;
+      Cpu_tics[i].cur.u = value(i, 0, frame); Cpu_tics[i].cur.n = value(i, 1, frame);
+      Cpu_tics[i].cur.s = value(i, 2, frame); Cpu_tics[i].cur.i = value(i, 3, frame);
+      Cpu_tics[i].cur.w = value(i, 4, frame); Cpu_tics[i].cur.x = value(i, 5, frame);
+      Cpu_tics[i].cur.y = value(i, 6, frame); Cpu_tics[i].cur.z = value(i, 7, frame);
+      if (i < MAX_CPUS) Numa_cpu_node[i] = (int)(mix(i, frame >> 6, 5) % 3) - 1;
+   }
+   kb_main_total = value(1, 10, frame); kb_main_free = value(1, 11, frame);
+   kb_main_used = value(1, 12, frame); kb_main_buffers = value(1, 13, frame);
+   kb_main_cached = value(1, 14, frame); kb_main_available = value(1, 15, frame);
+   kb_swap_total = value(1, 16, frame); kb_swap_free = value(1, 17, frame);
+   kb_swap_used = value(1, 18, frame);
+   Psi_have = frame % 7 != 0;
+   for (i = 0; i < PSI_MAX; i++) {
+      Psi_now.some[i] = value(2, i, frame);
+      Psi_now.full[i] = value(3, i, frame);
+   }
+   Psi_now.stamp = value(4, 0, frame);
+}
+
+/* whether a replayed task is the one recorded (with a "-" for any string
+   that was recorded as NULL) */
+static int same_task (const proc_t *p, const proc_t *want) {
+   const char *a, *b, *s;
+   int f;
+
+   for (f = 0; f < REC_NFLD; f++) {
+      a = (const char *)p + Rec_flds[f].ofs;
+      b = (const char *)want + Rec_flds[f].ofs;
+      switch (Rec_flds[f].typ) {
+         case RF_num:
+            if (memcmp(a, b, Rec_flds[f].siz)) return 0;
+            break;
+         case RF_arr:
+            if (strcmp(a, b)) return 0;
+            break;
+         case RF_ptr:
+            s = *(const char * const *)b;
+            if (strcmp(*(const char * const *)a, s ? s : "-")) return 0;
+            break;
+         default:
+            s = *(char ** const *)b ? **(char ** const *)b : NULL;
+            if (strcmp(**(char ** const *)a, s ? s : "-")) return 0;
+            break;
+      }
+   }
+   return 1;
+}
+
+/* whether the frame just replayed is the one recorded */
+static int same_frame (int frame) {
+   TIC_t tics[8];
+   int i, id;
+
+   make_frame(frame);
+   if (Rec_nppt != Ntasks)
+      return fprintf(stderr, "frame %d: %d tasks, not %d\n", frame, Rec_nppt, Ntasks), 0;
+   for (i = 0; i < Ntasks; i++)
+      if (!same_task(Rec_ppt[i], Ppt[i]))
+         return fprintf(stderr, "frame %d: task %d differs\n", frame, Ppt[i]->tid), 0;
+   if (!!(Rec_frm->flags & REC_fTHD) != Thread_mode
+   || Rec_sys[RS_ncpus] != (unsigned)smp_num_cpus || Rec_sys[RS_lines] != (unsigned)Cpu_faux_tot
+   || Rec_sys[RS_mtotal] != kb_main_total || Rec_sys[RS_mavail] != kb_main_available
+   || Rec_sys[RS_sused] != kb_swap_used || Rec_sys[RS_psi] != (unsigned)Psi_have
+   || Rec_sys[RS_pfull + PSI_IO] != Psi_now.full[PSI_IO] || Rec_sys[RS_pstamp] != Psi_now.stamp)
+      return fprintf(stderr, "frame %d: summary differs\n", frame), 0;
+   for (i = 0; i < smp_num_cpus; i++)
+      if (Rec_sys[RS_MAX + i] != (unsigned long long)(Numa_cpu_node[i] + 1))
+         return fprintf(stderr, "frame %d: cpu %d numa node differs\n", frame, i), 0;
+   for (i = 0; i <= Cpu_faux_tot; i++) {
+      const CPU_t *c = &Cpu_tics[i ? i - 1 : smp_num_cpus];
+      if (8 != rec_cpu(i, &id, tics) || id != (i ? c->id : -1)
+      || tics[0] != c->cur.u || tics[3] != c->cur.i || tics[7] != c->cur.z)
+         return fprintf(stderr, "frame %d: cpu line %d differs\n", frame, i), 0;
+   }
+   return rec_cpu(i, &id, tics) < 0;
+}
+
+/* from recording to replaying, as parse_args would have it */
+static void replay (void) {
+   close(Rec_fd);
+   Rec_mode = REC_play;
+   Rec_path = Path;
+   Rec_astr = Rec_nsys = Rec_nsav = Rec_nkey = 0;
+   Rec_strs = NULL;
+   Rec_vecs = NULL;
+   rec_open(NULL);
+}
+
+static void record (void) {
+   int fd;
+
+   if (0 > (fd = mkstemp(Path))) {
+      perror(Path);
+      exit(EXIT_FAILURE);
+   }
+   close(fd);
+   Rec_mode = REC_save;
+   Rec_path = Path;
+   rec_open(NULL);
+}
+
+static void setup (int ntotal, int life) {
+   static char buf[64][80];
+   int i;
+
+   for (i = 0; i < 64; i++) {
+      snprintf(buf[i], sizeof(buf[i]), "%s%d%s", i % 4 ? "str" : "", i
+         , i % 8 ? "" : " a somewhat longer string, as a command line might be");
+      Pool[i] = buf[i];
+   }
+   Ntotal = ntotal;
+   Life = life;
+   Tasks = calloc(ntotal, sizeof(proc_t));
+   Ppt = calloc(ntotal, sizeof(proc_t *));
+   Cpu_tics = calloc(MAX_CPUS + 1, sizeof(CPU_t));
+}
+
+static int fuzz (void) {
+   unsigned long long usecs[FUZZ_FRAMES];
+   int frame, i, k;
+
+   setup(FUZZ_TASKS, 120);
+   record();
+   for (frame = 0; frame < FUZZ_FRAMES; frame++) {
+      make_frame(frame);
+      rec_save(Ppt, Ntasks);
+      usleep(10);                       // (so no two frames share a time)
+   }
+   replay();
+   for (frame = 0; frame < FUZZ_FRAMES; frame++) {
+      if (!rec_next())
+         return fprintf(stderr, "frame %d: missing\n", frame), 0;
+      usecs[frame] = Rec_frm->usecs;
+      if (!same_frame(frame))
+         return 0;
+   }
+   if (rec_next() || !Rec_held)
+      return fprintf(stderr, "too many frames\n"), 0;
+
+   // and straight to some frame, after the priming one (if any)
+   for (i = 0; i < FUZZ_SEEKS; i++) {
+      k = rand() % FUZZ_FRAMES;
+      rec_seek(usecs[k] - rand() % 5);
+      if (!rec_next() || !rec_next() || Rec_frm->usecs != usecs[k ? k : 1])
+         return fprintf(stderr, "seek to frame %d failed\n", k), 0;
+      if (!same_frame(k ? k : 1))
+         return 0;
+   }
+   return 1;
+}
+
+int main (int argc, char **argv) {
+   int ok;
+
+   srand(1);
+   ok = fuzz();
+   unlink(Path);
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
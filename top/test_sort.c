@@ -0,0 +1,101 @@
+/*
+ * test_sort -- check top's keyed sorts against its sort callbacks
+ *
+ * With no arguments, random task tables are ordered by every numeric field,
+ * both ways, through window_hlp() -- whether selecting just a few rows or
+ * all of them.  The results must match those of glibc's (stable) qsort
+ * using the field's original callback.  The first rounds have just the
+ * one task, and none at all.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/* all of top, just so its statics are within reach */
+#define main top_main
+#include "top.c"
+#undef main
+
+#define FUZZ_ROUNDS 40
+
+static proc_t *Tasks;
+static proc_t **Want;
+
+/* random values, though kept small enough that no callback's subtraction
+   can overflow, and with some signed fields going negative */
+static void make_tasks (int n) {
+   unsigned char *b;
+   size_t j;
+   int i;
+
+   for (i = 0; i < n; i++) {
+      proc_t *p = &Tasks[i];
+      for (b = (unsigned char *)p, j = 0; j < sizeof(*p); j++)
+         b[j] = rand() % 4;
+      p->nice = rand() % 40 - 20;
+      p->priority = rand() % 140 - 100;
+      p->oom_adj = rand() % 34 - 17;
+      p->processor = rand() % 8;
+      p->wchan = rand() % 3 ? (KLONG)rand() : (KLONG)~0ull;
+   }
+}
+
+static int compare (int n, int fld, int need) {
+   WIN_t w;
+   int i;
+
+   memset(&w, 0, sizeof(w));
+   w.rc.sortindx = fld;
+   if (Frame_srtflg > 0) SETw(&w, Qsrt_NORMAL);
+   w.ppt = malloc(sizeof(proc_t*) * n);
+   for (i = 0; i < n; i++)
+      w.ppt[i] = Want[i] = &Tasks[i];
+   w.pptcnt = n;
+   qsort(Want, n, sizeof(proc_t*), Fieldstab[fld].sort);
+
+   window_hlp(&w, need);
+   for (i = 0; i < w.srtcnt && i < need; i++)
+      if (w.ppt[i] != Want[i])
+         goto bad;
+   window_hlp(&w, n);
+   for (i = 0; i < n; i++)
+      if (w.ppt[i] != Want[i])
+         goto bad;
+   free(w.ppt);
+   return 1;
+bad:
+   fprintf(stderr, "field %d, %s, %d tasks, need %d: differ at %d\n"
+      , fld, Frame_srtflg > 0 ? "normal" : "reverse", n, need, i);
+   free(w.ppt);
+   return 0;
+}
+
+int main (int argc, char **argv) {
+   int round, n, fld, dir;
+
+   numa_init();
+   sysinfo_refresh(1);
+   srand(1);
+   Tasks = calloc(3000, sizeof(proc_t));
+   Want = malloc(sizeof(proc_t*) * 3000);
+   for (round = 0; round < FUZZ_ROUNDS; round++) {
+      n = round < 2 ? 1 - round : 1 + rand() % 3000;
+      make_tasks(n);
+      for (fld = 0; fld < EU_MAXPFLGS; fld++) {
+         if (!Fieldstab[fld].key) continue;
+         for (dir = 0; dir < 2; dir++) {
+            Frame_srtflg = dir ? 1 : -1;
+            if (!compare(n, fld, 1 + rand() % 40) || !compare(n, fld, n))
+               return EXIT_FAILURE;
+         }
+      }
+   }
+   return EXIT_SUCCESS;
+}
@@ -20,13 +20,16 @@
 
 #include <ctype.h>
 #include <curses.h>
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <float.h>
 #include <limits.h>
+#include <pthread.h>
 #include <pwd.h>
 #include <signal.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -38,11 +41,13 @@
 #include <unistd.h>
 
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/select.h>      // also available via <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>       // also available via <stdlib.h>
+#include <sys/uio.h>
 
 #include "../include/fileutils.h"
 #include "../include/nls.h"
@@ -53,6 +58,7 @@
 #include "../proc/readproc.h"
 #include "../proc/sig.h"
 #include "../proc/sysinfo.h"
+#include "../proc/taskstats.h"
 #include "../proc/version.h"
 #include "../proc/wchan.h"
 #include "../proc/whattime.h"
@@ -99,6 +105,10 @@ static const char *Cpu_States_fmts;
 static pid_t Monpids [MONPIDMAX] = { 0 };
 static int   Monpidsidx = 0;
 
+        /* Specific cgroup v2 subtree monitoring support (NULL terminated) */
+static char **Moncgrps = NULL;
+static int    Moncgrpsidx = 0;
+
         /* Current screen dimensions.
            note: the number of processes displayed is tracked on a per window
                  basis (see the WIN_t).  Max_lines is the total number of
@@ -117,6 +127,7 @@ static char Scroll_fmts [SMLBUFSIZ];
 
         /* Global/Non-windows mode stuff that is NOT persistent */
 static int Batch = 0,           // batch mode, collect no input, dumb output
+           Emit_mode = EMIT_off,// set w/ 'O' - batch csv/json, not text
            Loops = -1,          // number of iterations, -1 loops forever
            Secure_mode = 0,     // set if some functionality restricted
            Thread_mode = 0,     // set w/ 'H' - show threads via readeither()
@@ -155,6 +166,8 @@ static int   Cap_can_goto = 0;
 static char  *Pseudo_screen;
 static int    Pseudo_row = PROC_XTRA;
 static size_t Pseudo_size;
+        // bytes sent to the terminal, so far this frame and for the last
+static unsigned long Frame_tally, Frame_bytes;
 #ifndef OFF_STDIOLBF
         // less than stdout's normal buffer but with luck mostly '\n' anyway
 static char  Stdout_buf[2048];
@@ -173,9 +186,12 @@ static WIN_t *Curwin;
            [ or are used in response to async signals received ! ] */
 static volatile int Frames_signal;     // time to rebuild all column headers
 static          int Frames_libflags;   // PROC_FILLxxx flags
+static          int Frames_lazflags;   // PROC_FILLxxx flags, for task_show
+static          int Frames_grpflags;   // Show_GROUPS bases any window shows
 static int          Frame_maxtask;     // last known number of active tasks
                                        // ie. current 'size' of proc table
 static float        Frame_etscale;     // so we can '*' vs. '/' WHEN 'pcpu'
+static float        Frame_dlyscale;    // same, but for the taskstats delays
 static unsigned     Frame_running,     // state categories for this frame
                     Frame_sleepin,
                     Frame_stopped,
@@ -183,20 +199,64 @@ static unsigned     Frame_running,     // state categories for this frame
 static int          Frame_srtflg,      // the subject window's sort direction
                     Frame_ctimes,      // the subject window's ctimes flag
                     Frame_cmdlin;      // the subject window's cmdlin flag
+static double       Frame_phases [PHASE_MAX]; // secs spent, in each phase
+static FRM_t        Frame_costs;       // the last frame's costs, for 'D'
+static unsigned long Frame_allocs;     // alloc_c/alloc_r calls (any thread)
+
+        /* Support for throttling, should our frames cost too much of the
+           delay -- that cost is smoothed, so quick to rise but slow to fall */
+static double Throttle_cost;           // recent secs per frame, wall or cpu
+static float  Throttle_delay;          // the stretched delay, else zero
 
         /* Support for 'history' processing so we can calculate %cpu */
 static int    HHist_siz;               // max number of HST_t structs
 static HST_t *PHist_sav,               // alternating 'old/new' HST_t anchors
              *PHist_new;
 #ifndef OFF_HST_HASH
-#define       HHASH_SIZ  1024
-static int    HHash_one [HHASH_SIZ],   // actual hash tables ( hereafter known
-              HHash_two [HHASH_SIZ],   // as PHash_sav/PHash_new )
-              HHash_nul [HHASH_SIZ];   // 'empty' hash table image
-static int   *PHash_sav = HHash_one,   // alternating 'old/new' hash tables
-             *PHash_new = HHash_two;
+static int   *PHash_sav,               // alternating 'old/new' hash tables
+             *PHash_new;               //  ( slots hold a PHist_xxx index )
+static int    HHash_savbits,           // each one's size, as a power of 2
+              HHash_newbits;
 #endif
 
+        /* Support for the history ring -- each task's last HRING_len samples
+           of %CPU, RES and faults, a slot apiece, kept in separate arrays
+           (and only while some window wants one of the history fields) */
+static int             Hring_siz,      // slots allocated
+                       Hring_used,     // slots ever handed out (<= Hring_siz)
+                       Hring_nfree,    // of those, slots since freed
+                      *Hring_free,     //  ( as a stack, for reuse )
+                       Hring_col;      // this frame's sample, in every slot
+static unsigned        Hring_frame,    // stamp for this frame (never zero)
+                      *Hring_seen;     // each slot's last frame, else zero
+static unsigned char  *Hring_cnt;      // each slot's samples (<= HRING_len)
+static unsigned short *Hring_cpu,      // %CPU, in tenths (HRING_len per slot)
+                      *Hring_flt;      // major plus minor faults (capped)
+static unsigned       *Hring_res;      // resident pages
+static unsigned       *Hring_cpusum,   // the sum of each slot's samples,
+                      *Hring_fltsum;   //  maintained as they come and go
+static unsigned long long *Hring_ressum;
+        /* a task's mean, times HRING_len (as the sums are integers), which
+           is safe should the proc_t not be one seen by procs_hlp */
+#define HRING_AVG(p,s) ( (unsigned)(p)->hist_slot >= (unsigned)Hring_used \
+   || !Hring_cnt[(p)->hist_slot] ? 0 : (unsigned long long)(s)[(p)->hist_slot] \
+   * HRING_len / Hring_cnt[(p)->hist_slot] )
+
+        /* Support for task groups, the 'v' toggle -- a frame's tasks totaled
+           by cgroup (or lxc container), in a hash of the interned names.  The
+           groups outlive a frame, so each name is interned just once, but one
+           without tasks for GRP_STALE frames is let go */
+#define GRP_BASES  2                   // by cgroup, else by lxc container
+#define GRP_STALE  10
+#define GRP_BASE(q) (CHKw(q, Show_GRPLXC) ? 1 : 0)
+static struct {
+   GRP_t **tab;                        // the groups, in order of discovery
+   int     used, siz,                  // groups held, and room for them
+          *hash, msk,                  // hash chain heads, as tab indexes
+           last;                       // the group last found, else -1
+} Grps [GRP_BASES];
+static int Grps_frame;                 // stamp for this frame
+
         /* Support for automatically sized fixed-width column expansions.
          * (hopefully, the macros help clarify/document our new 'feature') */
 static int Autox_array [EU_MAXPFLGS],
@@ -216,8 +276,57 @@ static int Autox_array [EU_MAXPFLGS],
 #ifndef OFF_STDERROR
 static int Stderr_save = -1;
 #endif
-static int Numa_node_tot;
-static int Numa_node_sel = -1;
+static int  Numa_node_tot;
+static int  Numa_node_sel = -1;
+static int *Numa_cpu_node;             // each cpu's node, for this frame
+static int  Numa_cpu_tot;              // cpus represented in that table
+#define NUMA_NODE(c) ( (unsigned)(c) < (unsigned)Numa_cpu_tot \
+   ? Numa_cpu_node[c] : numa_node_of_cpu(c) )
+        // and for the View_MEMNOD ('4') memory, by node, now and as of the
+        // prior refresh (whose numastat counts are subtracted from these)
+static node_mem *Node_now, *Node_sav;
+static int       Node_tot,             // nodes, as sysfs would have it
+                 Node_siz;             // room for nodes, in both tables
+
+        /* Support for Pressure Stall Information, the View_PRESSR ('p')
+           command -- with this frame's and the prior frame's counters */
+static psi_info Psi_now, Psi_sav;
+static int      Psi_have;
+
+        /* Support for recording frames and replaying them -- both sides keep
+           the prior frame's values (REC_NFLD for each task), from which the
+           deltas are made, plus the strings interned since the key frame */
+static int        Rec_mode = REC_off;  // set w/ --record or --replay
+static const char *Rec_path;           // the recording's name
+static int        Rec_fd = -1;         // and its file descriptor
+static unsigned long long *Rec_sys,    // the prior frame's summary values
+                  *Rec_sav,            // the prior frame's tasks
+                  *Rec_new;            // this frame's tasks (then swapped)
+static int        Rec_nsys,            // summary values (varies with cpus)
+                  Rec_nsav,            // tasks in Rec_sav
+                  Rec_ntsk;            // room for tasks, in Rec_sav & Rec_new
+static const char **Rec_strs;          // the interned strings (0 is none)
+static int        Rec_nstr,            // ids issued since the key frame
+                  Rec_astr;            // room for ids
+        // for rec_save, the frame being built and where to find things
+static char      *Rec_buf[2];          // header + strings, then the rest
+static size_t     Rec_blen[2], Rec_bsiz[2];
+static int        Rec_frames;          // frames since the key frame
+static int       *Rec_shsh, Rec_smsk,  // strings' hash table (to an id)
+                 *Rec_thsh, Rec_tmsk;  // Rec_sav tids' (to an index)
+        // for rec_next, the mapped file and what was just decoded from it
+static const char *Rec_map;
+static size_t     Rec_len, Rec_pos;    // bytes of whole frames, next frame
+static size_t    *Rec_keys;            // each key frame's offset
+static int        Rec_nkey;
+static const REC_frm *Rec_frm;         // the frame last decoded
+static const unsigned char *Rec_ptr,   // what's left of the frame being
+                  *Rec_end;            //  decoded (with Rec_end its end)
+static char     **Rec_vecs;            // a vector for each string (2 apiece)
+static proc_t    *Rec_tasks,           // the frame as proc_t's, and their
+                **Rec_ppt;             //  pointers, less any not monitored
+static int        Rec_nppt;
+static int        Rec_held;            // at the end, the last frame is held
 
         /* Support for Graphing of the View_STATES ('t') and View_MEMORY ('m')
            commands -- which are now both 4-way toggles */
@@ -242,10 +351,16 @@ SCB_STRS(CGR, cgroup[0])
 SCB_STRV(CMD, Frame_cmdlin, cmdline, cmd)
 SCB_NUM1(COD, trs)
 SCB_NUMx(CPN, processor)
+SCB_HIST(CPA, Hring_cpusum)            // also serves CPG !
 SCB_NUM1(CPU, pcpu)
 SCB_NUM1(DAT, drs)
+SCB_NUM1(DLB, delay_blkio)
+SCB_NUM1(DLC, delay_cpu)
+SCB_NUM1(DLR, delay_freepages)
+SCB_NUM1(DLS, delay_swapin)
 SCB_NUM1(DRT, dt)
 SCB_STRS(ENV, environ[0])
+SCB_HIST(FLA, Hring_fltsum)
 SCB_NUM1(FL1, maj_flt)
 SCB_NUM1(FL2, min_flt)
 SCB_NUM1(FLG, flags)
@@ -255,13 +370,18 @@ SCB_NUMx(GID, egid)
 SCB_STRS(GRP, egroup)
 SCB_STRS(LXC, lxcname)
 SCB_NUMx(NCE, nice)
+SCB_NUM1(NMK, numa_kb)
 static int SCB_NAME(NMA) (const proc_t **P, const proc_t **Q) {
-   /* this is a terrible cost to pay for sorting on numa nodes, but it's
-      necessary if we're to avoid ABI breakage via changes to the proc_t  */
-   int p = numa_node_of_cpu((*P)->processor);
-   int q = numa_node_of_cpu((*Q)->processor);
+   /* to avoid ABI breakage via changes to the proc_t, the numa node is
+      looked up -- but in a table sysinfo_refresh builds every frame */
+   int p = NUMA_NODE((*P)->processor);
+   int q = NUMA_NODE((*Q)->processor);
    return Frame_srtflg * ( q - p );
 }
+static unsigned long long SCB_KEYS(NMA) (const proc_t *P) {
+   return SCB_KEYV(NUMA_NODE(P->processor));
+}
+SCB_NUMx(NMP, numa_pref)
 SCB_NUM1(NS1, ns[IPCNS])
 SCB_NUM1(NS2, ns[MNTNS])
 SCB_NUM1(NS3, ns[NETNS])
@@ -275,6 +395,7 @@ SCB_NUMx(PID, tid)
 SCB_NUMx(PPD, ppid)
 SCB_NUMx(PRI, priority)
 SCB_NUM1(RES, resident)                // also serves MEM !
+SCB_HIST(RSG, Hring_ressum)
 SCB_NUM1(RZA, vm_rss_anon)
 SCB_NUM1(RZF, vm_rss_file)
 SCB_NUM1(RZL, vm_lock)
@@ -304,6 +425,11 @@ static int SCB_NAME(TME) (const proc_t **P, const proc_t **Q) {
    }
    return SORT_eq;
 }
+static unsigned long long SCB_KEYS(TME) (const proc_t *P) {
+   if (Frame_ctimes)
+      return P->cutime + P->cstime + P->utime + P->stime;
+   return P->utime + P->stime;
+}
 SCB_NUM1(TPG, tpgid)
 SCB_NUMx(TTY, tty)
 SCB_NUMx(UED, euid)
@@ -340,6 +466,15 @@ static const char *fmtmk (const char *fmts, ...) {
 } // end: fmtmk
 
 
+        /*
+         * This guy replaces the putchar which putp would have used, so
+         * that we can tally the bytes sent to the terminal per frame. */
+static int putp_tally (int c) {
+   ++Frame_tally;
+   return putchar(c);
+} // end: putp_tally
+
+
         /*
          * This guy is just our way of avoiding the overhead of the standard
          * strcat function (should the caller choose to participate) */
@@ -350,6 +485,17 @@ static inline char *scat (char *dst, const char *src) {
 } // end: scat
 
 
+        /*
+         * This guy returns the seconds as of now for the clock wanted,
+         * monotonic for the phases of a frame, process cputime for us. */
+static inline double secs_now (clockid_t id) {
+   struct timespec ts;
+
+   clock_gettime(id, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+} // end: secs_now
+
+
         /*
          * This guy just facilitates Batch and protects against dumb ttys
          * -- we'd 'inline' him but he's only called twice per frame,
@@ -469,75 +615,42 @@ static void bye_bye (const char *str) {
 
 #ifndef OFF_HST_HASH
 #ifdef ATEOJ_RPTHSH
-   if (!str && !Frames_signal && Ttychanged) {
-      int i, j, pop, total_occupied, maxdepth, maxdepth_sav, numdepth
-         , cross_foot, sz = HHASH_SIZ * (unsigned)sizeof(int);
-      int depths[HHASH_SIZ];
-
-      for (i = 0, total_occupied = 0, maxdepth = 0; i < HHASH_SIZ; i++) {
-         int V = PHash_new[i];
-         j = 0;
-         if (-1 < V) {
-            ++total_occupied;
-            while (-1 < V) {
-               V = PHist_new[V].lnk;
-               if (-1 < V) j++;
-            }
-         }
-         depths[i] = j;
-         if (maxdepth < j) maxdepth = j;
+   if (!str && !Frames_signal && Ttychanged && PHash_new) {
+      unsigned i, V, sz, probes, total_probes = 0, maxprobes = 0, depths[9];
+
+      memset(depths, 0, sizeof(depths));
+      sz = 1u << HHash_newbits;
+      // how far each entry landed from its home slot (1 == at home)
+      for (i = 0; i < (unsigned)Frame_maxtask; i++) {
+         V = (unsigned)PHist_new[i].pid * 2654435761u >> (32 - HHash_newbits);
+         probes = ((PHist_new[i].slot - V) & (sz - 1)) + 1;
+         total_probes += probes;
+         if (maxprobes < probes) maxprobes = probes;
+         depths[probes < 9 ? probes - 1 : 8]++;
       }
-      maxdepth_sav = maxdepth;
 
       fprintf(stderr,
          "\n%s's Supplementary HASH report:"
-         "\n\tTwo Tables providing for %d entries each + 1 extra for 'empty' image"
-         "\n\t%dk (%d bytes) per table, %d total bytes (including 'empty' image)"
+         "\n\tTwo Tables, open addressed, the latest having %u slots"
+         "\n\t%uk (%u bytes) per table"
          "\n\tResults from latest hash (PHash_new + PHist_new)..."
          "\n"
-         "\n\tTotal hashed = %d"
-         "\n\tLevel-0 hash entries = %d (%d%% occupied)"
-         "\n\tMax Depth = %d"
+         "\n\tTotal hashed = %d (%d%% occupied)"
+         "\n\tAverage Probes = %.2f"
+         "\n\tMax Probes = %u"
          "\n\n"
          , __func__
-         , HHASH_SIZ, sz / 1024, sz, sz * 3
-         , Frame_maxtask
-         , total_occupied, (total_occupied * 100) / HHASH_SIZ
-         , maxdepth + 1);
-
-      if (total_occupied) {
-         for (pop = total_occupied, cross_foot = 0; maxdepth; maxdepth--) {
-            for (i = 0, numdepth = 0; i < HHASH_SIZ; i++)
-               if (depths[i] == maxdepth) ++numdepth;
-            fprintf(stderr,
-               "\t %5d (%3d%%) hash table entries at depth %d\n"
-               , numdepth, (numdepth * 100) / total_occupied, maxdepth + 1);
-            pop -= numdepth;
-            cross_foot += numdepth;
-            if (0 == pop && cross_foot == total_occupied) break;
-         }
-         if (pop) {
-            fprintf(stderr, "\t %5d (%3d%%) unchained hash table entries\n"
-               , pop, (pop * 100) / total_occupied);
-            cross_foot += pop;
-         }
-         fprintf(stderr,
-            "\t -----\n"
-            "\t %5d total entries occupied\n", cross_foot);
-
-         if (maxdepth_sav > 1) {
-            fprintf(stderr, "\nPIDs at max depth: ");
-            for (i = 0; i < HHASH_SIZ; i++)
-               if (depths[i] == maxdepth_sav) {
-                  j = PHash_new[i];
-                  fprintf(stderr, "\n\tpos %4d:  %05d", i, PHist_new[j].pid);
-                  while (-1 < j) {
-                     j = PHist_new[j].lnk;
-                     if (-1 < j) fprintf(stderr, ", %05d", PHist_new[j].pid);
-                  }
-               }
-            fprintf(stderr, "\n");
-         }
+         , sz, sz * (unsigned)sizeof(int) / 1024, sz * (unsigned)sizeof(int)
+         , Frame_maxtask, sz ? (int)((Frame_maxtask * 100ull) / sz) : 0
+         , Frame_maxtask ? (double)total_probes / Frame_maxtask : 0.0
+         , maxprobes);
+
+      if (Frame_maxtask) {
+         for (i = 0; i < 9; i++)
+            if (depths[i])
+               fprintf(stderr, "\t %5u (%3u%%) entries found with %s%u probe(s)\n"
+                  , depths[i], (unsigned)((depths[i] * 100ull) / Frame_maxtask)
+                  , i < 8 ? "" : ">= ", i + 1);
       }
    }
 #endif // end: ATEOJ_RPTHSH
@@ -548,7 +661,7 @@ static void bye_bye (const char *str) {
       fputs(str, stderr);
       exit(EXIT_FAILURE);
    }
-   if (Batch) fputs("\n", stdout);
+   if (Batch && !Emit_mode) fputs("\n", stdout);
    exit(EXIT_SUCCESS);
 } // end: bye_bye
 
@@ -726,6 +839,156 @@ static void capsmk (WIN_t *q) {
 } // end: capsmk
 
 
+#ifndef OFF_CELLDIFF
+        /*
+         * A row_diff *Helper* function returning the length of the escape
+         * sequence (or other non-printing control) at p, 0 for a printable
+         * char or -1 for things we can't track, like tabs or 8-bit chars. */
+static int esc_len (const char *p) {
+   const unsigned char *q = (const unsigned char *)p;
+
+   if (*q >= 0x80 || strchr("\b\t\n\v\f\r", *q)) return -1;
+   if ('$' == *q && '<' == q[1]) return -1;      // terminfo padding
+   if (' ' <= *q && 0x7f != *q) return 0;
+   if ('\033' != *q++) return 1;
+   if ('[' == *q) {                              // params, inters, final
+      for (++q; 0x30 <= *q && *q <= 0x3f; q++) ;
+      for (; 0x20 <= *q && *q <= 0x2f; q++) ;
+      if (*q < 0x40 || 0x7e < *q) return -1;
+   } else {                                      // inters, final
+      for (; 0x20 <= *q && *q <= 0x2f; q++) ;
+      if (*q < 0x30 || 0x7e < *q) return -1;
+   }
+   return (const char *)q - p + 1;
+} // end: esc_len
+
+
+        /*
+         * A row_diff *Helper* function which locates each of a PUFF row's
+         * cells (up to Screen_cols), returning how many there are or -1
+         * should the row hold something we can't track.  Also returned are
+         * the offsets where the row proper begins and ends, excluding its
+         * leading or trailing newline. */
+static int row_cells (const char *row, CEL_t *cel, int *beg, int *end) {
+ #define fnvRESET(h) h = 0xcbf29ce484222325ull
+ #define fnvHASH(h,p,n) for (j = 0; j < n; j++) \
+   h = (h ^ (unsigned char)p[j]) * 0x100000001b3ull
+   int nrm = strlen(Cap_norm), eol = strlen(Cap_clr_eol);
+   int i, j, k, n = 0, rst = -1;
+   unsigned long long atr;
+
+   fnvRESET(atr);
+   for (i = 0; '\n' == row[i]; i++) ;
+   *beg = i;
+   for (*end = strlen(row); *end > i && '\n' == row[*end - 1]; --*end) ;
+   // a row must end by erasing the rest of its line, and only there
+   if (*end - i < eol || strncmp(&row[*end - eol], Cap_clr_eol, eol))
+      return -1;
+   while (i < *end - eol) {
+      if (!strncmp(&row[i], Cap_norm, nrm)) {
+         rst = i;
+         fnvRESET(atr);
+         fnvHASH(atr, (&row[i]), nrm);
+         i += nrm;
+         continue;
+      }
+      if (!strncmp(&row[i], Cap_clr_eol, eol)) return -1;
+      if (0 > (k = esc_len(&row[i]))) return -1;
+      if (k) {
+         fnvHASH(atr, (&row[i]), k);
+         i += k;
+         continue;
+      }
+      if (n < Screen_cols) {
+         cel[n].atr = atr;
+         cel[n].off = i;
+         cel[n].rst = rst;
+         ++n;
+      }
+      ++i;
+   }
+   return n;
+ #undef fnvHASH
+ #undef fnvRESET
+} // end: row_cells
+
+
+        /*
+         * This guy paints a PUFF row which differs from its prior version.
+         * Rather than the whole row, he'll send just the runs of cells that
+         * have changed, each preceded by a move to its column and whatever
+         * escapes are needed to restore its attributes.  But should that
+         * not be cheaper, or the row hold something we can't track, or the
+         * terminal not offer horizontal positioning, the whole row goes. */
+static void row_diff (const char *old, const char *row) {
+ // a run of unchanged cells shorter than this is just sent again
+ #define DIFF_GAP   8
+ #define isSAME(i)  ( i < nold && row[cnew[i].off] == old[cold[i].off] \
+   && cnew[i].atr == cold[i].atr )
+ #define outADD(s,n) { if (o + (n) >= lim) goto whole; \
+   memcpy(o, s, n); o += n; }
+ #define outSTR(s) { const char *_s = s; outADD(_s, (int)strlen(_s)) }
+   static CEL_t cold[SCREENMAX], cnew[SCREENMAX];
+   char buf[ROWMAXSIZ], *o = buf, *lim = buf + strlen(row);
+   int nrm = strlen(Cap_norm);
+   int nold, nnew, beg, end, col, dirty, i, j, k;
+
+   if (!*old || !Cap_can_goto || !column_address || !*Cap_norm
+   || 0 > (nold = row_cells(old, cold, &beg, &end))
+   || 0 > (nnew = row_cells(row, cnew, &beg, &end)))
+      goto whole;
+
+   outADD(row, beg)                              // any leading newline
+   for (col = dirty = i = 0; ; ) {
+      while (i < nnew && isSAME(i)) i++;
+      if (i >= nnew && i >= nold) break;
+      if (col != i) outSTR(tparm(column_address, i, 0, 0, 0, 0, 0, 0, 0, 0))
+      // with only old cells left, they need just be erased
+      if (i >= nnew) {
+         outSTR(Caps_endline)
+         dirty = 0;
+         break;
+      }
+      // restore the attributes in effect for this cell, since the last
+      // Cap_norm or (assumed to be in the same state) the row's start
+      if (0 > (k = cnew[i].rst)) {
+         outSTR(Caps_off)
+         k = beg;
+      }
+      while (k < cnew[i].off) {
+         if (!strncmp(&row[k], Cap_norm, nrm)) j = nrm;
+         else if (!(j = esc_len(&row[k]))) { ++k; continue; }
+         outADD(&row[k], j)
+         k += j;
+      }
+      // extend the run through any nearby changes
+      for (j = i + 1, k = i + 1; k < nnew && k - j < DIFF_GAP; k++)
+         if (!isSAME(k)) j = k + 1;
+      // going as far as the last cell, send the row's end (with its erase)
+      if (j >= nnew) {
+         outADD(&row[cnew[i].off], end - cnew[i].off)
+         dirty = 0;
+         break;
+      }
+      outADD(&row[cnew[i].off], cnew[j - 1].off + 1 - cnew[i].off)
+      dirty = 1;
+      col = i = j;
+   }
+   if (dirty) outSTR(Caps_off)
+   outSTR(&row[end])                             // any trailing newline
+   *o = '\0';
+   putp(buf);
+   return;
+whole:
+   putp(row);
+ #undef outSTR
+ #undef outADD
+ #undef isSAME
+ #undef DIFF_GAP
+} // end: row_diff
+#endif
+
+
         /*
          * Show an error message (caller may include '\a' for sound) */
 static void show_msg (const char *str) {
@@ -886,6 +1149,9 @@ static void updt_scroll_msg (void) {
    if (Curwin->varcolbeg)
       snprintf(tmp2, sizeof(tmp2), "%s + %d", tmp1, Curwin->varcolbeg);
 #endif
+   // the bytes are yet another format, to be resolved with the tasks
+   strcpy(tmp1, tmp2);
+   snprintf(tmp2, sizeof(tmp2), "%s, %s", tmp1, N_fmt(SCROLL_bytes_fmt));
    // this Scroll_fmts string no longer provides for termcap tgoto so that
    // the usage timing is critical -- see frame_make() for additional info
    snprintf(Scroll_fmts, sizeof(Scroll_fmts)
@@ -905,6 +1171,7 @@ static void *alloc_c (size_t num) {
    if (!num) ++num;
    if (!(pv = calloc(1, num)))
       error_exit(N_txt(FAIL_alloc_c_txt));
+   __atomic_fetch_add(&Frame_allocs, 1, __ATOMIC_RELAXED);
    return pv;
 } // end: alloc_c
 
@@ -916,6 +1183,7 @@ static void *alloc_r (void *ptr, size_t num) {
    if (!num) ++num;
    if (!(pv = realloc(ptr, num)))
       error_exit(N_txt(FAIL_alloc_r_txt));
+   __atomic_fetch_add(&Frame_allocs, 1, __ATOMIC_RELAXED);
    return pv;
 } // end: alloc_r
 
@@ -1665,6 +1933,50 @@ end_justifies:
  #undef DD
  #undef WW
 } // end: scale_tics
+
+
+        /*
+         * Make a sparkline of a task's most recent history ring samples,
+         * the newest at the right.  %CPU rises to the last step at 100%,
+         * while RES climbs from its own least to its own most (as trends,
+         * not sizes, are what matter) -- any resident memory at all is
+         * at least the first step, as is any %CPU. */
+static const char *spark_make (const proc_t *p, int cpu, int width) {
+   static const char steps[] = " .:-=+*#%@";
+ #define stpMAX  ( (int)sizeof(steps) - 2 )
+ #define smpCOL(n)  ( s * HRING_len + (Hring_col + HRING_len - (n)) % HRING_len )
+   static char buf[HRING_len + 1];
+   unsigned lo = ~0u, hi = 0, v;
+   int s = p->hist_slot, cnt, i;
+
+   if (width > HRING_len) width = HRING_len;
+   memset(buf, ' ', width);
+   buf[width] = '\0';
+   if ((unsigned)s >= (unsigned)Hring_used) return buf;
+   if ((cnt = Hring_cnt[s]) > width) cnt = width;
+   if (!cpu)
+      for (i = 0; i < cnt; i++) {
+         v = Hring_res[smpCOL(i)];
+         if (v < lo) lo = v;
+         if (v > hi) hi = v;
+      }
+   for (i = 0; i < cnt; i++) {
+      int n;
+      if (cpu) {
+         v = Hring_cpu[smpCOL(i)];
+         n = v >= 1000 ? stpMAX : (int)(v * stpMAX / 1000);
+      } else {
+         v = Hring_res[smpCOL(i)];
+         n = !v ? 0 : hi > lo
+            ? (int)((unsigned long long)(v - lo) * (stpMAX - 1) / (hi - lo)) + 1 : 1;
+      }
+      if (v && !n) n = 1;
+      buf[width - 1 - i] = steps[n];
+   }
+   return buf;
+ #undef stpMAX
+ #undef smpCOL
+} // end: spark_make
 
 /*######  Fields Management support  #####################################*/
 
@@ -1683,18 +1995,30 @@ end_justifies:
 #define L_NS       PROC_FILLNS
 #define L_LXC      PROC_FILL_LXC
 #define L_OOM      PROC_FILLOOM
+   // not from readproc at all, we'll batch the taskstats queries ourselves
+#define L_DELAY    PROC_SPARE_3
+   // read from numa_maps, for each task's memory by node
+#define L_NUMA     PROC_FILLNUMA
+   // nor these, whose history is ours (from times, faults & rss in 'stat')
+#define L_RING     PROC_SPARE_4
+#define L_HIST     L_RING | L_stat
    // make 'none' non-zero (used to be important to Frames_libflags)
 #define L_NONE     PROC_SPARE_1
    // from 'status' or 'stat' (favor stat), via bits not otherwise used
 #define L_EITHER   PROC_SPARE_2
    // for calibrate_fields and summary_show 1st pass
 #define L_DEFAULT  PROC_FILLSTAT
+   // costly extras, read only for rows shown (unless needed for sorting)
+#define L_LAZY     L_CGROUP | L_CMDLINE | L_ENVIRON | L_NS | L_LXC | L_OOM | L_NUMA
+   // what a recording (--record) holds at the least, whatever is shown
+#define L_RECORD   L_stat | L_statm | L_status | L_EUSER | L_CMDLINE
 
         /* These are our gosh darn 'Fields' !
            They MUST be kept in sync with pflags !! */
 static FLD_t Fieldstab[] = {
    // a temporary macro, soon to be undef'd...
  #define SF(f) (QFP_t)SCB_NAME(f)
+ #define SK(f) SCB_KEYS(f)
    // these identifiers reflect the default column alignment but they really
    // contain the WIN_t flag used to check/change justification at run-time!
  #define A_right Show_JRNUMS       /* toggled with upper case 'J' */
@@ -1709,71 +2033,82 @@ static FLD_t Fieldstab[] = {
         EU_CMD, L_stat - may yet require L_CMDLINE in calibrate_fields    (cmd/cmdline)
         L_EITHER       - favor L_stat (L_status == ++cost of gpref & hash scheme)
 
-     .width  .scale  .align    .sort     .lflg
-     ------  ------  --------  --------  --------  */
-   {     0,     -1,  A_right,  SF(PID),  L_NONE    },
-   {     0,     -1,  A_right,  SF(PPD),  L_EITHER  },
-   {     5,     -1,  A_right,  SF(UED),  L_NONE    },
-   {     8,     -1,  A_left,   SF(UEN),  L_EUSER   },
-   {     5,     -1,  A_right,  SF(URD),  L_status  },
-   {     8,     -1,  A_left,   SF(URN),  L_OUSER   },
-   {     5,     -1,  A_right,  SF(USD),  L_status  },
-   {     8,     -1,  A_left,   SF(USN),  L_OUSER   },
-   {     5,     -1,  A_right,  SF(GID),  L_NONE    },
-   {     8,     -1,  A_left,   SF(GRP),  L_EGROUP  },
-   {     0,     -1,  A_right,  SF(PGD),  L_stat    },
-   {     8,     -1,  A_left,   SF(TTY),  L_stat    },
-   {     0,     -1,  A_right,  SF(TPG),  L_stat    },
-   {     0,     -1,  A_right,  SF(SID),  L_stat    },
-   {     3,     -1,  A_right,  SF(PRI),  L_stat    },
-   {     3,     -1,  A_right,  SF(NCE),  L_stat    },
-   {     3,     -1,  A_right,  SF(THD),  L_EITHER  },
-   {     0,     -1,  A_right,  SF(CPN),  L_stat    },
-   {     0,     -1,  A_right,  SF(CPU),  L_stat    },
-   {     6,     -1,  A_right,  SF(TME),  L_stat    },
-   {     9,     -1,  A_right,  SF(TME),  L_stat    }, // EU_TM2 slot
+     .width  .scale  .align    .sort     .key      .lflg
+     ------  ------  --------  --------  --------  --------  */
+   {     0,     -1,  A_right,  SF(PID),  SK(PID),  L_NONE    },
+   {     0,     -1,  A_right,  SF(PPD),  SK(PPD),  L_EITHER  },
+   {     5,     -1,  A_right,  SF(UED),  SK(UED),  L_NONE    },
+   {     8,     -1,  A_left,   SF(UEN),  NULL,     L_EUSER   },
+   {     5,     -1,  A_right,  SF(URD),  SK(URD),  L_status  },
+   {     8,     -1,  A_left,   SF(URN),  NULL,     L_OUSER   },
+   {     5,     -1,  A_right,  SF(USD),  SK(USD),  L_status  },
+   {     8,     -1,  A_left,   SF(USN),  NULL,     L_OUSER   },
+   {     5,     -1,  A_right,  SF(GID),  SK(GID),  L_NONE    },
+   {     8,     -1,  A_left,   SF(GRP),  NULL,     L_EGROUP  },
+   {     0,     -1,  A_right,  SF(PGD),  SK(PGD),  L_stat    },
+   {     8,     -1,  A_left,   SF(TTY),  SK(TTY),  L_stat    },
+   {     0,     -1,  A_right,  SF(TPG),  SK(TPG),  L_stat    },
+   {     0,     -1,  A_right,  SF(SID),  SK(SID),  L_stat    },
+   {     3,     -1,  A_right,  SF(PRI),  SK(PRI),  L_stat    },
+   {     3,     -1,  A_right,  SF(NCE),  SK(NCE),  L_stat    },
+   {     3,     -1,  A_right,  SF(THD),  SK(THD),  L_EITHER  },
+   {     0,     -1,  A_right,  SF(CPN),  SK(CPN),  L_stat    },
+   {     0,     -1,  A_right,  SF(CPU),  SK(CPU),  L_stat    },
+   {     6,     -1,  A_right,  SF(TME),  SK(TME),  L_stat    },
+   {     9,     -1,  A_right,  SF(TME),  SK(TME),  L_stat    }, // EU_TM2 slot
 #ifdef BOOST_PERCNT
-   {     5,     -1,  A_right,  SF(RES),  L_statm   }, // EU_MEM slot
+   {     5,     -1,  A_right,  SF(RES),  SK(RES),  L_statm   }, // EU_MEM slot
 #else
-   {     4,     -1,  A_right,  SF(RES),  L_statm   }, // EU_MEM slot
+   {     4,     -1,  A_right,  SF(RES),  SK(RES),  L_statm   }, // EU_MEM slot
 #endif
-   {     7,  SK_Kb,  A_right,  SF(VRT),  L_statm   },
-   {     6,  SK_Kb,  A_right,  SF(SWP),  L_status  },
-   {     6,  SK_Kb,  A_right,  SF(RES),  L_statm   },
-   {     6,  SK_Kb,  A_right,  SF(COD),  L_statm   },
-   {     7,  SK_Kb,  A_right,  SF(DAT),  L_statm   },
-   {     6,  SK_Kb,  A_right,  SF(SHR),  L_statm   },
-   {     4,     -1,  A_right,  SF(FL1),  L_stat    },
-   {     4,     -1,  A_right,  SF(FL2),  L_stat    },
-   {     4,     -1,  A_right,  SF(DRT),  L_statm   },
-   {     1,     -1,  A_right,  SF(STA),  L_EITHER  },
-   {    -1,     -1,  A_left,   SF(CMD),  L_EITHER  },
-   {    10,     -1,  A_left,   SF(WCH),  L_stat    },
-   {     8,     -1,  A_left,   SF(FLG),  L_stat    },
-   {    -1,     -1,  A_left,   SF(CGR),  L_CGROUP  },
-   {    -1,     -1,  A_left,   SF(SGD),  L_status  },
-   {    -1,     -1,  A_left,   SF(SGN),  L_SUPGRP  },
-   {     0,     -1,  A_right,  SF(TGD),  L_NONE    },
-   {     5,     -1,  A_right,  SF(OOA),  L_OOM     },
-   {     4,     -1,  A_right,  SF(OOM),  L_OOM     },
-   {    -1,     -1,  A_left,   SF(ENV),  L_ENVIRON },
-   {     3,     -1,  A_right,  SF(FV1),  L_stat    },
-   {     3,     -1,  A_right,  SF(FV2),  L_stat    },
-   {     6,  SK_Kb,  A_right,  SF(USE),  L_status  },
-   {    10,     -1,  A_right,  SF(NS1),  L_NS      }, // IPCNS
-   {    10,     -1,  A_right,  SF(NS2),  L_NS      }, // MNTNS
-   {    10,     -1,  A_right,  SF(NS3),  L_NS      }, // NETNS
-   {    10,     -1,  A_right,  SF(NS4),  L_NS      }, // PIDNS
-   {    10,     -1,  A_right,  SF(NS5),  L_NS      }, // USERNS
-   {    10,     -1,  A_right,  SF(NS6),  L_NS      }, // UTSNS
-   {     8,     -1,  A_left,   SF(LXC),  L_LXC     },
-   {     6,  SK_Kb,  A_right,  SF(RZA),  L_status  },
-   {     6,  SK_Kb,  A_right,  SF(RZF),  L_status  },
-   {     6,  SK_Kb,  A_right,  SF(RZL),  L_status  },
-   {     6,  SK_Kb,  A_right,  SF(RZS),  L_status  },
-   {    -1,     -1,  A_left,   SF(CGN),  L_CGROUP  },
-   {     0,     -1,  A_right,  SF(NMA),  L_stat    },
+   {     7,  SK_Kb,  A_right,  SF(VRT),  SK(VRT),  L_statm   },
+   {     6,  SK_Kb,  A_right,  SF(SWP),  SK(SWP),  L_status  },
+   {     6,  SK_Kb,  A_right,  SF(RES),  SK(RES),  L_statm   },
+   {     6,  SK_Kb,  A_right,  SF(COD),  SK(COD),  L_statm   },
+   {     7,  SK_Kb,  A_right,  SF(DAT),  SK(DAT),  L_statm   },
+   {     6,  SK_Kb,  A_right,  SF(SHR),  SK(SHR),  L_statm   },
+   {     4,     -1,  A_right,  SF(FL1),  SK(FL1),  L_stat    },
+   {     4,     -1,  A_right,  SF(FL2),  SK(FL2),  L_stat    },
+   {     4,     -1,  A_right,  SF(DRT),  SK(DRT),  L_statm   },
+   {     1,     -1,  A_right,  SF(STA),  SK(STA),  L_EITHER  },
+   {    -1,     -1,  A_left,   SF(CMD),  NULL,     L_EITHER  },
+   {    10,     -1,  A_left,   SF(WCH),  SK(WCH),  L_stat    },
+   {     8,     -1,  A_left,   SF(FLG),  SK(FLG),  L_stat    },
+   {    -1,     -1,  A_left,   SF(CGR),  NULL,     L_CGROUP  },
+   {    -1,     -1,  A_left,   SF(SGD),  NULL,     L_status  },
+   {    -1,     -1,  A_left,   SF(SGN),  NULL,     L_SUPGRP  },
+   {     0,     -1,  A_right,  SF(TGD),  SK(TGD),  L_NONE    },
+   {     5,     -1,  A_right,  SF(OOA),  SK(OOA),  L_OOM     },
+   {     4,     -1,  A_right,  SF(OOM),  SK(OOM),  L_OOM     },
+   {    -1,     -1,  A_left,   SF(ENV),  NULL,     L_ENVIRON },
+   {     3,     -1,  A_right,  SF(FV1),  SK(FV1),  L_stat    },
+   {     3,     -1,  A_right,  SF(FV2),  SK(FV2),  L_stat    },
+   {     6,  SK_Kb,  A_right,  SF(USE),  SK(USE),  L_status  },
+   {    10,     -1,  A_right,  SF(NS1),  SK(NS1),  L_NS      }, // IPCNS
+   {    10,     -1,  A_right,  SF(NS2),  SK(NS2),  L_NS      }, // MNTNS
+   {    10,     -1,  A_right,  SF(NS3),  SK(NS3),  L_NS      }, // NETNS
+   {    10,     -1,  A_right,  SF(NS4),  SK(NS4),  L_NS      }, // PIDNS
+   {    10,     -1,  A_right,  SF(NS5),  SK(NS5),  L_NS      }, // USERNS
+   {    10,     -1,  A_right,  SF(NS6),  SK(NS6),  L_NS      }, // UTSNS
+   {     8,     -1,  A_left,   SF(LXC),  NULL,     L_LXC     },
+   {     6,  SK_Kb,  A_right,  SF(RZA),  SK(RZA),  L_status  },
+   {     6,  SK_Kb,  A_right,  SF(RZF),  SK(RZF),  L_status  },
+   {     6,  SK_Kb,  A_right,  SF(RZL),  SK(RZL),  L_status  },
+   {     6,  SK_Kb,  A_right,  SF(RZS),  SK(RZS),  L_status  },
+   {    -1,     -1,  A_left,   SF(CGN),  NULL,     L_CGROUP  },
+   {     0,     -1,  A_right,  SF(NMA),  SK(NMA),  L_stat    },
+   {     4,     -1,  A_right,  SF(DLC),  SK(DLC),  L_DELAY   },
+   {     4,     -1,  A_right,  SF(DLB),  SK(DLB),  L_DELAY   },
+   {     4,     -1,  A_right,  SF(DLS),  SK(DLS),  L_DELAY   },
+   {     4,     -1,  A_right,  SF(DLR),  SK(DLR),  L_DELAY   },
+   {     5,     -1,  A_right,  SF(CPA),  SK(CPA),  L_HIST    },
+   {     0,     -1,  A_left,   SF(CPA),  SK(CPA),  L_HIST    }, // EU_CPG slot
+   {     0,     -1,  A_left,   SF(RSG),  SK(RSG),  L_HIST    },
+   {     4,     -1,  A_right,  SF(FLA),  SK(FLA),  L_HIST    },
+   {     0,     -1,  A_right,  SF(NMP),  SK(NMP),  L_NUMA    },
+   {    -1,     -1,  A_left,   SF(NMK),  SK(NMK),  L_NUMA    },
  #undef SF
+ #undef SK
  #undef A_left
  #undef A_right
 };
@@ -1876,9 +2211,9 @@ static void build_headers (void) {
 #ifdef EQUCOLHDRYES
    int x, hdrmax = 0;
 #endif
-   int i;
+   int i, srtflags = 0;
 
-   Frames_libflags = 0;
+   Frames_libflags = Frames_grpflags = 0;
 
    do {
       if (VIZISw(w)) {
@@ -1914,10 +2249,15 @@ static void build_headers (void) {
          if (CHKw(w, Show_FOREST)) Frames_libflags |= L_stat;
          // for 'busy' only processes, we'll need pcpu (utime & stime)...
          if (!CHKw(w, Show_IDLEPS)) Frames_libflags |= L_stat;
+         // for task groups, each task's cgroup or container (at least)...
+         if (CHKw(w, Show_GRPCGR)) Frames_libflags |= L_CGROUP;
+         if (CHKw(w, Show_GRPLXC)) Frames_libflags |= L_LXC;
+         Frames_grpflags |= CHKw(w, Show_GROUPS);
          // we must also accommodate an out of view sort field...
          f = w->rc.sortindx;
-         Frames_libflags |= Fieldstab[f].lflg;
-         if (EU_CMD == f && CHKw(w, Show_CMDLIN)) Frames_libflags |= L_CMDLINE;
+         srtflags |= Fieldstab[f].lflg;
+         if (EU_CMD == f && CHKw(w, Show_CMDLIN)) srtflags |= L_CMDLINE;
+         Frames_libflags |= srtflags;
       } // end: VIZISw(w)
 
       if (Rc.mode_altscr) w = w->next;
@@ -1936,12 +2276,22 @@ static void build_headers (void) {
 #endif
 
    // finalize/touchup the libproc PROC_FILLxxx flags for current config...
+   // ( with those not needed to sort deferred 'til a task is to be shown )
+   Frames_lazflags = Frames_libflags & (L_LAZY) & ~srtflags;
+   Frames_libflags &= ~Frames_lazflags;
+   // ( but a recording is of whole tasks, with at least the usual fields )
+   // ( as are tasks totaled by group, since a group's row may need any field )
+   if (Rec_mode || Frames_grpflags) {
+      Frames_libflags |= Frames_lazflags | (REC_save == Rec_mode ? L_RECORD : 0);
+      Frames_lazflags = 0;
+   }
    if (Frames_libflags & L_EITHER) {
       if (!(Frames_libflags & (L_stat | L_status)))
          Frames_libflags |= L_stat;
    }
    if (!Frames_libflags) Frames_libflags = L_DEFAULT;
    if (Monpidsidx) Frames_libflags |= PROC_PID;
+   if (Moncgrpsidx) Frames_libflags |= PROC_CGROUP | PROC_CGRPTREE;
 } // end: build_headers
 
 
@@ -2267,8 +2617,10 @@ static void zap_fieldstab (void) {
       Fieldstab[EU_CPN].width = digits;
    }
    Fieldstab[EU_NMA].width = 2;
+   Fieldstab[EU_NMP].width = 3;
    if (2 < (digits = (unsigned)snprintf(buf, sizeof(buf), "%u", (unsigned)Numa_node_tot))) {
       Fieldstab[EU_NMA].width = digits;
+      if (3 < digits) Fieldstab[EU_NMP].width = digits;
    }
 
 #ifdef BOOST_PERCNT
@@ -2296,6 +2648,9 @@ static void zap_fieldstab (void) {
    }
 #endif
 
+   /* the sparklines show as many of the latest samples as they can */
+   Fieldstab[EU_CPG].width = Fieldstab[EU_RSG].width = HRING_spark;
+
    /* and accommodate optional wider non-scalable columns (maybe) */
    if (!AUTOX_MODE) {
       int i;
@@ -2312,6 +2667,10 @@ static void zap_fieldstab (void) {
       for (i = EU_NS1; i < EU_NS1 + NUM_NS; i++)
          Fieldstab[i].width
             = Rc.fixed_widest ? 10 + Rc.fixed_widest : 10;
+      Fieldstab[EU_CPG].width = Fieldstab[EU_RSG].width
+         = Rc.fixed_widest ? HRING_spark + Rc.fixed_widest : HRING_spark;
+      if (Fieldstab[EU_CPG].width > HRING_len)
+         Fieldstab[EU_CPG].width = Fieldstab[EU_RSG].width = HRING_len;
    }
 
    /* plus user selectable scaling */
@@ -2326,6 +2685,730 @@ static void zap_fieldstab (void) {
    calibrate_fields();
 } // end: zap_fieldstab
 
+/*######  Record and Replay  #############################################*/
+
+        /*
+         * These are the proc_t fields a recording holds, which is all that
+         * libproc fills in (less the signal masks and the systemd names).
+         * Strings are held as the id of a string interned by that frame or
+         * one before it (back to the key frame) and vectors as their first
+         * string, since each vector we ask for is converted to just one. */
+#define RecN(f) { offsetof(proc_t, f), sizeof(((proc_t *)0)->f), RF_num }
+#define RecA(f) { offsetof(proc_t, f), sizeof(((proc_t *)0)->f), RF_arr }
+#define RecP(f) { offsetof(proc_t, f), 0, RF_ptr }
+#define RecV(f) { offsetof(proc_t, f), 0, RF_vec }
+static const struct {
+   unsigned short ofs, siz, typ;
+} Rec_flds[] = {
+   RecN(tid),          RecN(ppid),         RecN(state),        RecN(utime),
+   RecN(stime),        RecN(cutime),       RecN(cstime),       RecN(start_time),
+   RecN(start_code),   RecN(end_code),     RecN(start_stack),  RecN(kstk_esp),
+   RecN(kstk_eip),     RecN(wchan),        RecN(priority),     RecN(nice),
+   RecN(rss),          RecN(alarm),        RecN(size),         RecN(resident),
+   RecN(share),        RecN(trs),          RecN(lrs),          RecN(drs),
+   RecN(dt),           RecN(vm_size),      RecN(vm_lock),      RecN(vm_rss),
+   RecN(vm_rss_anon),  RecN(vm_rss_file),  RecN(vm_rss_shared),RecN(vm_data),
+   RecN(vm_stack),     RecN(vm_swap),      RecN(vm_exe),       RecN(vm_lib),
+   RecN(rtprio),       RecN(sched),        RecN(vsize),        RecN(rss_rlim),
+   RecN(flags),        RecN(min_flt),      RecN(maj_flt),      RecN(cmin_flt),
+   RecN(cmaj_flt),     RecN(pgrp),         RecN(session),      RecN(nlwp),
+   RecN(tgid),         RecN(tty),          RecN(euid),         RecN(egid),
+   RecN(ruid),         RecN(rgid),         RecN(suid),         RecN(sgid),
+   RecN(fuid),         RecN(fgid),         RecN(tpgid),        RecN(exit_signal),
+   RecN(processor),    RecN(oom_score),    RecN(oom_adj),      RecN(ns[IPCNS]),
+   RecN(ns[MNTNS]),    RecN(ns[NETNS]),    RecN(ns[PIDNS]),    RecN(ns[USERNS]),
+   RecN(ns[UTSNS]),    RecN(delay_cpu),    RecN(delay_blkio),  RecN(delay_swapin),
+   RecN(delay_freepages), RecN(numa_pref),  RecN(numa_kb),
+   RecA(euser),        RecA(ruser),        RecA(suser),        RecA(fuser),
+   RecA(rgroup),       RecA(egroup),       RecA(sgroup),       RecA(fgroup),
+   RecA(cmd),
+   RecP(cgname),       RecP(supgid),       RecP(supgrp),       RecP(lxcname),
+   RecP(numa_nodes),
+   RecV(cmdline),      RecV(cgroup),       RecV(environ)
+};
+#undef RecN
+#undef RecA
+#undef RecP
+#undef RecV
+#define REC_NFLD  (int)MAXTBL(Rec_flds)
+
+        /* deltas, as signed values, are zigzagged so small ones stay small */
+#define ZIGzag(d)  ( ((d) << 1) ^ (0 - ((d) >> 63)) )
+#define ZAGzig(z)  ( ((z) >> 1) ^ (0 - ((z) & 1)) )
+
+
+        /*
+         * Add some bytes to one of the frame buffers rec_save is building,
+         * where buffer 0 holds the REC_frm plus strings and 1 the rest. */
+static void rec_raw (int b, const void *src, size_t len) {
+   if (Rec_blen[b] + len > Rec_bsiz[b]) {
+      Rec_bsiz[b] = Rec_bsiz[b] * 2 + len + BIGBUFSIZ;
+      Rec_buf[b] = alloc_r(Rec_buf[b], Rec_bsiz[b]);
+   }
+   memcpy(Rec_buf[b] + Rec_blen[b], src, len);
+   Rec_blen[b] += len;
+} // end: rec_raw
+
+
+        /*
+         * Add a varint, 7 bits at a time, to rec_save's second buffer. */
+static inline void rec_put (unsigned long long v) {
+   unsigned char tmp[10];
+   int n = 0;
+
+   while (v > 0x7f) {
+      tmp[n++] = (unsigned char)(v | 0x80);
+      v >>= 7;
+   }
+   tmp[n++] = (unsigned char)v;
+   rec_raw(1, tmp, n);
+} // end: rec_put
+
+
+        /*
+         * Take a varint from the frame rec_decode is working on.  If it's
+         * not all there, Rec_ptr becomes NULL (which he'll then notice). */
+static inline unsigned long long rec_get (void) {
+   unsigned long long v = 0;
+   int s;
+
+   for (s = 0; Rec_ptr < Rec_end && s < 64; s += 7) {
+      v |= (unsigned long long)(*Rec_ptr & 0x7f) << s;
+      if (!(*Rec_ptr++ & 0x80)) return v;
+   }
+   Rec_ptr = Rec_end = NULL;
+   return 0;
+} // end: rec_get
+
+
+        /*
+         * Add a vector of values as its changes from an older one (or from
+         * zeros), each as the distance from the last value to have changed
+         * followed by the zigzagged delta.  A zero distance ends the lot. */
+static void rec_vput (const unsigned long long *v, const unsigned long long *old, int n) {
+   unsigned long long d;
+   int i, last = -1;
+
+   for (i = 0; i < n; i++) {
+      if (!(d = v[i] - (old ? old[i] : 0)))
+         continue;
+      rec_put(i - last);
+      rec_put(ZIGzag(d));
+      last = i;
+   }
+   rec_put(0);
+} // end: rec_vput
+
+
+        /*
+         * The reverse of rec_vput, where the vector and the older one may
+         * well be one and the same. */
+static void rec_vget (unsigned long long *v, const unsigned long long *old, int n) {
+   unsigned long long gap, z;
+   int i = -1;
+
+   if (!old) memset(v, 0, sizeof(*v) * n);
+   else if (v != old) memcpy(v, old, sizeof(*v) * n);
+   while ((gap = rec_get())) {
+      if (gap >= (unsigned)(n - i)) {
+         Rec_ptr = Rec_end = NULL;
+         return;
+      }
+      i += gap;
+      z = rec_get();
+      v[i] += ZAGzig(z);
+   }
+} // end: rec_vget
+
+
+        /*
+         * A simple string hash, for rec_intern's table (and groups_add's). */
+static inline unsigned rec_hash (const char *s) {
+   unsigned h = 5381;
+
+   while (*s) h = h * 33 + (unsigned char)*s++;
+   return h;
+} // end: rec_hash
+
+
+        /*
+         * Return a string's id, issuing a new one if it hasn't been seen
+         * since the key frame (whereupon it joins the frame being built).
+         * The string is most often just what the task had last time. */
+static unsigned rec_intern (const char *s, unsigned old) {
+   unsigned i, j;
+
+   if (!s) return 0;
+   if (old && !strcmp(Rec_strs[old], s)) return old;
+   for (i = rec_hash(s) & Rec_smsk; Rec_shsh[i]; i = (i + 1) & Rec_smsk)
+      if (!strcmp(Rec_strs[Rec_shsh[i]], s)) return Rec_shsh[i];
+
+   // a new one then, which may need more room (the table's kept half empty)
+   if (Rec_nstr >= Rec_astr) {
+      Rec_astr = Rec_astr * 2 + 1024;
+      Rec_strs = alloc_r(Rec_strs, sizeof(char *) * Rec_astr);
+   }
+   if (Rec_nstr * 2 > Rec_smsk) {
+      Rec_smsk = Rec_smsk * 2 + 1;
+      Rec_shsh = alloc_r(Rec_shsh, sizeof(int) * (Rec_smsk + 1));
+      memset(Rec_shsh, 0, sizeof(int) * (Rec_smsk + 1));
+      for (j = 1; j < (unsigned)Rec_nstr; j++) {
+         for (i = rec_hash(Rec_strs[j]) & Rec_smsk; Rec_shsh[i]; i = (i + 1) & Rec_smsk) ;
+         Rec_shsh[i] = j;
+      }
+      for (i = rec_hash(s) & Rec_smsk; Rec_shsh[i]; i = (i + 1) & Rec_smsk) ;
+   }
+   Rec_strs[Rec_nstr] = alloc_s(s);
+   Rec_shsh[i] = Rec_nstr;
+   rec_raw(0, s, strlen(s) + 1);
+   return Rec_nstr++;
+} // end: rec_intern
+
+
+        /*
+         * Gather a task's values for rec_save, as numbers or string ids. */
+static void rec_vals (const proc_t *p, unsigned long long *v, const unsigned long long *old) {
+   const char *a, *s;
+   char **vec;
+   int i;
+
+   for (i = 0; i < REC_NFLD; i++) {
+      a = (const char *)p + Rec_flds[i].ofs;
+      switch (Rec_flds[i].typ) {
+         case RF_num:
+            switch (Rec_flds[i].siz) {
+               case 1: v[i] = *(const signed char *)a; break;
+               case 2: v[i] = *(const short *)a; break;
+               case 4: v[i] = *(const int *)a; break;
+               default: v[i] = *(const unsigned long long *)a; break;
+            }
+            continue;
+         case RF_arr:
+            s = a;
+            break;
+         case RF_ptr:
+            s = *(const char * const *)a;
+            break;
+         default:
+            vec = *(char ** const *)a;
+            s = vec ? *vec : NULL;
+            break;
+      }
+      v[i] = rec_intern(s, old ? old[i] : 0);
+   }
+} // end: rec_vals
+
+
+        /*
+         * Find the prior frame's index for a tid, expected to be just past
+         * the last one found since both frames will usually be in the same
+         * order (else -1, as with a task that's new). */
+static int rec_base (int tid, int want) {
+   unsigned i;
+
+   if (want < Rec_nsav && tid == (int)Rec_sav[want * REC_NFLD])
+      return want;
+   if (!Rec_nsav) return -1;
+   for (i = (unsigned)tid & Rec_tmsk; Rec_thsh[i] >= 0; i = (i + 1) & Rec_tmsk)
+      if (tid == (int)Rec_sav[Rec_thsh[i] * REC_NFLD])
+         return Rec_thsh[i];
+   return -1;
+} // end: rec_base
+
+
+        /*
+         * Save a frame, just sampled and not yet touched by procs_hlp, to
+         * the recording -- with the summary values as they stand now.  Every
+         * REC_KEYFRM frames one is saved whole, which replays may start at. */
+static void rec_save (proc_t **ppt, int n) {
+ #define sysMAX  ( RS_MAX + smp_num_cpus + (1 + Cpu_faux_tot) * 9 + Node_tot * 8 )
+   static unsigned long long *sys;
+   static const REC_frm none;
+   static const char pad[8];
+   static int nsys;
+   unsigned long long *v, *old, *t;
+   struct iovec iov[3];
+   struct timeval tv;
+   double up, av[3];
+   REC_frm *f;
+   int i, j, base, key, first;
+   ssize_t len;
+
+   if ((key = !Rec_frames)) {
+      for (i = 1; i < Rec_nstr; i++)
+         free((void *)Rec_strs[i]);
+      if (Rec_shsh) memset(Rec_shsh, 0, sizeof(int) * (Rec_smsk + 1));
+      else Rec_shsh = alloc_c(sizeof(int) * ((Rec_smsk = 4095) + 1));
+      Rec_nstr = 1;
+      Rec_nsav = 0;
+   }
+   if (++Rec_frames >= REC_KEYFRM) Rec_frames = 0;
+   first = Rec_nstr;
+   Rec_blen[0] = Rec_blen[1] = 0;
+   rec_raw(0, &none, sizeof(none));               // (filled in at the end)
+
+   // the summary values, then those for each cpu and /proc/stat line...
+   gettimeofday(&tv, NULL);
+   uptime(&up, NULL);
+   loadavg(&av[0], &av[1], &av[2]);
+   if (nsys < sysMAX) sys = alloc_r(sys, sizeof(*sys) * (nsys = sysMAX));
+   sys[RS_uptime] = up * 100;
+   sys[RS_load1]  = av[0] * 100 + .5;
+   sys[RS_load5]  = av[1] * 100 + .5;
+   sys[RS_load15] = av[2] * 100 + .5;
+   sys[RS_upline] = rec_intern(sprint_uptime(0), 0);
+   sys[RS_ncpus]  = smp_num_cpus;
+   sys[RS_nodes]  = Numa_node_tot;
+   sys[RS_lines]  = Cpu_faux_tot;
+   sys[RS_mnodes] = Node_tot;
+   sys[RS_mtotal] = kb_main_total;   sys[RS_mfree]  = kb_main_free;
+   sys[RS_mused]  = kb_main_used;    sys[RS_mbuffs] = kb_main_buffers;
+   sys[RS_mcache] = kb_main_cached;  sys[RS_mavail] = kb_main_available;
+   sys[RS_stotal] = kb_swap_total;   sys[RS_sfree]  = kb_swap_free;
+   sys[RS_sused]  = kb_swap_used;
+   sys[RS_psi]    = Psi_have;
+   for (i = 0; i < PSI_MAX; i++) {
+      sys[RS_psome + i] = Psi_now.some[i];
+      sys[RS_pfull + i] = Psi_now.full[i];
+   }
+   sys[RS_pstamp] = Psi_now.stamp;
+   for (i = 0; i < smp_num_cpus; i++)
+      sys[RS_MAX + i] = NUMA_NODE(i) + 1;
+   for (i = 0; i <= Cpu_faux_tot; i++) {
+      const CPU_t *c = &Cpu_tics[i ? i - 1 : smp_num_cpus];
+      t = &sys[RS_MAX + smp_num_cpus + i * 9];
+      t[0] = i ? c->id + 1 : 0;
+      t[1] = c->cur.u; t[2] = c->cur.n; t[3] = c->cur.s; t[4] = c->cur.i;
+      t[5] = c->cur.w; t[6] = c->cur.x; t[7] = c->cur.y; t[8] = c->cur.z;
+   }
+   t = &sys[RS_MAX + smp_num_cpus + (1 + Cpu_faux_tot) * 9];
+   for (i = 0; i < Node_tot; i++, t += 8) {
+      const node_mem *m = &Node_now[i];
+      t[0] = m->total; t[1] = m->free;  t[2] = m->file;  t[3] = m->anon;
+      t[4] = m->hit;   t[5] = m->miss;  t[6] = m->local; t[7] = m->other;
+   }
+   j = sysMAX;
+   rec_put(j);
+   rec_vput(sys, key || j != Rec_nsys ? NULL : Rec_sys, j);
+   if (Rec_nsys < j) Rec_sys = alloc_r(Rec_sys, sizeof(*sys) * j);
+   memcpy(Rec_sys, sys, sizeof(*sys) * (Rec_nsys = j));
+
+   // then the tasks, each as its change from last time (when there was one)
+   if (n > Rec_ntsk) {
+      Rec_ntsk = n + n / 4 + 100;
+      Rec_sav = alloc_r(Rec_sav, sizeof(*v) * REC_NFLD * Rec_ntsk);
+      Rec_new = alloc_r(Rec_new, sizeof(*v) * REC_NFLD * Rec_ntsk);
+   }
+   for (i = 0, base = -1; i < n; i++) {
+      v = &Rec_new[i * REC_NFLD];
+      if (0 > (j = rec_base(ppt[i]->tid, base + 1))) {
+         old = NULL;
+         rec_put(0);
+      } else {
+         old = &Rec_sav[j * REC_NFLD];
+         rec_put(ZIGzag((unsigned long long)(long long)(j - (base + 1))) + 1);
+         base = j;
+      }
+      rec_vals(ppt[i], v, old);
+      rec_vput(v, old, REC_NFLD);
+   }
+   v = Rec_sav; Rec_sav = Rec_new; Rec_new = v;
+   Rec_nsav = n;
+
+   // with the tids hashed, for finding those bases next time
+   if (!Rec_thsh || Rec_tmsk < 2 * n) {
+      for (Rec_tmsk = 1023; Rec_tmsk < 2 * n; Rec_tmsk = Rec_tmsk * 2 + 1) ;
+      Rec_thsh = alloc_r(Rec_thsh, sizeof(int) * (Rec_tmsk + 1));
+   }
+   memset(Rec_thsh, -1, sizeof(int) * (Rec_tmsk + 1));
+   for (i = 0; i < n; i++) {
+      for (j = (unsigned)ppt[i]->tid & Rec_tmsk; Rec_thsh[j] >= 0; j = (j + 1) & Rec_tmsk) ;
+      Rec_thsh[j] = i;
+   }
+
+   // lastly the header, and off it all goes (padded to 8 bytes)
+   f = (REC_frm *)Rec_buf[0];
+   len = Rec_blen[0] + Rec_blen[1];
+   f->magic = REC_FRMMAG;
+   f->len = len + (8 - len % 8) % 8;
+   f->usecs = (unsigned long long)tv.tv_sec * 1000000 + tv.tv_usec;
+   f->flags = (key ? REC_fKEY : 0) | (Thread_mode ? REC_fTHD : 0);
+   f->ntasks = n;
+   f->nstrs = Rec_nstr - first;
+   f->slen = Rec_blen[0] - sizeof(REC_frm);
+   iov[0].iov_base = Rec_buf[0]; iov[0].iov_len = Rec_blen[0];
+   iov[1].iov_base = Rec_buf[1]; iov[1].iov_len = Rec_blen[1];
+   iov[2].iov_base = (void *)pad; iov[2].iov_len = f->len - len;
+   if ((ssize_t)f->len != writev(Rec_fd, iov, 3))
+      error_exit(fmtmk(N_fmt(RECORD_failed_fmt), Rec_path, strerror(errno)));
+ #undef sysMAX
+} // end: rec_save
+
+
+        /*
+         * Step through a recording's frames, by their headers alone, to
+         * find where the last whole one ends (and note the key frames). */
+static size_t rec_walk (const char *map, size_t len, int keys) {
+   const REC_frm *f;
+   size_t pos = sizeof(REC_hdr);
+
+   while (pos + sizeof(REC_frm) <= len) {
+      f = (const REC_frm *)(map + pos);
+      if (REC_FRMMAG != f->magic || sizeof(REC_frm) > f->len
+      || f->len % 8 || f->len > len - pos)
+         break;
+      if (keys && f->flags & REC_fKEY) {
+         Rec_keys = alloc_r(Rec_keys, sizeof(size_t) * (Rec_nkey + 1));
+         Rec_keys[Rec_nkey++] = pos;
+      }
+      pos += f->len;
+   }
+   return pos;
+} // end: rec_walk
+
+
+        /*
+         * Decode the frame at Rec_pos into Rec_sys and Rec_sav, from the
+         * frame before it unless it's a key frame, then step past it.  If
+         * it doesn't decode as it should, that's the end of the replay. */
+static void rec_decode (void) {
+   const REC_frm *f = (const REC_frm *)(Rec_map + Rec_pos);
+   const char *s, *end;
+   const unsigned long long *old;
+   unsigned long long *v, ref;
+   unsigned i, n;
+   int j, base, key;
+
+   // the new strings, used just where they lie in the mapped file...
+   if ((key = f->flags & REC_fKEY)) Rec_nstr = 1;
+   s = (const char *)(f + 1);
+   if (f->slen > f->len - sizeof(REC_frm)) goto bad_frame;
+   end = s + f->slen;
+   if (Rec_nstr + f->nstrs > (unsigned)Rec_astr) {
+      if (f->nstrs > f->slen) goto bad_frame;
+      Rec_astr = Rec_nstr + f->nstrs + 1024;
+      Rec_strs = alloc_r(Rec_strs, sizeof(char *) * Rec_astr);
+      Rec_vecs = alloc_r(Rec_vecs, sizeof(char *) * 2 * Rec_astr);
+   }
+   for (i = 0; i < f->nstrs; i++) {
+      n = strnlen(s, end - s);
+      if (s + n >= end) goto bad_frame;
+      Rec_vecs[2 * Rec_nstr] = (char *)s;
+      Rec_vecs[2 * Rec_nstr + 1] = NULL;
+      Rec_strs[Rec_nstr++] = s;
+      s += n + 1;
+   }
+   Rec_ptr = (const unsigned char *)end;
+   Rec_end = (const unsigned char *)f + f->len;
+
+   // then the summary values, whose number depends on the cpus...
+   n = rec_get();
+   if (RS_MAX > n || n > (1u << 20)) goto bad_frame;
+   if ((int)n > Rec_nsys) Rec_sys = alloc_r(Rec_sys, sizeof(*Rec_sys) * n);
+   rec_vget(Rec_sys, key || (int)n != Rec_nsys ? NULL : Rec_sys, n);
+   Rec_nsys = n;
+   if (!Rec_ptr || Rec_sys[RS_upline] >= (unsigned)Rec_nstr
+   || Rec_sys[RS_ncpus] > (1u << 16) || Rec_sys[RS_lines] > Rec_sys[RS_ncpus]
+   || Rec_sys[RS_mnodes] > (1u << 16)
+   || n != RS_MAX + Rec_sys[RS_ncpus] + (1 + Rec_sys[RS_lines]) * 9 + Rec_sys[RS_mnodes] * 8)
+      goto bad_frame;
+
+   // and lastly the tasks, each from the one it was in the prior frame
+   if (f->ntasks > f->len) goto bad_frame;
+   if ((int)f->ntasks > Rec_ntsk) {
+      Rec_ntsk = f->ntasks + f->ntasks / 4 + 100;
+      Rec_sav = alloc_r(Rec_sav, sizeof(*v) * REC_NFLD * Rec_ntsk);
+      Rec_new = alloc_r(Rec_new, sizeof(*v) * REC_NFLD * Rec_ntsk);
+   }
+   for (i = 0, base = -1; i < f->ntasks; i++) {
+      old = NULL;
+      if ((ref = rec_get())) {
+         j = base + 1 + (long long)ZAGzig(ref - 1);
+         if (key || 0 > j || j >= Rec_nsav) goto bad_frame;
+         old = &Rec_sav[j * REC_NFLD];
+         base = j;
+      }
+      rec_vget(&Rec_new[i * REC_NFLD], old, REC_NFLD);
+   }
+   if (!Rec_ptr) goto bad_frame;
+   v = Rec_sav; Rec_sav = Rec_new; Rec_new = v;
+   Rec_nsav = f->ntasks;
+   Rec_frm = f;
+   Rec_pos += f->len;
+   return;
+
+bad_frame:
+   error_exit(fmtmk(N_fmt(REPLAY_badfile_fmt), Rec_path));
+} // end: rec_decode
+
+
+        /*
+         * Make a proc_t of a task's recorded values, where any string that
+         * wasn't recorded (or was recorded as NULL) becomes a "-". */
+static void rec_task (proc_t *p, const unsigned long long *v) {
+   static char dash[] = "-", *dashes[] = { dash, NULL };
+   char *a;
+   int i;
+
+   memset(p, 0, sizeof(*p));
+   for (i = 0; i < REC_NFLD; i++) {
+      a = (char *)p + Rec_flds[i].ofs;
+      if (RF_num == Rec_flds[i].typ) {
+         switch (Rec_flds[i].siz) {
+            case 1: *(signed char *)a = v[i]; break;
+            case 2: *(short *)a = v[i]; break;
+            case 4: *(int *)a = v[i]; break;
+            default: *(unsigned long long *)a = v[i]; break;
+         }
+         continue;
+      }
+      if (v[i] >= (unsigned)Rec_nstr) continue;        // (a bad id ignored)
+      switch (Rec_flds[i].typ) {
+         case RF_arr:
+            if (v[i]) snprintf(a, Rec_flds[i].siz, "%s", Rec_strs[v[i]]);
+            break;
+         case RF_ptr:
+            *(const char **)a = v[i] ? Rec_strs[v[i]] : dash;
+            break;
+         default:
+            *(char ***)a = v[i] ? &Rec_vecs[2 * v[i]] : dashes;
+            break;
+      }
+   }
+} // end: rec_task
+
+
+        /*
+         * Replay the next frame, restoring what libproc would have given us
+         * and all our refresh functions would have found.  At the end of
+         * the recording we hold the last frame (and say so, returning 0). */
+static int rec_next (void) {
+   const unsigned long long *s;
+   proc_t *p;
+   int i, j;
+
+   if (Rec_pos >= Rec_len) {
+      Rec_held = 1;
+      return 0;
+   }
+   rec_decode();
+   s = Rec_sys;
+   kb_main_total   = s[RS_mtotal];   kb_main_free  = s[RS_mfree];
+   kb_main_used    = s[RS_mused];    kb_main_buffers = s[RS_mbuffs];
+   kb_main_cached  = s[RS_mcache];   kb_main_available = s[RS_mavail];
+   kb_swap_total   = s[RS_stotal];   kb_swap_free  = s[RS_sfree];
+   kb_swap_used    = s[RS_sused];
+   smp_num_cpus    = s[RS_ncpus];
+   Numa_node_tot   = s[RS_nodes];
+   if (Numa_cpu_tot != smp_num_cpus) {
+      Numa_cpu_tot = smp_num_cpus;
+      Numa_cpu_node = alloc_r(Numa_cpu_node, sizeof(int) * Numa_cpu_tot);
+   }
+   for (i = 0; i < Numa_cpu_tot; i++)
+      Numa_cpu_node[i] = (int)s[RS_MAX + i] - 1;
+   Thread_mode = !!(Rec_frm->flags & REC_fTHD);
+
+   // then the tasks, less any not among those monitored (-p)
+   if (Rec_nppt < Rec_nsav) {
+      Rec_tasks = alloc_r(Rec_tasks, sizeof(proc_t) * Rec_nsav);
+      Rec_ppt = alloc_r(Rec_ppt, sizeof(proc_t *) * Rec_nsav);
+   }
+   for (i = Rec_nppt = 0; i < Rec_nsav; i++) {
+      rec_task((p = &Rec_tasks[Rec_nppt]), &Rec_sav[i * REC_NFLD]);
+      for (j = 0; j < Monpidsidx; j++)
+         if (Monpids[j] == p->tgid) break;
+      if (Monpidsidx && j >= Monpidsidx) continue;
+      Rec_ppt[Rec_nppt++] = p;
+   }
+   Rec_held = 0;
+   return 1;
+} // end: rec_next
+
+
+        /*
+         * Give cpus_refresh one of the replayed frame's /proc/stat cpu lines,
+         * where line 0 is the summary, much as stat_cpu_line would. */
+static int rec_cpu (int n, int *id, TIC_t *tics) {
+   const unsigned long long *t;
+
+   if (n > (int)Rec_sys[RS_lines]) return -1;
+   t = &Rec_sys[RS_MAX + Rec_sys[RS_ncpus] + n * 9];
+   *id = (int)t[0] - 1;
+   memcpy(tics, t + 1, sizeof(TIC_t) * 8);
+   return 8;
+} // end: rec_cpu
+
+
+        /*
+         * Give psi_refresh the replayed frame's pressure stall totals. */
+static int rec_psi (psi_info *psi) {
+   int i;
+
+   for (i = 0; i < PSI_MAX; i++) {
+      psi->some[i] = Rec_sys[RS_psome + i];
+      psi->full[i] = Rec_sys[RS_pfull + i];
+   }
+   psi->stamp = Rec_sys[RS_pstamp];
+   return (int)Rec_sys[RS_psi];
+} // end: rec_psi
+
+
+        /*
+         * Give nodes_refresh the replayed frame's memory nodes, much as
+         * getnodemem would (filling no more than max, returning all). */
+static int rec_nodes (node_mem *mem, int max) {
+   const unsigned long long *t;
+   int i, n = (int)Rec_sys[RS_mnodes];
+
+   t = &Rec_sys[RS_MAX + Rec_sys[RS_ncpus] + (1 + Rec_sys[RS_lines]) * 9];
+   for (i = 0; i < n && i < max; i++, t += 8) {
+      mem[i].total = t[0]; mem[i].free = t[1];  mem[i].file = t[2];  mem[i].anon = t[3];
+      mem[i].hit = t[4];   mem[i].miss = t[5];  mem[i].local = t[6]; mem[i].other = t[7];
+   }
+   return n;
+} // end: rec_nodes
+
+
+        /*
+         * Make a time, in microseconds, of either +/- some seconds (from the
+         * time given) or a time of day, hh:mm[:ss], taken as the first such
+         * time at or after the recording began.  Zero means it's no good. */
+static unsigned long long rec_when (const char *str, unsigned long long from) {
+   const REC_frm *f = (const REC_frm *)(Rec_map + Rec_keys[0]);
+   struct tm tm;
+   time_t t;
+   float secs;
+   int h, m, s = 0, n = 0;
+
+   if ('+' == *str || '-' == *str) {
+      if (!mkfloat(str, &secs, 0)) return 0;
+      if (0 > secs && (unsigned long long)(-secs * 1000000) >= from) return 1;
+      return from + (long long)(secs * 1000000);
+   }
+   if (2 > sscanf(str, "%d:%d%n:%d%n", &h, &m, &n, &s, &n) || str[n]
+   || 0 > h || h > 23 || 0 > m || m > 59 || 0 > s || s > 59)
+      return 0;
+   t = f->usecs / 1000000;
+   localtime_r(&t, &tm);
+   tm.tm_hour = h;
+   tm.tm_min = m;
+   tm.tm_sec = s;
+   tm.tm_isdst = -1;
+   if ((t = mktime(&tm)) * 1000000ull < f->usecs) {
+      tm.tm_mday++;
+      tm.tm_isdst = -1;
+      t = mktime(&tm);
+   }
+   return t * 1000000ull;
+} // end: rec_when
+
+
+        /*
+         * Position a replay so that, after frame_make's priming, the frame
+         * shown is the first sampled at or after the time given (else the
+         * last).  He finds a key frame to start decoding from, then decodes
+         * up to (but not including) the frame before that one, which is
+         * left for the priming. */
+static void rec_seek (unsigned long long when) {
+ #define frmAT(o) ( (const REC_frm *)(Rec_map + (o)) )
+   size_t pos, prv, key;
+   int lo, hi, k;
+
+   // the last key frame at or before then, though starting one key early
+   for (lo = 0, hi = Rec_nkey - 1; lo < hi; ) {
+      k = (lo + hi + 1) / 2;
+      if (frmAT(Rec_keys[k])->usecs <= when) lo = k;
+      else hi = k - 1;
+   }
+   pos = prv = key = Rec_keys[lo ? lo - 1 : 0];
+   // then on to the frame wanted, noting the one before and its key frame
+   while (pos + frmAT(pos)->len < Rec_len && frmAT(pos)->usecs < when) {
+      prv = pos;
+      pos += frmAT(pos)->len;
+      if (frmAT(prv)->flags & REC_fKEY) key = prv;
+   }
+   for (Rec_pos = key; Rec_pos < prv; )
+      rec_decode();
+   Rec_held = 0;
+   Pseudo_row = PROC_XTRA;
+ #undef frmAT
+} // end: rec_seek
+
+
+        /*
+         * A replayed frame's time, for the message line. */
+static const char *rec_status (void) {
+   char buf[SMLBUFSIZ];
+   struct tm tm;
+   time_t t;
+
+   t = Rec_frm ? Rec_frm->usecs / 1000000 : 0;
+   strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", localtime_r(&t, &tm));
+   return fmtmk(N_fmt(REPLAY_status_fmt), Rec_path, buf
+      , Rec_held ? N_txt(REPLAY_at_end_txt) : "");
+} // end: rec_status
+
+
+        /*
+         * Open the recording, for parse_args.  One that's being recorded is
+         * added to, after any frame torn by a crash has been trimmed away.
+         * One that's replayed is mapped and its key frames found, then it's
+         * positioned at the time wanted (if there was one). */
+static void rec_open (const char *when) {
+   REC_hdr hdr;
+   struct stat st;
+   void *map = MAP_FAILED;
+   unsigned long long t;
+   size_t end;
+
+   memset(&hdr, 0, sizeof(hdr));
+   memcpy(hdr.magic, REC_MAGIC, sizeof(hdr.magic));
+   hdr.hertz = Hertz;
+   hdr.pg2k = Pg2K_shft;
+   if (0 > (Rec_fd = open(Rec_path, REC_save == Rec_mode ? O_RDWR | O_CREAT : O_RDONLY, 0644))
+   || fstat(Rec_fd, &st))
+      error_exit(fmtmk(N_fmt(FAIL_rc_open_fmt), Rec_path, strerror(errno)));
+   if (st.st_size) {
+      if ((off_t)sizeof(REC_hdr) > st.st_size
+      || MAP_FAILED == (map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, Rec_fd, 0))
+      || memcmp(map, REC_MAGIC, sizeof(hdr.magic)))
+         goto bad_file;
+   }
+
+   if (REC_save == Rec_mode) {
+      if (!st.st_size) {
+         if (sizeof(hdr) != write(Rec_fd, &hdr, sizeof(hdr)))
+            error_exit(fmtmk(N_fmt(RECORD_failed_fmt), Rec_path, strerror(errno)));
+         return;
+      }
+      // (the same machine, near enough, lest the frames not make sense)
+      if (memcmp(map, &hdr, sizeof(hdr))) goto bad_file;
+      end = rec_walk(map, st.st_size, 0);
+      munmap(map, st.st_size);
+      if (ftruncate(Rec_fd, end) || 0 > lseek(Rec_fd, end, SEEK_SET))
+         error_exit(fmtmk(N_fmt(RECORD_failed_fmt), Rec_path, strerror(errno)));
+      return;
+   }
+
+   if (!st.st_size) goto bad_file;
+   Rec_map = map;
+   Rec_len = rec_walk(Rec_map, st.st_size, 1);
+   if (!Rec_nkey || sizeof(REC_hdr) != Rec_keys[0]) goto bad_file;
+   Hertz = ((const REC_hdr *)map)->hertz;
+   Pg2K_shft = ((const REC_hdr *)map)->pg2k;
+   Rec_pos = Rec_keys[0];
+   if (when) {
+      if (!(t = rec_when(when, ((const REC_frm *)(Rec_map + Rec_pos))->usecs)))
+         error_exit(fmtmk(N_fmt(REPLAY_badwhen_fmt), when));
+      rec_seek(t);
+   }
+   return;
+
+bad_file:
+   error_exit(fmtmk(N_fmt(REPLAY_badfile_fmt), Rec_path));
+} // end: rec_open
+
+
 /*######  Library Interface  #############################################*/
 
         /*
@@ -2334,17 +3417,29 @@ static void zap_fieldstab (void) {
          * as follows:
          *    Cpu_tics[0] thru Cpu_tics[n] == tics for each separate cpu
          *    Cpu_tics[sumSLOT]            == tics from /proc/stat line #1
-         *  [ and beyond sumSLOT           == tics for each cpu NUMA node ] */
+         *  [ and beyond sumSLOT           == tics for each cpu NUMA node ]
+         * The separate cpus are only bothered with when they (or their nodes)
+         * are actually on view (or recorded), and sscanf has yielded to
+         * stat_cpu_line.  When replaying, the lines come from the recording. */
 static void cpus_refresh (void) {
  #define sumSLOT ( smp_num_cpus )
  #define totSLOT ( 1 + smp_num_cpus + Numa_node_tot)
+ #define ticsCT(ct,t) { ct.u = t[0]; ct.n = t[1]; ct.s = t[2]; ct.i = t[3]; \
+    ct.w = t[4]; ct.x = t[5]; ct.y = t[6]; ct.z = t[7]; }
+ #define lineCPU(n) ( REC_play == Rec_mode \
+    ? rec_cpu(n, &id, tics) : stat_cpu_line(&bp, &id, tics) )
    static FILE *fp = NULL;
    static int siz, sav_slot = -1;
+   static int stale;                             // cpus skipped, last frame
    static char *buf;
    CPU_t *sum_ptr;                               // avoid gcc subscript bloat
-   int i, num, tot_read;
+   int i, num, tot_read, id;
    int node;
-   char *bp;
+   TIC_t tics[8];
+   const char *bp;
+#ifdef PRETEND8CPUS
+   const char *cpu0;
+#endif
 
    /*** hotplug_acclimated ***/
    if (sav_slot != sumSLOT) {
@@ -2352,46 +3447,45 @@ static void cpus_refresh (void) {
       zap_fieldstab();
       if (fp) { fclose(fp); fp = NULL; }
       if (Cpu_tics) free(Cpu_tics);
-   }
-
-   /* by opening this file once, we'll avoid the hit on minor page faults
-      (sorry Linux, but you'll have to close it for us) */
-   if (!fp) {
-      if (!(fp = fopen("/proc/stat", "r")))
-         error_exit(fmtmk(N_fmt(FAIL_statopn_fmt), strerror(errno)));
       /* note: we allocate one more CPU_t via totSLOT than 'cpus' so that a
                slot can hold tics representing the /proc/stat cpu summary */
       Cpu_tics = alloc_c(totSLOT * sizeof(CPU_t));
    }
-   rewind(fp);
-   fflush(fp);
+
+   bp = NULL;
+   if (REC_play != Rec_mode) {
+      /* by opening this file once, we'll avoid the hit on minor page faults
+         (sorry Linux, but you'll have to close it for us) */
+      if (!fp && !(fp = fopen("/proc/stat", "r")))
+         error_exit(fmtmk(N_fmt(FAIL_statopn_fmt), strerror(errno)));
+      rewind(fp);
+      fflush(fp);
 
  #define buffGRW 1024
-   /* we slurp in the entire directory thus avoiding repeated calls to fgets,
-      especially in a massively parallel environment.  additionally, each cpu
-      line is then frozen in time rather than changing until we get around to
-      accessing it.  this helps to minimize (not eliminate) most distortions. */
-   tot_read = 0;
-   if (buf) buf[0] = '\0';
-   else buf = alloc_c((siz = buffGRW));
-   while (0 < (num = fread(buf + tot_read, 1, (siz - tot_read), fp))) {
-      tot_read += num;
-      if (tot_read < siz) break;
-      buf = alloc_r(buf, (siz += buffGRW));
-   };
-   buf[tot_read] = '\0';
-   bp = buf;
+      /* we slurp in the entire directory thus avoiding repeated calls to fgets,
+         especially in a massively parallel environment.  additionally, each cpu
+         line is then frozen in time rather than changing until we get around to
+         accessing it.  this helps to minimize (not eliminate) most distortions. */
+      tot_read = 0;
+      if (buf) buf[0] = '\0';
+      else buf = alloc_c((siz = buffGRW));
+      while (0 < (num = fread(buf + tot_read, 1, (siz - tot_read), fp))) {
+         tot_read += num;
+         if (tot_read < siz) break;
+         buf = alloc_r(buf, (siz += buffGRW));
+      };
+      buf[tot_read] = '\0';
+      bp = buf;
  #undef buffGRW
+   }
 
    // remember from last time around
    sum_ptr = &Cpu_tics[sumSLOT];
    memcpy(&sum_ptr->sav, &sum_ptr->cur, sizeof(CT_t));
    // then value the last slot with the cpu summary line
-   if (4 > sscanf(bp, "cpu %llu %llu %llu %llu %llu %llu %llu %llu"
-      , &sum_ptr->cur.u, &sum_ptr->cur.n, &sum_ptr->cur.s
-      , &sum_ptr->cur.i, &sum_ptr->cur.w, &sum_ptr->cur.x
-      , &sum_ptr->cur.y, &sum_ptr->cur.z))
-         error_exit(N_txt(FAIL_statget_txt));
+   if (4 > lineCPU(0) || -1 != id)
+      error_exit(N_txt(FAIL_statget_txt));
+   ticsCT(sum_ptr->cur, tics)
 #ifndef CPU_ZEROTICS
    sum_ptr->cur.tot = sum_ptr->cur.u + sum_ptr->cur.s
       + sum_ptr->cur.n + sum_ptr->cur.i + sum_ptr->cur.w
@@ -2403,25 +3497,39 @@ static void cpus_refresh (void) {
       ((sum_ptr->cur.tot - sum_ptr->sav.tot) / smp_num_cpus) / (100 / TICS_EDGE);
 #endif
 
+   /* with only that summary line on view, there's nothing more to do --
+      which spares a big box a thousand or so lines of parsing per frame
+      (though a recording keeps every cpu, whatever is on view) */
+   if (!Rec_mode && (Emit_mode
+   || (CHKw(Curwin, View_CPUSUM) && !(CHKw(Curwin, View_CPUNOD) && Numa_node_tot)))) {
+      Cpu_faux_tot = sumSLOT;
+      stale = 1;
+      return;
+   }
+
    // forget all of the prior node statistics (maybe)
    if (CHKw(Curwin, View_CPUNOD) && Numa_node_tot)
       memset(sum_ptr + 1, 0, Numa_node_tot * sizeof(CPU_t));
 
    // now value each separate cpu's tics...
+#ifdef PRETEND8CPUS
+   cpu0 = bp;
+#endif
    for (i = 0; i < sumSLOT; i++) {
       CPU_t *cpu_ptr = &Cpu_tics[i];           // avoid gcc subscript bloat
 #ifdef PRETEND8CPUS
-      bp = buf;
+      bp = cpu0;
 #endif
-      bp = 1 + strchr(bp, '\n');
       // remember from last time around
       memcpy(&cpu_ptr->sav, &cpu_ptr->cur, sizeof(CT_t));
-      if (4 > sscanf(bp, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu", &cpu_ptr->id
-         , &cpu_ptr->cur.u, &cpu_ptr->cur.n, &cpu_ptr->cur.s
-         , &cpu_ptr->cur.i, &cpu_ptr->cur.w, &cpu_ptr->cur.x
-         , &cpu_ptr->cur.y, &cpu_ptr->cur.z)) {
-            break;        // tolerate cpus taken offline
-      }
+      if (4 > lineCPU(1 + i) || 0 > id)
+         break;           // tolerate cpus taken offline
+      cpu_ptr->id = id;
+      ticsCT(cpu_ptr->cur, tics)
+      /* when last refreshed, these may be from long ago -- so rather than
+         show percentages from then, this frame shows none at all */
+      if (stale)
+         memcpy(&cpu_ptr->sav, &cpu_ptr->cur, sizeof(CT_t));
 
 #ifndef CPU_ZEROTICS
       cpu_ptr->edge = sum_ptr->edge;
@@ -2433,7 +3541,7 @@ static void cpus_refresh (void) {
          maintaining *any* node stats unless they're actually needed */
       if (CHKw(Curwin, View_CPUNOD)
       && Numa_node_tot
-      && -1 < (node = numa_node_of_cpu(cpu_ptr->id))) {
+      && -1 < (node = NUMA_NODE(cpu_ptr->id))) {
          // use our own pointer to avoid gcc subscript bloat
          CPU_t *nod_ptr = sum_ptr + 1 + node;
          nod_ptr->cur.u += cpu_ptr->cur.u; nod_ptr->sav.u += cpu_ptr->sav.u;
@@ -2456,9 +3564,12 @@ static void cpus_refresh (void) {
       }
    } // end: for each cpu
 
+   stale = 0;
    Cpu_faux_tot = i;      // tolerate cpus taken offline
  #undef sumSLOT
  #undef totSLOT
+ #undef lineCPU
+ #undef ticsCT
 } // end: cpus_refresh
 
 
@@ -2481,60 +3592,309 @@ static inline HST_t *hstbsrch (HST_t *hst, int max, int pid) {
 #else
         /*
          * Hashing functions for HST_t's put/get support
-         * (not your normal 'chaining', those damn HST_t's might move!) */
+         * (open addressing, with the slots holding indexes since those
+         *  damn HST_t's might move!)  A table is kept at most half full,
+         * growing as needed, and the pid is scattered (multiplicatively)
+         * lest runs of consecutive pids form long runs of probes. */
 
-#define _HASH_(K) (K & (HHASH_SIZ - 1))
+#define _HASH_(K,B) ( (unsigned)(K) * 2654435761u >> (32 - (B)) )
+#define _NEXT_(V,B) ( ((V) + 1) & ((1u << (B)) - 1) )
 
-static inline HST_t *hstget (int pid) {
-   int V = PHash_sav[_HASH_(pid)];
+static inline HST_t *hstget (int pid, unsigned long long stm) {
+   unsigned V;
+   int i;
 
-   while (-1 < V) {
-      if (PHist_sav[V].pid == pid) return &PHist_sav[V];
-      V = PHist_sav[V].lnk; }
+   if (!PHash_sav) return NULL;
+   for (V = _HASH_(pid, HHash_savbits); -1 < (i = PHash_sav[V]); V = _NEXT_(V, HHash_savbits))
+      if (PHist_sav[i].pid == pid && PHist_sav[i].stm == stm) return &PHist_sav[i];
    return NULL;
 } // end: hstget
 
 
 static inline void hstput (unsigned idx) {
-   int V = _HASH_(PHist_new[idx].pid);
-
-   PHist_new[idx].lnk = PHash_new[V];
+   unsigned V;
+
+   // when more than half full, double (and refill) the table
+   if (1u << HHash_newbits < 2 * (idx + 1)) {
+      HHash_newbits = HHash_newbits ? HHash_newbits + 1 : 10;
+      PHash_new = alloc_r(PHash_new, sizeof(int) << HHash_newbits);
+      memset(PHash_new, -1, sizeof(int) << HHash_newbits);
+      for (V = 0; V < idx; V++)
+         hstput(V);
+   }
+   for (V = _HASH_(PHist_new[idx].pid, HHash_newbits); -1 < PHash_new[V]; )
+      V = _NEXT_(V, HHash_newbits);
    PHash_new[V] = idx;
+   PHist_new[idx].slot = V;
 } // end: hstput
 
 #undef _HASH_
+#undef _NEXT_
 #endif
 
+
         /*
-         * Refresh procs *Helper* function to eliminate yet one more need
-         * to loop through our darn proc_t table.  He's responsible for:
-         *    1) calculating the elapsed time since the previous frame
-         *    2) counting the number of tasks in each state (run, sleep, etc)
-         *    3) maintaining the HST_t's and priming the proc_t pcpu field
-         *    4) establishing the total number tasks for this frame */
-static void procs_hlp (proc_t *this) {
-#ifdef OFF_HST_HASH
-   static unsigned maxt_sav = 0;        // prior frame's max tasks
-#endif
-   TIC_t tics;
-   HST_t *h;
+         * The history ring is readied for a new frame, with the slots of
+         * any tasks not seen in the last one freed.  Or, should no window
+         * want history any longer, the whole thing is simply forgotten. */
+static void hring_frame (void) {
+   int s;
+
+   if (!(Frames_libflags & L_RING)) {
+      if (Hring_siz) {
+         free(Hring_free);   free(Hring_seen);   free(Hring_cnt);
+         free(Hring_cpu);    free(Hring_flt);    free(Hring_res);
+         free(Hring_cpusum); free(Hring_fltsum); free(Hring_ressum);
+         Hring_free = NULL;  Hring_seen = NULL;  Hring_cnt = NULL;
+         Hring_cpu = Hring_flt = NULL; Hring_res = NULL;
+         Hring_cpusum = Hring_fltsum = NULL; Hring_ressum = NULL;
+         Hring_siz = Hring_used = Hring_nfree = 0;
+      }
+      return;
+   }
+   for (s = 0; s < Hring_used; s++)
+      if (Hring_seen[s] && Hring_seen[s] != Hring_frame) {
+         Hring_seen[s] = 0;
+         Hring_free[Hring_nfree++] = s;
+      }
+   if (!++Hring_frame) Hring_frame = 1;
+   Hring_col = (Hring_col + 1) % HRING_len;
+} // end: hring_frame
 
-   if (!this) {
-      static double uptime_sav;
-      double uptime_cur;
-      float et;
-      void *v;
 
-      uptime(&uptime_cur, NULL);
-      et = uptime_cur - uptime_sav;
-      if (et < 0.01) et = 0.005;
-      uptime_sav = uptime_cur;
+        /*
+         * Find a task's history ring slot -- the one it had last frame
+         * (unless a duplicate tid already took it), else a fresh one */
+static inline int hring_slot (HST_t *h) {
+ #define hrgGRW(p,n)  p = alloc_r(p, sizeof(*p) * (n))
+   int s;
+
+   if (h && (unsigned)(s = h->hslot) < (unsigned)Hring_used
+   && Hring_seen[s] && Hring_seen[s] != Hring_frame)
+      goto end_claimed;
+   if (Hring_nfree)
+      s = Hring_free[--Hring_nfree];
+   else {
+      if (Hring_used == Hring_siz) {
+         Hring_siz = Hring_siz * 5 / 4 + 100;
+         hrgGRW(Hring_free, Hring_siz);   hrgGRW(Hring_seen, Hring_siz);
+         hrgGRW(Hring_cnt, Hring_siz);    hrgGRW(Hring_cpusum, Hring_siz);
+         hrgGRW(Hring_fltsum, Hring_siz); hrgGRW(Hring_ressum, Hring_siz);
+         hrgGRW(Hring_cpu, (size_t)Hring_siz * HRING_len);
+         hrgGRW(Hring_flt, (size_t)Hring_siz * HRING_len);
+         hrgGRW(Hring_res, (size_t)Hring_siz * HRING_len);
+      }
+      s = Hring_used++;
+   }
+   Hring_cnt[s] = 0;
+   Hring_cpusum[s] = Hring_fltsum[s] = 0;
+   Hring_ressum[s] = 0;
+end_claimed:
+   Hring_seen[s] = Hring_frame;
+   return s;
+ #undef hrgGRW
+} // end: hring_slot
 
-      // if in Solaris mode, adjust our scaling for all cpus
+
+        /*
+         * Add this frame's sample to a task's history ring slot, with
+         * the sums adjusted for the oldest one it may be replacing */
+static inline void hring_save (int s, const proc_t *p) {
+   size_t x = (size_t)s * HRING_len + Hring_col;
+   float u = (float)p->pcpu * Frame_etscale;
+   unsigned long f = p->maj_delta + p->min_delta;
+
+   if (u > Cpu_pmax) u = Cpu_pmax;
+   if (Hring_cnt[s] < HRING_len)
+      Hring_cnt[s]++;
+   else {
+      Hring_cpusum[s] -= Hring_cpu[x];
+      Hring_fltsum[s] -= Hring_flt[x];
+      Hring_ressum[s] -= Hring_res[x];
+   }
+   Hring_cpu[x] = u * 10 + .5;
+   Hring_flt[x] = f < USHRT_MAX ? f : USHRT_MAX;
+   Hring_res[x] = p->rss < 0 ? 0 : (unsigned long)p->rss < UINT_MAX ? (unsigned)p->rss : UINT_MAX;
+   Hring_cpusum[s] += Hring_cpu[x];
+   Hring_fltsum[s] += Hring_flt[x];
+   Hring_ressum[s] += Hring_res[x];
+} // end: hring_save
+
+
+        /*
+         * (Re)build the hash of one basis' task groups, first doubling
+         * the table if it's more than half full. */
+static void groups_hash (int b) {
+   int h, i;
+
+   if (Grps[b].used * 2 > Grps[b].msk) {
+      Grps[b].msk = Grps[b].msk ? Grps[b].msk * 2 + 1 : 255;
+      Grps[b].hash = alloc_r(Grps[b].hash, sizeof(int) * (Grps[b].msk + 1));
+   }
+   memset(Grps[b].hash, -1, sizeof(int) * (Grps[b].msk + 1));
+   for (i = 0; i < Grps[b].used; i++) {
+      h = rec_hash(Grps[b].tab[i]->name) & Grps[b].msk;
+      Grps[b].tab[i]->link = Grps[b].hash[h];
+      Grps[b].hash[h] = i;
+   }
+} // end: groups_hash
+
+
+        /*
+         * Start a frame's task groups afresh, letting go of any that
+         * have been without tasks for too long. */
+static void groups_frame (void) {
+   int b, i, n;
+
+   Grps_frame++;
+   for (b = 0; b < GRP_BASES; b++) {
+      Grps[b].last = -1;
+      for (i = n = 0; i < Grps[b].used; i++) {
+         GRP_t *g = Grps[b].tab[i];
+         if (Grps_frame - g->seen > GRP_STALE) {
+            free(g->name);
+            free(g);
+         } else
+            Grps[b].tab[n++] = g;
+      }
+      if (n < Grps[b].used) {
+         Grps[b].used = n;
+         groups_hash(b);
+      }
+   }
+} // end: groups_frame
+
+
+        /*
+         * Add a task to the group sharing its cgroup (or its container),
+         * first discovering the group should the name be a new one.  The
+         * first of a frame's tasks (usually its lowest pid) supplies all
+         * of that group's fields that aren't totals, so its pointers too
+         * (which stay valid as long as the task's proc_t, for one frame).
+         * In thread mode, the memory of a process is added just once. */
+static void groups_add (int b, const proc_t *this) {
+ #define grpSUM(f)  g->p.f += this->f
+   const char *name = b ? this->lxcname : this->cgroup ? *this->cgroup : NULL;
+   GRP_t *g;
+   int i;
+
+   if (!name) name = "-";
+   // a group's tasks often arrive together (its threads always do),
+   // so the group last found is tried before any hashing
+   if (0 > (i = Grps[b].last) || strcmp(Grps[b].tab[i]->name, name)) {
+      i = Grps[b].msk ? Grps[b].hash[rec_hash(name) & Grps[b].msk] : -1;
+      while (0 <= i && strcmp(Grps[b].tab[i]->name, name))
+         i = Grps[b].tab[i]->link;
+      if (0 > i) {
+         if (Grps[b].used >= Grps[b].siz) {
+            Grps[b].siz = Grps[b].siz * 2 + 64;
+            Grps[b].tab = alloc_r(Grps[b].tab, sizeof(GRP_t *) * Grps[b].siz);
+         }
+         g = alloc_c(sizeof(GRP_t));
+         g->name = alloc_s(name);
+         g->seen = Grps_frame - 1;
+         Grps[b].tab[(i = Grps[b].used++)] = g;
+         if (Grps[b].used * 2 > Grps[b].msk)
+            groups_hash(b);
+         else {
+            int h = rec_hash(name) & Grps[b].msk;
+            g->link = Grps[b].hash[h];
+            Grps[b].hash[h] = i;
+         }
+      }
+      Grps[b].last = i;
+   }
+   g = Grps[b].tab[i];
+
+   if (g->seen != Grps_frame) {
+      const char *last = strrchr(g->name, '/');
+      g->seen = Grps_frame;
+      g->p = *this;
+      g->vec[0] = g->name;
+      g->p.cmdline = g->vec;
+      // the name's last part is shown in place of a program name
+      snprintf(g->p.cmd, sizeof(g->p.cmd), "%s", last && last[1] ? last + 1 : g->name);
+      g->p.nlwp = Thread_mode ? 1 : this->nlwp;
+      g->p.pad_2 = 1;              // (no readproc_more for this one)
+      g->p.pad_3 = 0;              // (nor any forest view indent)
+      g->p.hist_slot = -1;
+      return;
+   }
+   grpSUM(pcpu);      grpSUM(utime);      grpSUM(stime);      grpSUM(cutime);
+   grpSUM(cstime);    grpSUM(maj_flt);    grpSUM(min_flt);    grpSUM(cmaj_flt);
+   grpSUM(cmin_flt);  grpSUM(maj_delta);  grpSUM(min_delta);
+   grpSUM(delay_cpu); grpSUM(delay_blkio); grpSUM(delay_swapin); grpSUM(delay_freepages);
+   g->p.nlwp += Thread_mode ? 1 : this->nlwp;
+   if ('R' == this->state) g->p.state = 'R';
+   if (Thread_mode && this->tid != this->tgid)
+      return;
+   grpSUM(size);      grpSUM(resident);   grpSUM(share);      grpSUM(trs);
+   grpSUM(drs);       grpSUM(dt);         grpSUM(rss);        grpSUM(vm_size);
+   grpSUM(vm_lock);   grpSUM(vm_rss);     grpSUM(vm_rss_anon); grpSUM(vm_rss_file);
+   grpSUM(vm_rss_shared); grpSUM(vm_data); grpSUM(vm_stack);  grpSUM(vm_swap);
+   grpSUM(vm_exe);    grpSUM(vm_lib);     grpSUM(numa_kb);
+ #undef grpSUM
+} // end: groups_add
+
+
+        /*
+         * Fill a window's ppt with the groups having tasks this frame,
+         * in order of their discovery, and return how many there were. */
+static int groups_ppt (int b, proc_t **ppt) {
+   int i, n;
+
+   for (i = n = 0; i < Grps[b].used; i++)
+      if (Grps[b].tab[i]->seen == Grps_frame)
+         ppt[n++] = &Grps[b].tab[i]->p;
+   return n;
+} // end: groups_ppt
+
+        /*
+         * Refresh procs *Helper* function to eliminate yet one more need
+         * to loop through our darn proc_t table.  He's responsible for:
+         *    1) calculating the elapsed time since the previous frame
+         *    2) counting the number of tasks in each state (run, sleep, etc)
+         *    3) maintaining the HST_t's and priming the proc_t pcpu field
+         *    4) establishing the total number tasks for this frame
+         *    5) keeping the history ring, should any window want it
+         *    6) totaling tasks by group, should any window show them */
+static void procs_hlp (proc_t *this) {
+   /* the taskstats totals are replaced with their change since the last
+      frame (which must never go negative should a tid have been reused) */
+ #define DLY_delta(p,h) { \
+   (p)->delay_cpu       = (p)->delay_cpu       < (h)->dlc ? 0 : (p)->delay_cpu       - (h)->dlc; \
+   (p)->delay_blkio     = (p)->delay_blkio     < (h)->dlb ? 0 : (p)->delay_blkio     - (h)->dlb; \
+   (p)->delay_swapin    = (p)->delay_swapin    < (h)->dls ? 0 : (p)->delay_swapin    - (h)->dls; \
+   (p)->delay_freepages = (p)->delay_freepages < (h)->dlr ? 0 : (p)->delay_freepages - (h)->dlr; }
+   static unsigned maxt_sav = 0;        // prior frame's max tasks
+   TIC_t tics;
+   HST_t *h;
+
+   if (!this) {
+      static double uptime_sav;
+      double uptime_cur;
+      float et;
+      void *v;
+#ifndef OFF_HST_HASH
+      unsigned i;
+#endif
+
+      if (REC_play == Rec_mode) uptime_cur = Rec_sys[RS_uptime] / 100.0;
+      else uptime(&uptime_cur, NULL);
+      et = uptime_cur - uptime_sav;
+      if (et < 0.01) et = 0.005;
+      uptime_sav = uptime_cur;
+
+      // if in Solaris mode, adjust our scaling for all cpus
       Frame_etscale = 100.0f / ((float)Hertz * (float)et * (Rc.mode_irixps ? 1 : smp_num_cpus));
-#ifdef OFF_HST_HASH
-      maxt_sav = Frame_maxtask;
+      // delays are nanoseconds of wall clock, regardless of the cpu count
+      Frame_dlyscale = 100.0f / ((float)et * 1000000000.0f);
+#ifndef OFF_HST_HASH
+      // empty the older hash table, touching just the slots it used
+      for (i = 0; i < maxt_sav; i++)
+         PHash_sav[PHist_sav[i].slot] = -1;
 #endif
+      maxt_sav = Frame_maxtask;
       Frame_maxtask = Frame_running = Frame_sleepin = Frame_stopped = Frame_zombied = 0;
 
       // prep for saving this frame's HST_t's (and reuse mem each time around)
@@ -2548,8 +3908,12 @@ static void procs_hlp (proc_t *this) {
       v = PHash_sav;
       PHash_sav = PHash_new;
       PHash_new = v;
-      memcpy(PHash_new, HHash_nul, sizeof(HHash_nul));
+      i = HHash_savbits;
+      HHash_savbits = HHash_newbits;
+      HHash_newbits = i;
 #endif
+      hring_frame();
+      groups_frame();
       return;
    }
 
@@ -2581,26 +3945,36 @@ static void procs_hlp (proc_t *this) {
       system time (stime) -- but PLEASE dont waste time and effort on
       calcs and saves that go unused, like the old top! */
    PHist_new[Frame_maxtask].pid  = this->tid;
+   PHist_new[Frame_maxtask].stm  = this->start_time;
    PHist_new[Frame_maxtask].tics = tics = (this->utime + this->stime);
    // finally, save major/minor fault counts in case the deltas are displayable
    PHist_new[Frame_maxtask].maj = this->maj_flt;
    PHist_new[Frame_maxtask].min = this->min_flt;
+   // along with any taskstats delays, which become elapsed just like tics
+   PHist_new[Frame_maxtask].dlc = this->delay_cpu;
+   PHist_new[Frame_maxtask].dlb = this->delay_blkio;
+   PHist_new[Frame_maxtask].dls = this->delay_swapin;
+   PHist_new[Frame_maxtask].dlr = this->delay_freepages;
 
 #ifdef OFF_HST_HASH
    // find matching entry from previous frame and make stuff elapsed
-   if ((h = hstbsrch(PHist_sav, maxt_sav - 1, this->tid))) {
+   if ((h = hstbsrch(PHist_sav, maxt_sav - 1, this->tid))
+   && h->stm == this->start_time) {
       tics -= h->tics;
       this->maj_delta = this->maj_flt - h->maj;
       this->min_delta = this->min_flt - h->min;
-   }
+      DLY_delta(this, h);
+   } else
+      h = NULL;
 #else
    // hash & save for the next frame
    hstput(Frame_maxtask);
    // find matching entry from previous frame and make stuff elapsed
-   if ((h = hstget(this->tid))) {
+   if ((h = hstget(this->tid, this->start_time))) {
       tics -= h->tics;
       this->maj_delta = this->maj_flt - h->maj;
       this->min_delta = this->min_flt - h->min;
+      DLY_delta(this, h);
    }
 #endif
 
@@ -2608,11 +3982,241 @@ static void procs_hlp (proc_t *this) {
       this task wins it's displayable screen row lottery... */
    this->pcpu = tics;
 
+   // a task's history (if wanted) starts with the first of those deltas
+   this->hist_slot = -1;
+   if (Frames_libflags & L_RING) {
+      this->hist_slot = hring_slot(h);
+      if (h) hring_save(this->hist_slot, this);
+   }
+   PHist_new[Frame_maxtask].hslot = this->hist_slot;
+
+   if (Frames_grpflags & Show_GRPCGR) groups_add(0, this);
+   if (Frames_grpflags & Show_GRPLXC) groups_add(1, this);
+
    // shout this to the world with the final call (or us the next time in)
    Frame_maxtask++;
+ #undef DLY_delta
 } // end: procs_hlp
 
 
+#ifndef OFF_SCANPOOL
+        /*
+         * This is the worker pool procs_refresh uses to read /proc with
+         * several threads, all of which persist from frame to frame.  We
+         * list the pids, in the very order readdir gives them, then deal
+         * them out in slices (each with its own PROCTAB) to whichever of
+         * the threads asks next, ourselves included.  Then the slices are
+         * rejoined in that same order so the result is exactly what just
+         * 1 thread would have seen.  The pool uses only those library flags
+         * which are thread safe and any others (user names, for example)
+         * are satisfied afterwards by readproc_more, from our thread alone. */
+#define POOL_SAFE   PROC_FILLSTAT | PROC_FILLMEM | PROC_FILLSTATUS | PROC_FILLOOM | PROC_FILLNS \
+   | PROC_FILLNUMA
+#define POOL_LATER  PROC_FILLUSR | PROC_FILLGRP | PROC_FILLSUPGRP | PROC_FILLENV | PROC_FILLARG \
+   | PROC_FILLCOM | PROC_FILLCGROUP | PROC_FILLSYSTEMD | PROC_FILL_LXC
+static pthread_mutex_t Pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  Pool_work = PTHREAD_COND_INITIALIZER,
+                       Pool_done = PTHREAD_COND_INITIALIZER;
+static int       Pool_threads;         // readers, with us (0 = not yet known)
+static unsigned  Pool_gen;             // bumped as each frame's work is posted
+static int       Pool_busy;            // workers yet to finish with this frame
+static PSL_t    *Pool_slices;          // the frame's slices of the pid list
+static int       Pool_nslice,          // number of slices in this frame
+                 Pool_next,            // the next slice to be claimed
+                 Pool_salloc;          // slices allocated (and persisting)
+static pid_t    *Pool_pids;            // the pid list, a 0 ending each slice
+static int       Pool_palloc;          // pids allocated
+
+
+        /*
+         * Read all the tasks in one slice into its own proc_t's */
+static void pool_slice (PSL_t *s) {
+   proc_t*(*read_something)(PROCTAB*, proc_t*);
+   proc_t *ptask;
+
+   read_something = Thread_mode ? readeither : readproc;
+   for (s->n_read = 0;; s->n_read++) {
+      if (s->n_read == s->n_alloc) {
+         s->n_alloc = 10 + ((s->n_alloc * 5) / 4);
+         s->ppt = alloc_r(s->ppt, sizeof(proc_t*) * s->n_alloc);
+         memset(s->ppt + s->n_read, 0, sizeof(proc_t*) * (s->n_alloc - s->n_read));
+      }
+      if (!(ptask = read_something(s->PT, s->ppt[s->n_read]))) break;
+      s->ppt[s->n_read] = ptask;
+   }
+} // end: pool_slice
+
+
+        /*
+         * Claim and read slices until none are left (our Pool_mutex
+         * is held upon entry and again upon return) */
+static void pool_claim (void) {
+   PSL_t *s;
+
+   while (Pool_next < Pool_nslice) {
+      s = &Pool_slices[Pool_next++];
+      pthread_mutex_unlock(&Pool_mutex);
+      pool_slice(s);
+      pthread_mutex_lock(&Pool_mutex);
+   }
+} // end: pool_claim
+
+
+        /*
+         * The life of a worker thread, sleeping between frames */
+static void *pool_worker (void *unused) {
+   unsigned gen = 0;
+
+   pthread_mutex_lock(&Pool_mutex);
+   for (;;) {
+      while (gen == Pool_gen)
+         pthread_cond_wait(&Pool_work, &Pool_mutex);
+      gen = Pool_gen;
+      pool_claim();
+      if (!--Pool_busy)
+         pthread_cond_signal(&Pool_done);
+   }
+   return unused;
+} // end: pool_worker
+
+
+        /*
+         * Size the pool, from the rcfile or the cpus, and start
+         * its workers (who must leave all signals to us) */
+static void pool_init (void) {
+   sigset_t all, sav;
+   pthread_t tid;
+   int want;
+
+   want = Rc.pool_threads;
+   if (1 > want || POOLTHDMAX < want)
+      want = smp_num_cpus < POOLTHDDEF ? smp_num_cpus : POOLTHDDEF;
+   sigfillset(&all);
+   pthread_sigmask(SIG_SETMASK, &all, &sav);
+   for (Pool_threads = 1; Pool_threads < want; Pool_threads++)
+      if (pthread_create(&tid, NULL, pool_worker, NULL)) break;
+   pthread_sigmask(SIG_SETMASK, &sav, NULL);
+} // end: pool_init
+
+
+        /*
+         * Read this frame's tasks with the pool, returning how many
+         * along with a pointer to their proc_t pointers -- or -1 if
+         * the pool isn't usable (when just 1 thread, or some pids
+         * or cgroups are being monitored) */
+static int pool_read (proc_t ***ppt) {
+   static proc_t **merged;             // the slices, rejoined
+   static int m_alloc;
+   struct dirent *ent;
+   PSL_t *s;
+   DIR *dir;
+   int i, n, per, flags;
+
+   if (!Pool_threads) pool_init();
+   if (2 > Pool_threads || Monpidsidx || Moncgrpsidx)
+      return -1;
+   if (!(dir = opendir("/proc")))
+      error_exit(fmtmk(N_fmt(FAIL_openlib_fmt), strerror(errno)));
+   for (n = 0; (ent = readdir(dir)); ) {
+      if ('0' >= *ent->d_name || '9' < *ent->d_name) continue;
+      if (n + 1 >= Pool_palloc) {
+         Pool_palloc = 10 + ((Pool_palloc * 5) / 4);
+         Pool_pids = alloc_r(Pool_pids, sizeof(pid_t) * Pool_palloc);
+      }
+      Pool_pids[n++] = strtoul(ent->d_name, NULL, 10);
+   }
+   closedir(dir);
+
+   // about 4 slices per thread, so that a slow one is soon made up
+   per = n / (Pool_threads * 4) + 1;
+   Pool_nslice = (n + per - 1) / per;
+   if (n + Pool_nslice > Pool_palloc) {
+      Pool_palloc = n + Pool_nslice;
+      Pool_pids = alloc_r(Pool_pids, sizeof(pid_t) * Pool_palloc);
+   }
+   if (Pool_nslice > Pool_salloc) {
+      Pool_slices = alloc_r(Pool_slices, sizeof(PSL_t) * Pool_nslice);
+      memset(Pool_slices + Pool_salloc, 0, sizeof(PSL_t) * (Pool_nslice - Pool_salloc));
+      Pool_salloc = Pool_nslice;
+   }
+   // spread out the list (from its end) making room for each slice's 0
+   for (i = n - 1; i >= 0; i--)
+      Pool_pids[i + i / per] = Pool_pids[i];
+   flags = (Frames_libflags & (POOL_SAFE)) | PROC_PID;
+   for (i = 0; i < Pool_nslice; i++) {
+      s = &Pool_slices[i];
+      Pool_pids[i * (per + 1) + (n - i * per < per ? n - i * per : per)] = 0;
+      if (!(s->PT = openproc(flags, Pool_pids + i * (per + 1))))
+         error_exit(fmtmk(N_fmt(FAIL_openlib_fmt), strerror(errno)));
+   }
+
+   pthread_mutex_lock(&Pool_mutex);
+   Pool_next = 0;
+   Pool_busy = Pool_threads - 1;
+   Pool_gen++;
+   pthread_cond_broadcast(&Pool_work);
+   pool_claim();
+   while (Pool_busy)
+      pthread_cond_wait(&Pool_done, &Pool_mutex);
+   pthread_mutex_unlock(&Pool_mutex);
+
+   for (n = i = 0; i < Pool_nslice; i++)
+      n += Pool_slices[i].n_read;
+   if (n >= m_alloc) {
+      m_alloc = 10 + ((n * 5) / 4);
+      merged = alloc_r(merged, sizeof(proc_t*) * m_alloc);
+   }
+   for (n = i = 0; i < Pool_nslice; i++) {
+      s = &Pool_slices[i];
+      closeproc(s->PT);
+      memcpy(merged + n, s->ppt, sizeof(proc_t*) * s->n_read);
+      n += s->n_read;
+   }
+   // whatever the pool couldn't do (less what it did do) we'll do now
+   if (Frames_libflags & (POOL_LATER))
+      for (i = 0; i < n; i++)
+         readproc_more(merged[i], Frames_libflags
+            & ~(PROC_FILLOOM | PROC_FILLNS | PROC_FILLNUMA));
+
+   *ppt = merged;
+   return n;
+} // end: pool_read
+
+#undef POOL_SAFE
+#undef POOL_LATER
+#endif
+
+
+        /*
+         * This guy samples the system wide pressure stall counters once
+         * each frame, retaining the prior ones for summary_show's use */
+static void psi_refresh (void) {
+   Psi_sav = Psi_now;
+   if (REC_play == Rec_mode) Psi_have = rec_psi(&Psi_now);
+   else Psi_have = getpressure(&Psi_now);
+} // end: psi_refresh
+
+
+        /*
+         * Refresh the memory of each numa node, keeping the prior values
+         * so that just this interval's allocations (numastat) are shown. */
+static void nodes_refresh (void) {
+   int n;
+
+   if (Node_tot) memcpy(Node_sav, Node_now, sizeof(node_mem) * Node_tot);
+   for (;;) {
+      if (REC_play == Rec_mode) n = rec_nodes(Node_now, Node_siz);
+      else n = getnodemem(Node_now, Node_siz);
+      if (n <= Node_siz) break;
+      Node_now = alloc_r(Node_now, sizeof(node_mem) * n);
+      Node_sav = alloc_r(Node_sav, sizeof(node_mem) * n);
+      memset(Node_sav + Node_siz, 0, sizeof(node_mem) * (n - Node_siz));
+      Node_siz = n;
+   }
+   Node_tot = n;
+} // end: nodes_refresh
+
+
         /*
          * This guy's modeled on libproc's 'readproctab' function except
          * we reuse and extend any prior proc_t's.  He's been customized
@@ -2622,41 +4226,84 @@ static void procs_refresh (void) {
    static proc_t **private_ppt;                  // our base proc_t ptr table
    static int n_alloc = 0;                       // size of our private_ppt
    static int n_saved = 0;                       // last window ppt size
-   proc_t *ptask;
+   proc_t **ppt, *ptask;
    PROCTAB* PT;
-   int i;
+   int i, n_read = -1;
    proc_t*(*read_something)(PROCTAB*, proc_t*);
+   double t;
 
+   // a replay's next frame (unless its last is being held)
+   if (REC_play == Rec_mode && !rec_next())
+      return;
    procs_hlp(NULL);                              // prep for a new frame
-   if (NULL == (PT = openproc(Frames_libflags, Monpids)))
-      error_exit(fmtmk(N_fmt(FAIL_openlib_fmt), strerror(errno)));
-   read_something = Thread_mode ? readeither : readproc;
-
-   for (;;) {
-      if (n_used == n_alloc) {
-         n_alloc = 10 + ((n_alloc * 5) / 4);     // grow by over 25%
-         private_ppt = alloc_r(private_ppt, sizeof(proc_t*) * n_alloc);
-         // ensure NULL pointers for the additional memory just acquired
-         memset(private_ppt + n_used, 0, sizeof(proc_t*) * (n_alloc - n_used));
+   if (REC_play == Rec_mode) {
+      ppt = Rec_ppt;
+      n_read = Rec_nppt;
+   }
+#ifndef OFF_SCANPOOL
+   else n_read = pool_read(&ppt);                // the pool may do it all
+#endif
+   if (0 > n_read) {
+      if (Moncgrpsidx) PT = openproc(Frames_libflags, Moncgrps);
+      else PT = openproc(Frames_libflags, Monpids);
+      if (NULL == PT)
+         error_exit(fmtmk(N_fmt(FAIL_openlib_fmt), strerror(errno)));
+      read_something = Thread_mode ? readeither : readproc;
+
+      for (n_read = 0;;) {
+         if (n_read == n_alloc) {
+            n_alloc = 10 + ((n_alloc * 5) / 4);  // grow by over 25%
+            private_ppt = alloc_r(private_ppt, sizeof(proc_t*) * n_alloc);
+            // ensure NULL pointers for the additional memory just acquired
+            memset(private_ppt + n_read, 0, sizeof(proc_t*) * (n_alloc - n_read));
+         }
+         // on the way to n_alloc, the library will allocate the underlying
+         // proc_t storage whenever our private_ppt[] pointer is NULL...
+         if (!(ptask = read_something(PT, private_ppt[n_read]))) break;
+         private_ppt[n_read++] = ptask;
       }
-      // on the way to n_alloc, the library will allocate the underlying
-      // proc_t storage whenever our private_ppt[] pointer is NULL...
-      if (!(ptask = read_something(PT, private_ppt[n_used]))) break;
-      procs_hlp((private_ppt[n_used] = ptask));  // tally this proc_t
+
+      closeproc(PT);
+      ppt = private_ppt;
    }
 
-   closeproc(PT);
+   // with every task now in hand, the taskstats queries can be batched
+   // (should they be refused, the library leaves those fields all zero)
+   if (Frames_libflags & L_DELAY && REC_play != Rec_mode)
+      get_delayacct(ppt, n_read, Thread_mode);
+
+   // when recording or replaying, the whole frame is sampled at once
+   // (the cpus, pressure and nodes too), with the cpus charged to their own phase
+   if (Rec_mode) {
+      t = secs_now(CLOCK_MONOTONIC);
+      cpus_refresh();
+      t = secs_now(CLOCK_MONOTONIC) - t;
+      Frame_phases[PHASE_cpus] += t;
+      Frame_phases[PHASE_procs] -= t;
+      psi_refresh();
+      nodes_refresh();
+      if (REC_save == Rec_mode)
+         rec_save(ppt, n_read);
+   }
+   for (i = 0; i < n_read; i++)
+      procs_hlp(ppt[i]);                         // tally this proc_t
 
    // lastly, refresh each window's proc pointers table...
-   if (n_saved == n_alloc)
+   if (n_saved < n_alloc || n_saved < n_used) {
+      n_saved = n_alloc < n_used ? n_used : n_alloc;
       for (i = 0; i < GROUPSMAX; i++)
-         memcpy(Winstk[i].ppt, private_ppt, sizeof(proc_t*) * n_used);
-   else {
-      n_saved = n_alloc;
-      for (i = 0; i < GROUPSMAX; i++) {
-         Winstk[i].ppt = alloc_r(Winstk[i].ppt, sizeof(proc_t*) * n_alloc);
-         memcpy(Winstk[i].ppt, private_ppt, sizeof(proc_t*) * n_used);
+         Winstk[i].ppt = alloc_r(Winstk[i].ppt, sizeof(proc_t*) * n_saved);
+   }
+   for (i = 0; i < GROUPSMAX; i++) {
+      WIN_t *w = &Winstk[i];
+      // (with no more groups than tasks, there's room for either)
+      if (CHKw(w, Show_GROUPS) & Frames_grpflags)
+         w->pptcnt = groups_ppt(GRP_BASE(w), w->ppt);
+      else {
+         memcpy(w->ppt, ppt, sizeof(proc_t*) * n_used);
+         w->pptcnt = n_used;
       }
+      w->srtcnt = 0;                             // none yet sorted, of course
    }
  #undef n_used
 } // end: procs_refresh
@@ -2669,7 +4316,11 @@ static void procs_refresh (void) {
 static void sysinfo_refresh (int forced) {
    static time_t sav_secs;
    time_t cur_secs;
+   int i;
 
+   // (when replaying, each frame brings its own)
+   if (REC_play == Rec_mode)
+      return;
    if (forced)
       sav_secs = 0;
    cur_secs = time(NULL);
@@ -2684,6 +4335,14 @@ static void sysinfo_refresh (int forced) {
       Numa_node_tot = numa_max_node() + 1;
       sav_secs = cur_secs;
    }
+
+   // each cpu's numa node, lest the sorts and task rows keep asking
+   if (Numa_cpu_tot != (int)smp_num_cpus) {
+      Numa_cpu_tot = smp_num_cpus;
+      Numa_cpu_node = alloc_r(Numa_cpu_node, sizeof(int) * Numa_cpu_tot);
+   }
+   for (i = 0; i < Numa_cpu_tot; i++)
+      Numa_cpu_node[i] = numa_node_of_cpu(i);
 } // end: sysinfo_refresh
 
 /*######  Inspect Other Output  ##########################################*/
@@ -3160,7 +4819,7 @@ static void inspection_utility (int pid) {
    int i, key;
    proc_t *p;
 
-   for (i = 0, p = NULL; i < Frame_maxtask; i++)
+   for (i = 0, p = NULL; i < Curwin->pptcnt; i++)
       if (pid == Curwin->ppt[i]->tid) {
          p = Curwin->ppt[i];
          break;
@@ -3262,13 +4921,6 @@ static void before (char *me) {
    i = page_bytes; // from sysinfo.c, at lib init
    while(i > 1024) { i >>= 1; Pg2K_shft++; }
 
-#ifndef OFF_HST_HASH
-   // prep for HST_t's put/get hashing optimizations
-   for (i = 0; i < HHASH_SIZ; i++) HHash_nul[i] = -1;
-   memcpy(HHash_one, HHash_nul, sizeof(HHash_nul));
-   memcpy(HHash_two, HHash_nul, sizeof(HHash_nul));
-#endif
-
    numa_init();
    Numa_node_tot = numa_max_node() + 1;
 
@@ -3498,6 +5150,10 @@ static void configs_read (void) {
       if (fscanf(fp, "Fixed_widest=%d, Summ_mscale=%d, Task_mscale=%d, Zero_suppress=%d\n"
          , &Rc.fixed_widest, &Rc.summ_mscale, &Rc.task_mscale, &Rc.zero_suppress))
             ;                                  // avoid -Wunused-result
+      if (fscanf(fp, "Pool_threads=%d\n", &Rc.pool_threads))
+            ;                                  // avoid -Wunused-result
+      if (fscanf(fp, "Throttle_pct=%d\n", &Rc.throttle_pct))
+            ;                                  // avoid -Wunused-result
 
 try_inspect_entries:
       // we'll start off Inspect stuff with 1 'potential' blank line
@@ -3587,6 +5243,23 @@ default_or_error:
 } // end: configs_read
 
 
+        /*
+         * Return the value of a long option (--name=value or --name value)
+         * should that be what cp is, else NULL. */
+static const char *parse_long (const char *cp, char ***args, const char *name) {
+   size_t n = strlen(name);
+
+   if (strncmp(cp, "--", 2) || strncmp(cp + 2, name, n))
+      return NULL;
+   cp += 2 + n;
+   if ('=' == *cp && cp[1]) return cp + 1;
+   if (!*cp && **args) return *(*args)++;
+   if (*cp && '=' != *cp) return NULL;         // (a longer name, not ours)
+   error_exit(fmtmk(N_fmt(MISSING_lngarg_fmt), name));
+   return NULL;                                // (keep gcc happy)
+} // end: parse_long
+
+
         /*
          * Parse command line arguments.
          * Note: it's assumed that the rc file(s) have already been read
@@ -3607,6 +5280,7 @@ static void parse_args (char **args) {
    static const char numbs_str[] = "+,-.0123456789";
    static const char wrong_str[] = "+,-.";
    float tmp_delay = FLT_MAX;
+   const char *lv, *when = NULL;
    int i;
 
    while (*args) {
@@ -3620,6 +5294,34 @@ static void parse_args (char **args) {
             case '\0':
                break;
             case '-':
+               if (!strncmp(cp, "--cgroup", 8) && (!cp[8] || '=' == cp[8])) {
+                  if (Monpidsidx) error_exit(N_txt(SELECT_clash_txt));
+                  if (cp[8] && cp[9]) cp += 9;
+                  else if (!cp[8] && *args) cp = *args++;
+                  else error_exit(N_txt(MISSING_cgroup_txt));
+                  // as the library would find it, else nothing gets selected
+                  if ((i = check_cgroup(cp)))
+                     error_exit(fmtmk(N_fmt(BAD_cgrppath_fmt), cp
+                        , EXDEV == i ? N_txt(NOT_cgroupfs_txt) : strerror(i)));
+                  Moncgrps = alloc_r(Moncgrps, sizeof(char *) * (Moncgrpsidx + 2));
+                  Moncgrps[Moncgrpsidx++] = (char *)cp;
+                  Moncgrps[Moncgrpsidx] = NULL;
+                  cp += strlen(cp);
+                  continue;
+               }
+               if ((lv = parse_long(cp, &args, "record"))
+               || (lv = parse_long(cp, &args, "replay"))) {
+                  if (Rec_mode) error_exit(N_txt(REPLAY_clashes_txt));
+                  Rec_mode = strncmp(cp, "--record", 8) ? REC_play : REC_save;
+                  Rec_path = lv;
+                  cp += strlen(cp);
+                  continue;
+               }
+               if ((lv = parse_long(cp, &args, "at"))) {
+                  when = lv;
+                  cp += strlen(cp);
+                  continue;
+               }
                if (cp[1]) ++cp;
                else if (*args) cp = *args++;
                if (strspn(cp, wrong_str))
@@ -3689,14 +5391,25 @@ static void parse_args (char **args) {
                OFFw(Curwin, Show_FOREST);
                Curwin->rc.sortindx = i;
                cp += strlen(cp);
-               break;
+               continue;
             case 'O':
-               for (i = 0; i < EU_MAXPFLGS; i++)
-                  puts(N_col(i));
-               bye_bye(NULL);
+               if (cp[1]) cp++;
+               else if (*args && (!strcmp(*args, "csv") || !strcmp(*args, "json")))
+                  cp = *args++;
+               else {
+                  for (i = 0; i < EU_MAXPFLGS; i++)
+                     puts(N_col(i));
+                  bye_bye(NULL);
+               }
+               if (!strcmp(cp, "csv")) Emit_mode = EMIT_csv;
+               else if (!strcmp(cp, "json")) Emit_mode = EMIT_json;
+               else error_exit(fmtmk(N_fmt(BAD_emitfmts_fmt), cp));
+               Batch = 1;
+               cp += strlen(cp);
+               continue;
             case 'p':
             {  int pid; char *p;
-               if (Curwin->usrseltyp) error_exit(N_txt(SELECT_clash_txt));
+               if (Curwin->usrseltyp || Moncgrpsidx) error_exit(N_txt(SELECT_clash_txt));
                do {
                   if (cp[1]) cp++;
                   else if (*args) cp = *args++;
@@ -3730,7 +5443,7 @@ static void parse_args (char **args) {
                else error_exit(fmtmk(N_fmt(MISSING_args_fmt), ch));
                if ((errmsg = user_certify(Curwin, cp, ch))) error_exit(errmsg);
                cp += strlen(cp);
-            }  break;
+            }  continue;
             case 'w':
             {  const char *pn = NULL;
                int ai = 0, ci = 0;
@@ -3763,6 +5476,13 @@ bump_cp:
          error_exit(N_txt(DELAY_secure_txt));
       Rc.delay_time = tmp_delay;
    }
+
+   // and a recording, be it made or replayed (and maybe from some time on)
+   if (when && REC_play != Rec_mode)
+      error_exit(N_txt(REPLAY_onlyso_txt));
+   if (REC_play == Rec_mode && Moncgrpsidx)
+      error_exit(N_txt(REPLAY_clashes_txt));
+   if (Rec_mode) rec_open(when);
 } // end: parse_args
 
 
@@ -3845,7 +5565,7 @@ static void win_reset (WIN_t *q) {
 #else
          q->rc.maxtasks = q->usrseltyp = q->begpflg = q->begtask = 0;
 #endif
-         Monpidsidx = 0;
+         Monpidsidx = Moncgrpsidx = 0;
          osel_clear(q);
          q->findstr[0] = '\0';
 #ifndef USE_X_COLHDR
@@ -4136,10 +5856,11 @@ static inline int find_ofs (const WIN_t *q, const char *buf) {
 
 
 
-   /* This is currently the one true prototype require by top.
-      It is placed here, instead of top.h, so as to avoid a compiler
+   /* These are currently the only true prototypes required by top.
+      They're placed here, instead of top.h, so as to avoid a compiler
       warning when top_nls.c is compiled. */
 static const char *task_show (const WIN_t *q, const proc_t *p);
+static void window_hlp (WIN_t *q, int need);
 
 static void find_string (int ch) {
  #define reDUX (found) ? N_txt(WORD_another_txt) : ""
@@ -4163,7 +5884,8 @@ static void find_string (int ch) {
    }
    if (Curwin->findstr[0]) {
       SETw(Curwin, INFINDS_xxx);
-      for (i = Curwin->begtask; i < Frame_maxtask; i++) {
+      window_hlp(Curwin, Curwin->pptcnt);  // ensure the ppt is fully sorted
+      for (i = Curwin->begtask; i < Curwin->pptcnt; i++) {
          const char *row = task_show(Curwin, Curwin->ppt[i]);
          if (*row && -1 < find_ofs(Curwin, row)) {
             found = 1;
@@ -4330,6 +6052,8 @@ static void write_rcfile (void) {
    // any new addition(s) last, for older rcfiles compatibility...
    fprintf(fp, "Fixed_widest=%d, Summ_mscale=%d, Task_mscale=%d, Zero_suppress=%d\n"
       , Rc.fixed_widest, Rc.summ_mscale, Rc.task_mscale, Rc.zero_suppress);
+   fprintf(fp, "Pool_threads=%d\n", Rc.pool_threads);
+   fprintf(fp, "Throttle_pct=%d\n", Rc.throttle_pct);
 
    if (Inspect.raw)
       fputs(Inspect.raw, fp);
@@ -4347,6 +6071,11 @@ static void write_rcfile (void) {
 static void keys_global (int ch) {
    WIN_t *w = Curwin;             // avoid gcc bloat with a local copy
 
+   // what's replayed can't be signalled, reniced or inspected (nor threaded)
+   if (REC_play == Rec_mode && ch > 0 && strchr("HkrY", ch)) {
+      show_msg(N_txt(REPLAY_notnow_txt));
+      return;
+   }
    switch (ch) {
       case '?':
       case 'h':
@@ -4460,6 +6189,20 @@ static void keys_global (int ch) {
       case '0':
          Rc.zero_suppress = !Rc.zero_suppress;
          break;
+      case '@':
+         if (REC_play != Rec_mode)
+            show_msg(N_txt(REPLAY_onlyso_txt));
+         else {
+            char *str = ioline(N_txt(REPLAY_getwhen_txt));
+            unsigned long long t;
+            if (*str && *str != kbd_ESC) {
+               if ((t = rec_when(str, Rec_frm ? Rec_frm->usecs : 0)))
+                  rec_seek(t);
+               else
+                  show_msg(fmtmk(N_fmt(REPLAY_badwhen_fmt), str));
+            }
+         }
+         break;
       case kbd_ENTER:             // these two have the effect of waking us
       case kbd_SPACE:             // from 'pselect', refreshing the display
          break;                   // and updating any hot-plugged resources
@@ -4518,6 +6261,25 @@ static void keys_summary (int ch) {
             OFFw(w, View_MEMORY);
          }
          break;
+      case '4':
+         // (a first refresh, just to see, then primes this interval's counts)
+         if (!Rec_mode && !CHKw(w, View_MEMNOD)) nodes_refresh();
+         if (!Node_tot)
+            show_msg(N_txt(NUMA_memnot_txt));
+         else {
+            TOGw(w, View_MEMNOD);
+            if (CHKw(w, View_MEMNOD)) SETw(w, View_MEMORY);
+         }
+         break;
+      case 'p':
+         if (!Psi_have)
+            show_msg(N_txt(PRESSR_nohave_txt));
+         else
+            TOGw(w, View_PRESSR);
+         break;
+      case 'D':
+         TOGw(w, View_FRAMES);
+         break;
       case 't':
          if (!CHKw(w, View_STATES))
             SETw(w, View_STATES);
@@ -4640,9 +6402,28 @@ static void keys_task (int ch) {
                 show_msg(errmsg);
          }
          break;
+      case 'v':
+         if (VIZCHKw(w)) {
+            // off, then totaled by cgroup, then by container (never a forest)
+            if (CHKw(w, Show_GRPCGR)) {
+               OFFw(w, Show_GRPCGR);
+               SETw(w, Show_GRPLXC);
+            } else if (CHKw(w, Show_GRPLXC))
+               OFFw(w, Show_GRPLXC);
+            else {
+               SETw(w, Show_GRPCGR);
+               OFFw(w, Show_FOREST);
+            }
+            w->begtask = 0;
+            show_msg(fmtmk(N_fmt(GROUPS_modes_fmt), CHKw(w, Show_GRPCGR)
+               ? N_txt(GROUPS_cgroup_txt) : CHKw(w, Show_GRPLXC)
+               ? N_txt(GROUPS_lxcnam_txt) : N_txt(OFF_one_word_txt)));
+         }
+         break;
       case 'V':
          if (VIZCHKw(w)) {
             TOGw(w, Show_FOREST);
+            OFFw(w, Show_GROUPS);
             if (!ENUviz(w, EU_CMD))
                show_msg(fmtmk(N_fmt(FOREST_modes_fmt) , CHKw(w, Show_FOREST)
                   ? N_txt(ON_word_only_txt) : N_txt(OFF_one_word_txt)));
@@ -4728,7 +6509,7 @@ static void keys_window (int ch) {
          if (VIZCHKw(w)) if (CHKw(w, Show_IDLEPS) && 0 < w->begtask) w->begtask -= 1;
          break;
       case kbd_DOWN:
-         if (VIZCHKw(w)) if (CHKw(w, Show_IDLEPS) && (w->begtask < Frame_maxtask - 1)) w->begtask += 1;
+         if (VIZCHKw(w)) if (CHKw(w, Show_IDLEPS) && (w->begtask < w->pptcnt - 1)) w->begtask += 1;
          break;
 #ifdef USE_X_COLHDR // ------------------------------------
       case kbd_LEFT:
@@ -4802,9 +6583,9 @@ static void keys_window (int ch) {
             }
          break;
       case kbd_PGDN:
-         if (VIZCHKw(w)) if (w->begtask < Frame_maxtask - 1) {
+         if (VIZCHKw(w)) if (w->begtask < w->pptcnt - 1) {
                w->begtask += (w->winlines - 1);
-               if (w->begtask > Frame_maxtask - 1) w->begtask = Frame_maxtask - 1;
+               if (w->begtask > w->pptcnt - 1) w->begtask = w->pptcnt - 1;
                if (0 > w->begtask) w->begtask = 0;
              }
          break;
@@ -4817,7 +6598,7 @@ static void keys_window (int ch) {
          break;
       case kbd_END:
          if (VIZCHKw(w)) {
-            w->begtask = (Frame_maxtask - w->winlines) + 1;
+            w->begtask = (w->pptcnt - w->winlines) + 1;
             if (0 > w->begtask) w->begtask = 0;
             w->begpflg = w->endpflg;
 #ifndef SCROLLVAR_NO
@@ -4877,28 +6658,56 @@ static void keys_xtra (int ch) {
 static proc_t **Seed_ppt;                   // temporary win ppt pointer
 static proc_t **Tree_ppt;                   // forest_create will resize
 static int      Tree_idx;                   // frame_make resets to zero
+static int     *Tree_hsh;                   // hash chain heads, by tid
+static int     *Tree_lnk;                   // chain links, 2 nodes per task
+static int      Tree_msk;                   // Tree_hsh size - 1 (power of 2)
+static TRE_t   *Tree_stk;                   // forest_adds traversal stack
+#define _TREE_(K) ((unsigned)(K) & Tree_msk)
 
         /*
-         * This little recursive guy is the real forest view workhorse.
-         * He fills in the Tree_ppt array and also sets the child indent
-         * level which is stored in an unused proc_t padding byte. */
+         * This little guy is the real forest view workhorse.  He fills
+         * in the Tree_ppt array, depth first, and also sets the child
+         * indent level which is stored in an unused proc_t padding byte.
+         * Rather than scanning the entire Seed_ppt array for children,
+         * a parent need only examine the one hash chain for its tid. */
 static void forest_adds (const int self, int level) {
-   int i;
+   TRE_t *t;
+   proc_t *p, *c;
+   int depth, i, n;
 
-   if (Tree_idx < Frame_maxtask) {          // immunize against insanity
-      if (level > 100) level = 101;         // our arbitrary nests limit
-      Tree_ppt[Tree_idx] = Seed_ppt[self];  // add this as root or child
-      Tree_ppt[Tree_idx++]->pad_3 = level;  // borrow 1 byte, 127 levels
+   depth = -1;
+   i = self;
+   for (;;) {
+      if (Tree_idx >= Frame_maxtask) return;  // immunize against insanity
+      t = &Tree_stk[++depth];
+      t->self = i;
+      t->level = level;
+      t->node = Tree_hsh[_TREE_(Seed_ppt[i]->tid)];
+      if (level > 100) t->level = 101;        // our arbitrary nests limit
+      Tree_ppt[Tree_idx] = Seed_ppt[i];       // add this as root or child
+      Tree_ppt[Tree_idx++]->pad_3 = t->level; // borrow 1 byte, 127 levels
+
+      // got one child any others? (when not, resume with our parent)
+      for (;;) {
+         p = Seed_ppt[t->self];
+         for (n = t->node; n >= 0; n = Tree_lnk[n]) {
+            i = n < Frame_maxtask ? n : n - Frame_maxtask;
 #ifdef TREE_SCANALL
-      for (i = 0; i < Frame_maxtask; i++) {
-         if (i == self) continue;
+            if (i == t->self) continue;
 #else
-      for (i = self + 1; i < Frame_maxtask; i++) {
+            if (i <= t->self) continue;
 #endif
-         if (Seed_ppt[self]->tid == Seed_ppt[i]->tgid
-         || (Seed_ppt[self]->tid == Seed_ppt[i]->ppid && Seed_ppt[i]->tid == Seed_ppt[i]->tgid))
-            forest_adds(i, level + 1);      // got one child any others?
+            c = Seed_ppt[i];
+            if (p->tid == c->tgid
+            || (p->tid == c->ppid && c->tid == c->tgid))
+               break;
+         }
+         if (n >= 0) break;
+         if (--depth < 0) return;
+         t = &Tree_stk[depth];
       }
+      t->node = Tree_lnk[n];                  // our next sibling's search
+      level = t->level + 1;
    }
 } // end: forest_adds
 
@@ -4925,15 +6734,36 @@ static void forest_create (WIN_t *q) {
    static int hwmsav;
    int i;
 
+   if (!Frame_maxtask) return;              // no tasks, so no tables yet
    Seed_ppt = q->ppt;                       // avoid passing WIN_t ptrs
    if (!Tree_idx) {                         // do just once per frame
       if (hwmsav < Frame_maxtask) {         // grow, but never shrink
          hwmsav = Frame_maxtask;
          Tree_ppt = alloc_r(Tree_ppt, sizeof(proc_t*) * hwmsav);
+         Tree_lnk = alloc_r(Tree_lnk, sizeof(int) * hwmsav * 2);
+         Tree_stk = alloc_r(Tree_stk, sizeof(TRE_t) * hwmsav);
+         for (i = 1024; i < hwmsav; i <<= 1) ;
+         Tree_msk = i - 1;                  // at least 1 chain per task
+         Tree_hsh = alloc_r(Tree_hsh, sizeof(int) * i);
       }
 #ifndef TREE_SCANALL
       qsort(Seed_ppt, Frame_maxtask, sizeof(proc_t*), (QFP_t)forest_based);
 #endif
+      /* a task can be the child of one whose tid matches its tgid, or
+         (if it's a process) its ppid -- so it's chained under both of
+         those tids, in ppt order since we build those chains backward */
+      memset(Tree_hsh, -1, sizeof(int) * (Tree_msk + 1));
+      for (i = Frame_maxtask - 1; i >= 0; i--) {
+         int h = _TREE_(Seed_ppt[i]->tgid);
+         Tree_lnk[i] = Tree_hsh[h];
+         Tree_hsh[h] = i;
+         if (Seed_ppt[i]->tid == Seed_ppt[i]->tgid
+         && h != (int)_TREE_(Seed_ppt[i]->ppid)) {
+            h = _TREE_(Seed_ppt[i]->ppid);
+            Tree_lnk[Frame_maxtask + i] = Tree_hsh[h];
+            Tree_hsh[h] = Frame_maxtask + i;
+         }
+      }
       for (i = 0; i < Frame_maxtask; i++)   // avoid any hidepid distortions
          if (!Seed_ppt[i]->pad_3)           // identify real or pretend trees
             forest_adds(i, 0);              // add as parent plus its children
@@ -4959,6 +6789,481 @@ static inline const char *forest_display (const WIN_t *q, const proc_t *p) {
    return buf;
 } // end: forest_display
 
+/*######  Machine Readable Output  #######################################*/
+
+        /*
+         * With -O csv or json, Batch mode frames bypass the usual row
+         * formatting, terminfo and stdio, to instead be built directly in
+         * one large buffer holding raw (unscaled) values.  A json frame is
+         * a single line object, a csv frame a 'summary' line followed by
+         * a 'task' line for each task, with headers (those lines prefixed
+         * by '#') at the start of the output. */
+static char Emit_buf[EMITBUFSIZ];           // frames are built in here,
+static int  Emit_len;                       // to be written by emit_flush
+
+
+        /*
+         * Write whatever has accumulated in the Emit_buf. */
+static void emit_flush (void) {
+   if (Emit_len) fwrite(Emit_buf, 1, Emit_len, stdout);
+   Emit_len = 0;
+} // end: emit_flush
+
+
+        /*
+         * Add some text, as is. */
+static void emit_raw (const char *str, int len) {
+   while (Emit_len + len > EMITBUFSIZ) {
+      int n = EMITBUFSIZ - Emit_len;
+      memcpy(Emit_buf + Emit_len, str, n);
+      Emit_len += n;
+      emit_flush();
+      str += n;
+      len -= n;
+   }
+   memcpy(Emit_buf + Emit_len, str, len);
+   Emit_len += len;
+} // end: emit_raw
+
+
+        /*
+         * Add an unsigned value, with 'dec' of its digits following a
+         * decimal point (so that fixed point values needn't be floats). */
+static void emit_num (unsigned long long num, int dec) {
+   char buf[SMLBUFSIZ], *p = buf + sizeof(buf);
+   int i = 0;
+
+   do {
+      *--p = '0' + num % 10;
+      num /= 10;
+      if (++i == dec) *--p = '.';
+   } while (num || i <= dec);
+   emit_raw(p, buf + sizeof(buf) - p);
+} // end: emit_num
+
+
+        /*
+         * Add a signed value, just like emit_num. */
+static void emit_int (long long num, int dec) {
+   if (num < 0) {
+      emit_raw("-", 1);
+      emit_num(-(unsigned long long)num, dec);
+   } else
+      emit_num(num, dec);
+} // end: emit_int
+
+
+        /*
+         * Add a string, quoted and escaped as json or csv demand (the
+         * latter only when it holds a comma, quote, space or control). */
+static void emit_str (const char *str) {
+   char buf[8];
+   const char *s;
+
+   if (!str) str = "";
+   if (EMIT_csv == Emit_mode) {
+      for (s = str; *s && (unsigned char)*s > ' ' && ',' != *s && '"' != *s; s++) ;
+      if (!*s) {
+         emit_raw(str, s - str);
+         return;
+      }
+   }
+   emit_raw("\"", 1);
+   for (s = str; *s; s++) {
+      if ('"' == *s)
+         emit_raw(EMIT_csv == Emit_mode ? "\"\"" : "\\\"", 2);
+      else if ('\\' == *s && EMIT_json == Emit_mode)
+         emit_raw("\\\\", 2);
+      else if ((unsigned char)*s < ' ' && EMIT_json == Emit_mode)
+         emit_raw(buf, snprintf(buf, sizeof(buf), "\\u%04x", *s));
+      else
+         emit_raw(s, 1);
+   }
+   emit_raw("\"", 1);
+} // end: emit_str
+
+
+        /*
+         * Begin a value -- with its separator and, for json, its name. */
+static void emit_key (int first, const char *name) {
+   if (!first) emit_raw(",", 1);
+   if (EMIT_json == Emit_mode) {
+      emit_str(name);
+      emit_raw(":", 1);
+   }
+} // end: emit_key
+
+
+        /*
+         * Add one task's values for the window's fields, by their actual
+         * units -- kibibytes, seconds and percentages to 2 decimals. */
+static void emit_task (const WIN_t *q, const proc_t *p) {
+ #define pages2K(n)  (unsigned long)( (n) << Pg2K_shft )
+ #define pcnt(f)     emit_num((unsigned long long)((f) * 100 + .5), 2)
+   int first = (EMIT_json == Emit_mode), x;
+
+   // we may yet need those costlier fields not read with all the others
+   if (Frames_lazflags && !p->pad_2) {
+      readproc_more((proc_t *)p, Frames_lazflags);
+      ((proc_t *)p)->pad_2 = 1;
+   }
+   for (x = 0; x < q->maxpflgs; x++) {
+      FLG_t i = q->procflgs[x];
+
+#ifndef USE_X_COLHDR
+      if (EU_XON == i || EU_XOF == i) continue;
+#endif
+      emit_key(first, N_col(i));
+      first = 0;
+      switch (i) {
+         case EU_CGN:
+            emit_str(p->cgname);
+            break;
+         case EU_CGR:
+            emit_str(p->cgroup ? p->cgroup[0] : NULL);
+            break;
+         case EU_CMD:
+            emit_str(CHKw(q, Show_CMDLIN) && p->cmdline ? *p->cmdline : p->cmd);
+            break;
+         case EU_COD:
+            emit_num(pages2K(p->trs), 0);
+            break;
+         case EU_CPA:
+            pcnt(HRING_AVG(p, Hring_cpusum) / (10.0 * HRING_len));
+            break;
+         case EU_CPG:
+            emit_str(spark_make(p, 1, Fieldstab[i].width));
+            break;
+         case EU_CPN:
+            emit_num(p->processor, 0);
+            break;
+         case EU_CPU:
+         {  float u = (float)p->pcpu * Frame_etscale;
+            if (u > 100.0 * p->nlwp) u = 100.0 * p->nlwp;
+            if (u > Cpu_pmax) u = Cpu_pmax;
+            pcnt(u);
+         }
+            break;
+         case EU_DAT:
+            emit_num(pages2K(p->drs), 0);
+            break;
+         case EU_DLB:
+            pcnt((float)p->delay_blkio * Frame_dlyscale);
+            break;
+         case EU_DLC:
+            pcnt((float)p->delay_cpu * Frame_dlyscale);
+            break;
+         case EU_DLR:
+            pcnt((float)p->delay_freepages * Frame_dlyscale);
+            break;
+         case EU_DLS:
+            pcnt((float)p->delay_swapin * Frame_dlyscale);
+            break;
+         case EU_DRT:
+            emit_num(p->dt, 0);
+            break;
+         case EU_ENV:
+            emit_str(p->environ ? p->environ[0] : NULL);
+            break;
+         case EU_FL1:
+            emit_num(p->maj_flt, 0);
+            break;
+         case EU_FL2:
+            emit_num(p->min_flt, 0);
+            break;
+         case EU_FLA:
+            emit_num(HRING_AVG(p, Hring_fltsum) / HRING_len, 0);
+            break;
+         case EU_FLG:
+            emit_num(p->flags, 0);
+            break;
+         case EU_FV1:
+            emit_num(p->maj_delta, 0);
+            break;
+         case EU_FV2:
+            emit_num(p->min_delta, 0);
+            break;
+         case EU_GID:
+            emit_num(p->egid, 0);
+            break;
+         case EU_GRP:
+            emit_str(p->egroup);
+            break;
+         case EU_LXC:
+            emit_str(p->lxcname);
+            break;
+         case EU_MEM:
+            pcnt((float)pages2K(p->resident) * 100 / kb_main_total);
+            break;
+         case EU_NCE:
+            emit_int(p->nice, 0);
+            break;
+         case EU_NMA:
+            emit_int(NUMA_NODE(p->processor), 0);
+            break;
+         case EU_NMK:
+            emit_str(p->numa_nodes);
+            break;
+         case EU_NMP:
+            emit_int(p->numa_pref, 0);
+            break;
+         case EU_NS1:  // IPCNS
+         case EU_NS2:  // MNTNS
+         case EU_NS3:  // NETNS
+         case EU_NS4:  // PIDNS
+         case EU_NS5:  // USERNS
+         case EU_NS6:  // UTSNS
+            emit_int(p->ns[i - EU_NS1], 0);
+            break;
+         case EU_OOA:
+            emit_int(p->oom_adj, 0);
+            break;
+         case EU_OOM:
+            emit_int(p->oom_score, 0);
+            break;
+         case EU_PGD:
+            emit_int(p->pgrp, 0);
+            break;
+         case EU_PID:
+            emit_int(p->tid, 0);
+            break;
+         case EU_PPD:
+            emit_int(p->ppid, 0);
+            break;
+         case EU_PRI:
+            emit_int(p->priority, 0);
+            break;
+         case EU_RES:
+            emit_num(pages2K(p->resident), 0);
+            break;
+         case EU_RSG:
+            emit_str(spark_make(p, 0, Fieldstab[i].width));
+            break;
+         case EU_RZA:
+            emit_num(p->vm_rss_anon, 0);
+            break;
+         case EU_RZF:
+            emit_num(p->vm_rss_file, 0);
+            break;
+         case EU_RZL:
+            emit_num(p->vm_lock, 0);
+            break;
+         case EU_RZS:
+            emit_num(p->vm_rss_shared, 0);
+            break;
+         case EU_SGD:
+            emit_str(p->supgid);
+            break;
+         case EU_SGN:
+            emit_str(p->supgrp);
+            break;
+         case EU_SHR:
+            emit_num(pages2K(p->share), 0);
+            break;
+         case EU_SID:
+            emit_int(p->session, 0);
+            break;
+         case EU_STA:
+         {  char s[2] = { p->state, '\0' };
+            emit_str(s);
+         }
+            break;
+         case EU_SWP:
+            emit_num(p->vm_swap, 0);
+            break;
+         case EU_TGD:
+            emit_int(p->tgid, 0);
+            break;
+         case EU_THD:
+            emit_int(p->nlwp, 0);
+            break;
+         case EU_TM2:
+         case EU_TME:
+         {  TIC_t t = p->utime + p->stime;
+            if (CHKw(q, Show_CTIMES)) t += (p->cutime + p->cstime);
+            emit_num(t * 100 / Hertz, 2);
+         }
+            break;
+         case EU_TPG:
+            emit_int(p->tpgid, 0);
+            break;
+         case EU_TTY:
+         {  char tmp[SMLBUFSIZ];
+            dev_to_tty(tmp, sizeof(tmp) - 1, p->tty, p->tid, ABBREV_DEV);
+            emit_str(tmp);
+         }
+            break;
+         case EU_UED:
+            emit_num(p->euid, 0);
+            break;
+         case EU_UEN:
+            emit_str(p->euser);
+            break;
+         case EU_URD:
+            emit_num(p->ruid, 0);
+            break;
+         case EU_URN:
+            emit_str(p->ruser);
+            break;
+         case EU_USD:
+            emit_num(p->suid, 0);
+            break;
+         case EU_USE:
+            emit_num(p->vm_swap + p->vm_rss, 0);
+            break;
+         case EU_USN:
+            emit_str(p->suser);
+            break;
+         case EU_VRT:
+            emit_num(pages2K(p->size), 0);
+            break;
+         case EU_WCH:
+            emit_str(REC_play == Rec_mode ? "-" : lookup_wchan(p->tid));
+            break;
+         default:                 // keep gcc happy
+            emit_str(NULL);
+            break;
+      }
+   }
+ #undef pcnt
+ #undef pages2K
+} // end: emit_task
+
+
+        /*
+         * This guy replaces both summary_show and window_show when
+         * the output is to be csv or json, emitting an entire frame. */
+static void emit_frame (WIN_t *q) {
+ #define TRIMz(x)  ((tz = (SIC_t)(x)) < 0 ? 0 : tz)
+   static const struct {
+      const char *name;
+      int dec;
+   } sumtab[] = {
+      { "time", 3 }, { "uptime", 2 },
+      { "load1", 2 }, { "load5", 2 }, { "load15", 2 },
+      { "tasks", 0 }, { "running", 0 }, { "sleeping", 0 }, { "stopped", 0 }, { "zombie", 0 },
+      { "cpu_us", 0 }, { "cpu_sy", 0 }, { "cpu_ni", 0 }, { "cpu_id", 0 },
+      { "cpu_wa", 0 }, { "cpu_hi", 0 }, { "cpu_si", 0 }, { "cpu_st", 0 },
+      { "mem_total", 0 }, { "mem_free", 0 }, { "mem_used", 0 }, { "mem_buff_cache", 0 },
+      { "mem_avail", 0 }, { "swap_total", 0 }, { "swap_free", 0 }, { "swap_used", 0 },
+      { "us_procs", 0 }, { "us_cpus", 0 }, { "us_sysinfo", 0 }, { "us_sort", 0 },
+      { "us_show", 0 }, { "reads", 0 }, { "read_bytes", 0 }, { "allocs", 0 }
+   };
+   static int headers;
+   long long v[MAXTBL(sumtab)];
+   const CPU_t *cpu;
+   struct timeval tv;
+   double up, idle, av[3];
+   SIC_t tz;
+   double t;
+   int i, x;
+
+   if (!Rec_mode) {                         // (else procs_refresh did)
+      t = secs_now(CLOCK_MONOTONIC);
+      cpus_refresh();
+      Frame_phases[PHASE_cpus] += secs_now(CLOCK_MONOTONIC) - t;
+   }
+   cpu = &Cpu_tics[smp_num_cpus];
+   i = 0;
+   if (REC_play == Rec_mode) {
+      v[i++] = Rec_frm->usecs / 1000;
+      v[i++] = Rec_sys[RS_uptime];
+      v[i++] = Rec_sys[RS_load1];
+      v[i++] = Rec_sys[RS_load5];
+      v[i++] = Rec_sys[RS_load15];
+   } else {
+      gettimeofday(&tv, NULL);
+      uptime(&up, &idle);
+      loadavg(&av[0], &av[1], &av[2]);
+      v[i++] = (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+      v[i++] = up * 100;
+      v[i++] = av[0] * 100 + .5;
+      v[i++] = av[1] * 100 + .5;
+      v[i++] = av[2] * 100 + .5;
+   }
+   v[i++] = Frame_maxtask;
+   v[i++] = Frame_running;
+   v[i++] = Frame_sleepin;
+   v[i++] = Frame_stopped;
+   v[i++] = Frame_zombied;
+   v[i++] = TRIMz(cpu->cur.u - cpu->sav.u);
+   v[i++] = TRIMz(cpu->cur.s - cpu->sav.s);
+   v[i++] = TRIMz(cpu->cur.n - cpu->sav.n);
+   v[i++] = TRIMz(cpu->cur.i - cpu->sav.i);
+   v[i++] = TRIMz(cpu->cur.w - cpu->sav.w);
+   v[i++] = TRIMz(cpu->cur.x - cpu->sav.x);
+   v[i++] = TRIMz(cpu->cur.y - cpu->sav.y);
+   v[i++] = TRIMz(cpu->cur.z - cpu->sav.z);
+   v[i++] = kb_main_total;
+   v[i++] = kb_main_free;
+   v[i++] = kb_main_used;
+   v[i++] = kb_main_buffers + kb_main_cached;
+   v[i++] = kb_main_available;
+   v[i++] = kb_swap_total;
+   v[i++] = kb_swap_free;
+   v[i++] = kb_swap_used;
+   // and what the last frame cost us (its 'show' being this output)
+   for (x = 0; x < PHASE_MAX; x++)
+      v[i++] = Frame_costs.secs[x] * 1000000;
+   v[i++] = Frame_costs.reads;
+   v[i++] = Frame_costs.bytes;
+   v[i++] = Frame_costs.allocs;
+
+   if (EMIT_csv == Emit_mode && !headers) {
+      emit_raw("#summary", 8);
+      for (i = 0; i < MAXTBL(sumtab); i++) {
+         emit_raw(",", 1);
+         emit_str(sumtab[i].name);
+      }
+      emit_raw("\n#task,time", 11);
+      for (x = 0; x < q->maxpflgs; x++) {
+#ifndef USE_X_COLHDR
+         if (EU_XON == q->procflgs[x] || EU_XOF == q->procflgs[x]) continue;
+#endif
+         emit_raw(",", 1);
+         emit_str(N_col(q->procflgs[x]));
+      }
+      emit_raw("\n", 1);
+      headers = 1;
+   }
+   if (EMIT_csv == Emit_mode) emit_raw("summary", 7);
+   else emit_raw("{\"summary\":{", 12);
+   for (i = 0; i < MAXTBL(sumtab); i++) {
+      emit_key(EMIT_json == Emit_mode && !i, sumtab[i].name);
+      emit_int(v[i], sumtab[i].dec);
+   }
+   if (EMIT_csv == Emit_mode) emit_raw("\n", 1);
+   else emit_raw("},\"tasks\":[", 11);
+
+   // the tasks, in the window's order and subject to its filtering
+   t = secs_now(CLOCK_MONOTONIC);
+   if (CHKw(q, Show_FOREST) && !CHKw(q, Show_GROUPS))
+      forest_create(q);
+   else {
+      q->srtcnt = 0;
+      window_hlp(q, q->pptcnt);
+   }
+   Frame_phases[PHASE_sort] += secs_now(CLOCK_MONOTONIC) - t;
+   for (i = x = 0; i < q->pptcnt; i++) {
+      const proc_t *p = q->ppt[i];
+      if (q->rc.maxtasks && x >= q->rc.maxtasks) break;
+      if ((!CHKw(q, Show_IDLEPS) && 0 >= p->pcpu) || !user_matched(q, p))
+         continue;
+      if (EMIT_csv == Emit_mode) {
+         emit_raw("task,", 5);
+         emit_int(v[0], 3);
+      } else
+         emit_raw(x ? ",{" : "{", x ? 2 : 1);
+      emit_task(q, p);
+      emit_raw(EMIT_csv == Emit_mode ? "\n" : "}", 1);
+      ++x;
+   }
+   if (EMIT_json == Emit_mode) emit_raw("]}\n", 3);
+   emit_flush();
+   fflush(stdout);
+ #undef TRIMz
+} // end: emit_frame
+
 /*######  Main Screen routines  ##########################################*/
 
         /*
@@ -4970,13 +7275,13 @@ static void do_key (int ch) {
    } key_tab[] = {
       { keys_global,
          { '?', 'B', 'd', 'E', 'e', 'F', 'f', 'g', 'H', 'h'
-         , 'I', 'k', 'r', 's', 'X', 'Y', 'Z', '0'
+         , 'I', 'k', 'r', 's', 'X', 'Y', 'Z', '0', '@'
          , kbd_ENTER, kbd_SPACE, '\0' } },
       { keys_summary,
-         { '1', '2', '3', 'C', 'l', 'm', 't', '\0' } },
+         { '1', '2', '3', '4', 'C', 'D', 'l', 'm', 'p', 't', '\0' } },
       { keys_task,
          { '#', '<', '>', 'b', 'c', 'i', 'J', 'j', 'n', 'O', 'o'
-         , 'R', 'S', 'U', 'u', 'V', 'x', 'y', 'z'
+         , 'R', 'S', 'U', 'u', 'V', 'v', 'x', 'y', 'z'
          , kbd_CtrlO, '\0' } },
       { keys_window,
          { '+', '-', '=', '_', '&', 'A', 'a', 'G', 'L', 'w'
@@ -5107,21 +7412,26 @@ static void summary_hlp (CPU_t *cpu, const char *pfx) {
          * In support of a new frame:
          *    1) Display uptime and load average (maybe)
          *    2) Display task/cpu states (maybe)
-         *    3) Display memory & swap usage (maybe) */
+         *    3) Display memory & swap usage (maybe)
+         *    4) Display pressure stall percentages (maybe)
+         *    5) Display our own costs of the last frame (maybe) */
 static void summary_show (void) {
  #define isROOM(f,n) (CHKw(w, f) && Msg_row + (n) < Screen_rows - 1)
  #define anyFLG 0xffffff
    WIN_t *w = Curwin;             // avoid gcc bloat with a local copy
    char tmp[MEDBUFSIZ];
+   double t;
    int i;
 
    // Display Uptime and Loadavg
    if (isROOM(View_LOADAV, 1)) {
+      const char *up = REC_play == Rec_mode
+         ? Rec_strs[Rec_sys[RS_upline]] : sprint_uptime(0);
       if (!Rc.mode_altscr)
-         show_special(0, fmtmk(LOADAV_line, Myname, sprint_uptime(0)));
+         show_special(0, fmtmk(LOADAV_line, Myname, up));
       else
          show_special(0, fmtmk(CHKw(w, Show_TASKON)? LOADAV_line_alt : LOADAV_line
-            , w->grpname, sprint_uptime(0)));
+            , w->grpname, up));
       Msg_row += 1;
    } // end: View_LOADAV
 
@@ -5133,7 +7443,11 @@ static void summary_show (void) {
          , Frame_stopped, Frame_zombied));
       Msg_row += 1;
 
-      cpus_refresh();
+      if (!Rec_mode) {                      // (else procs_refresh did)
+         t = secs_now(CLOCK_MONOTONIC);
+         cpus_refresh();
+         Frame_phases[PHASE_cpus] += secs_now(CLOCK_MONOTONIC) - t;
+      }
 
       if (!Numa_node_tot) goto numa_nope;
 
@@ -5274,6 +7588,24 @@ numa_nope:
             , N_txt(WORD_abv_mem_txt)));
       }
       Msg_row += 2;
+
+      // then each node's memory, screen height permitting...
+      if (CHKw(w, View_MEMNOD)) {
+       #define dlT(f) ( m->f > s->f ? m->f - s->f : 0 )
+         if (!Rec_mode) nodes_refresh();    // (else procs_refresh did)
+         for (i = 0; i < Node_tot; i++) {
+            const node_mem *m = &Node_now[i], *s = &Node_sav[i];
+            if (!m->total) continue;        // (offline, or no memory)
+            if (!isROOM(anyFLG, 1)) break;
+            snprintf(tmp, sizeof(tmp), N_fmt(NUMA_nodenam_fmt), i);
+            prT(bfT(0), (float)m->total / scT(div)); prT(bfT(1), (float)m->free / scT(div));
+            prT(bfT(2), (float)m->file / scT(div));  prT(bfT(3), (float)m->anon / scT(div));
+            show_special(0, fmtmk(N_unq(MEMORY_nodes_fmt)
+               , tmp, bfT(0), bfT(1), bfT(2), bfT(3), dlT(hit), dlT(miss)));
+            Msg_row += 1;
+         }
+       #undef dlT
+      }
     #undef bfT
     #undef scT
     #undef mkM
@@ -5281,6 +7613,29 @@ numa_nope:
     #undef prT
    } // end: View_MEMORY
 
+   // Display Pressure Stall Information
+   if (!Rec_mode) psi_refresh();            // (else procs_refresh did)
+   if (Psi_have && isROOM(View_PRESSR, 1)) {
+      double some[PSI_MAX], full[PSI_MAX];
+
+      pressure_pct(&Psi_now, &Psi_sav, some, full);
+      show_special(0, fmtmk(N_unq(PRESSR_line_1_fmt)
+         , some[PSI_CPU], full[PSI_CPU], some[PSI_MEM], full[PSI_MEM]
+         , some[PSI_IO], full[PSI_IO]));
+      Msg_row += 1;
+   } // end: View_PRESSR
+
+   // Display our own costs, as of the last frame
+   if (isROOM(View_FRAMES, 2)) {
+    #define usC(p) (unsigned long)(Frame_costs.secs[p] * 1000000)
+      show_special(0, fmtmk(N_unq(FRAMES_lines_fmt)
+         , Frame_costs.tasks, Frame_costs.reads, Frame_costs.bytes, Frame_costs.allocs
+         , usC(PHASE_procs), usC(PHASE_cpus), usC(PHASE_sysinfo), usC(PHASE_sort)
+         , usC(PHASE_show)));
+      Msg_row += 2;
+    #undef usC
+   } // end: View_FRAMES
+
  #undef isROOM
  #undef anyFLG
 } // end: summary_show
@@ -5302,6 +7657,13 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
    char *rp;
    int x;
 
+   // we may yet need those costlier fields not read with all the others
+   // ( and if so, 'pad_2' is borrowed to avoid reading them more than once )
+   if (Frames_lazflags && !p->pad_2) {
+      readproc_more((proc_t *)p, Frames_lazflags);
+      ((proc_t *)p)->pad_2 = 1;
+   }
+
    // we must begin a row with a possible window number in mind...
    *(rp = rbuf) = '\0';
    if (Rc.mode_altscr) rp = scat(rp, " ");
@@ -5340,6 +7702,12 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
          case EU_COD:
             cp = scale_mem(S, pages2K(p->trs), W, Jn);
             break;
+         case EU_CPA:
+            cp = scale_pcnt(HRING_AVG(p, Hring_cpusum) / (10.0f * HRING_len), W, Jn);
+            break;
+         case EU_CPG:
+            cp = make_str(spark_make(p, 1, W), W, Js, AUTOX_NO);
+            break;
          case EU_CPN:
             cp = make_num(p->processor, W, Jn, AUTOX_NO, 0);
             break;
@@ -5355,6 +7723,18 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
          case EU_DAT:
             cp = scale_mem(S, pages2K(p->drs), W, Jn);
             break;
+         case EU_DLB:
+            cp = scale_pcnt((float)p->delay_blkio * Frame_dlyscale, W, Jn);
+            break;
+         case EU_DLC:
+            cp = scale_pcnt((float)p->delay_cpu * Frame_dlyscale, W, Jn);
+            break;
+         case EU_DLR:
+            cp = scale_pcnt((float)p->delay_freepages * Frame_dlyscale, W, Jn);
+            break;
+         case EU_DLS:
+            cp = scale_pcnt((float)p->delay_swapin * Frame_dlyscale, W, Jn);
+            break;
          case EU_DRT:
             cp = scale_num(p->dt, W, Jn);
             break;
@@ -5367,6 +7747,9 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
          case EU_FL2:
             cp = scale_num(p->min_flt, W, Jn);
             break;
+         case EU_FLA:
+            cp = scale_num(HRING_AVG(p, Hring_fltsum) / HRING_len, W, Jn);
+            break;
          case EU_FLG:
             cp = make_str(hex_make(p->flags, 1), W, Js, AUTOX_NO);
             break;
@@ -5392,7 +7775,13 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
             cp = make_num(p->nice, W, Jn, AUTOX_NO, 1);
             break;
          case EU_NMA:
-            cp = make_num(numa_node_of_cpu(p->processor), W, Jn, AUTOX_NO, 0);
+            cp = make_num(NUMA_NODE(p->processor), W, Jn, AUTOX_NO, 0);
+            break;
+         case EU_NMK:
+            makeVAR(p->numa_nodes ? p->numa_nodes : "-");
+            break;
+         case EU_NMP:
+            cp = make_num(p->numa_pref, W, Jn, AUTOX_NO, 0);
             break;
          case EU_NS1:  // IPCNS
          case EU_NS2:  // MNTNS
@@ -5428,6 +7817,9 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
          case EU_RES:
             cp = scale_mem(S, pages2K(p->resident), W, Jn);
             break;
+         case EU_RSG:
+            cp = make_str(spark_make(p, 0, W), W, Js, AUTOX_NO);
+            break;
          case EU_RZA:
             cp = scale_mem(S, p->vm_rss_anon, W, Jn);
             break;
@@ -5505,7 +7897,7 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
             cp = scale_mem(S, pages2K(p->size), W, Jn);
             break;
          case EU_WCH:
-            cp = make_str(lookup_wchan(p->tid), W, Js, EU_WCH);
+            cp = make_str(REC_play == Rec_mode ? "-" : lookup_wchan(p->tid), W, Js, EU_WCH);
             break;
          default:                 // keep gcc happy
             continue;
@@ -5552,6 +7944,134 @@ static const char *task_show (const WIN_t *q, const proc_t *p) {
 } // end: task_show
 
 
+        /*
+         * A window_hlp *Helper* function to sort part of a ppt by some
+         * numeric field.  Each task's key is extracted just the once,
+         * then the keys are ordered by an lsd radix sort, skipping any
+         * byte that's the same in every key.  Being stable, like glibc's
+         * qsort, that radix sort leaves any ties in their current order. */
+static void sort_keys (proc_t **ppt, int n, KFP_t key) {
+   static SRT_t *one, *two;
+   static int hwmsav;
+   unsigned long long flip = Frame_srtflg > 0 ? ~0ull : 0;
+   int cnts[8][256], b, i, pos, t;
+   SRT_t *v;
+
+   if (n < 2) return;                            // already in order
+   if (hwmsav < n) {                             // grow, but never shrink
+      hwmsav = n;
+      one = alloc_r(one, sizeof(SRT_t) * hwmsav);
+      two = alloc_r(two, sizeof(SRT_t) * hwmsav);
+   }
+   memset(cnts, 0, sizeof(cnts));
+   for (i = 0; i < n; i++) {
+      // when sorting normally (high to low), the keys go in reverse
+      one[i].key = key(ppt[i]) ^ flip;
+      one[i].p = ppt[i];
+      for (b = 0; b < 8; b++)
+         cnts[b][(one[i].key >> (b * 8)) & 0xff]++;
+   }
+   for (b = 0; b < 8; b++) {
+      if (cnts[b][(one[0].key >> (b * 8)) & 0xff] == n)
+         continue;
+      for (pos = i = 0; i < 256; i++) {
+         t = cnts[b][i];
+         cnts[b][i] = pos;
+         pos += t;
+      }
+      for (i = 0; i < n; i++)
+         two[cnts[b][(one[i].key >> (b * 8)) & 0xff]++] = one[i];
+      v = one; one = two; two = v;
+   }
+   for (i = 0; i < n; i++)
+      ppt[i] = one[i].p;
+} // end: sort_keys
+
+
+        /*
+         * This guy orders a window's ppt for window_show (or find_string)
+         * but, since so few rows are usually shown, he'll only select and
+         * sort the first 'need' tasks.  The remainder follow in original
+         * order and are sorted should he be called again in that frame.
+         * Ties go to the task appearing earlier in the ppt, just as they
+         * did with the (glibc merge sort) qsort of the whole ppt before.
+         * Numeric fields are compared by keys extracted once per task. */
+static void window_hlp (WIN_t *q, int need) {
+ #define isAFTER(a,b)  ( key \
+   ? keys[a] > keys[b] || (keys[a] == keys[b] && a > b) \
+   : (x = sort(&orig[a], &orig[b])) > 0 || (!x && a > b) )
+ #define siftDOWN(e,m) { for (j = 0; (c = 2 * j + 1) < m; j = c) { \
+   if (c + 1 < m && isAFTER(heap[c + 1], heap[c])) c++; \
+   if (!isAFTER(heap[c], e)) break; \
+   heap[j] = heap[c]; } heap[j] = e; }
+   static proc_t **orig;                         // the ppt as given to us
+   static int *heap, hwmsav;                     // orig indexes, worst on top
+   static unsigned long long *keys;              // orig keys, if numeric
+   QFP_t sort = Fieldstab[q->rc.sortindx].sort;
+   KFP_t key = Fieldstab[q->rc.sortindx].key;
+   unsigned long long flip;
+   int c, i, j, k, n, x;
+
+   if (CHKw(q, Qsrt_NORMAL)) Frame_srtflg = 1;   // this is always needed!
+   else Frame_srtflg = -1;
+   Frame_ctimes = CHKw(q, Show_CTIMES);          // this & next, only maybe
+   Frame_cmdlin = CHKw(q, Show_CMDLIN);
+
+   // were some rows filtered out, or is find_string searching, finish up
+   if (q->srtcnt) {
+      if (q->srtcnt < q->pptcnt) {
+         if (key) sort_keys(q->ppt + q->srtcnt, q->pptcnt - q->srtcnt, key);
+         else qsort(q->ppt + q->srtcnt, q->pptcnt - q->srtcnt, sizeof(proc_t*), sort);
+      }
+      q->srtcnt = q->pptcnt;
+      return;
+   }
+   // when scrolled deeply, there's little to be gained by a selection
+   if (need < 1) need = 1;
+   if (need > q->pptcnt / 8) {
+      if (key) sort_keys(q->ppt, q->pptcnt, key);
+      else qsort(q->ppt, q->pptcnt, sizeof(proc_t*), sort);
+      q->srtcnt = q->pptcnt;
+      return;
+   }
+   if (hwmsav < q->pptcnt) {                 // grow, but never shrink
+      hwmsav = q->pptcnt;
+      orig = alloc_r(orig, sizeof(proc_t*) * hwmsav);
+      heap = alloc_r(heap, sizeof(int) * hwmsav);
+      keys = alloc_r(keys, sizeof(unsigned long long) * hwmsav);
+   }
+   memcpy(orig, q->ppt, sizeof(proc_t*) * q->pptcnt);
+   if (key) {
+      // as with sort_keys, normal (high to low) order means reversed keys
+      flip = Frame_srtflg > 0 ? ~0ull : 0;
+      for (i = 0; i < q->pptcnt; i++)
+         keys[i] = key(orig[i]) ^ flip;
+   }
+
+   // keep a heap of those sorting first, where most need just 1 compare
+   for (n = i = 0; i < q->pptcnt; i++) {
+      if (n < need) {
+         for (j = n++; j && isAFTER(i, heap[(j - 1) / 2]); j = (j - 1) / 2)
+            heap[j] = heap[(j - 1) / 2];
+         heap[j] = i;
+      } else if (isAFTER(heap[0], i))
+         siftDOWN(i, n)
+   }
+   // then repeatedly pulling its top yields those in reverse order
+   for (k = n - 1; k >= 0; k--) {
+      q->ppt[k] = orig[heap[0]];
+      orig[heap[0]] = NULL;
+      i = heap[k];
+      siftDOWN(i, k)
+   }
+   for (k = n, i = 0; i < q->pptcnt; i++)
+      if (orig[i]) q->ppt[k++] = orig[i];
+   q->srtcnt = n;
+ #undef siftDOWN
+ #undef isAFTER
+} // end: window_hlp
+
+
         /*
          * Squeeze as many tasks as we can into a single window,
          * after sorting the passed proc table. */
@@ -5561,34 +8081,37 @@ static int window_show (WIN_t *q, int wmax) {
     ( actual 'running' tasks will be a subset of those selected ) */
  #define isBUSY(x)   (0 < x->pcpu)
  #define winMIN(a,b) ((a < b) ? a : b)
+   double t;
    int i, lwin;
 
    // Display Column Headings -- and distract 'em while we sort (maybe)
    PUFF("\n%s%s%s", q->capclr_hdr, q->columnhdr, Caps_endline);
 
-   if (CHKw(q, Show_FOREST))
-      forest_create(q);
-   else {
-      if (CHKw(q, Qsrt_NORMAL)) Frame_srtflg = 1;   // this is always needed!
-      else Frame_srtflg = -1;
-      Frame_ctimes = CHKw(q, Show_CTIMES);          // this & next, only maybe
-      Frame_cmdlin = CHKw(q, Show_CMDLIN);
-      qsort(q->ppt, Frame_maxtask, sizeof(proc_t*), Fieldstab[q->rc.sortindx].sort);
-   }
-
    i = q->begtask;
    lwin = 1;                                        // 1 for the column header
    wmax = winMIN(wmax, q->winlines + 1);            // ditto for winlines, too
 
+   t = secs_now(CLOCK_MONOTONIC);
+   if (CHKw(q, Show_FOREST) && !CHKw(q, Show_GROUPS)) {
+      forest_create(q);
+      q->srtcnt = q->pptcnt;
+   } else {
+      q->srtcnt = 0;
+      window_hlp(q, i + wmax - lwin);
+   }
+   Frame_phases[PHASE_sort] += secs_now(CLOCK_MONOTONIC) - t;
+
    /* the least likely scenario is also the most costly, so we'll try to avoid
       checking some stuff with each iteration and check it just once... */
    if (CHKw(q, Show_IDLEPS) && !q->usrseltyp)
-      while (i < Frame_maxtask && lwin < wmax) {
+      while (i < q->pptcnt && lwin < wmax) {
+         if (i == q->srtcnt) window_hlp(q, q->pptcnt);
          if (*task_show(q, q->ppt[i++]))
             ++lwin;
       }
    else
-      while (i < Frame_maxtask && lwin < wmax) {
+      while (i < q->pptcnt && lwin < wmax) {
+         if (i == q->srtcnt) window_hlp(q, q->pptcnt);
          if ((CHKw(q, Show_IDLEPS) || isBUSY(q->ppt[i]))
          && user_matched(q, q->ppt[i])
          && *task_show(q, q->ppt[i]))
@@ -5603,6 +8126,64 @@ static int window_show (WIN_t *q, int wmax) {
 
 /*######  Entry point plus two  ##########################################*/
 
+        /*
+         * This guy samples our reads and allocations so far, the former
+         * as the kernel counts them (all threads), if it does so at all */
+static void frame_ios (FRM_t *f) {
+   static int fd = -2;
+   char buf[SMLBUFSIZ], *p;
+   ssize_t n;
+
+   f->reads = f->bytes = 0;
+   f->allocs = __atomic_load_n(&Frame_allocs, __ATOMIC_RELAXED);
+   if (-2 == fd) fd = open("/proc/self/io", O_RDONLY);
+   if (0 > fd || 0 >= (n = pread(fd, buf, sizeof(buf) - 1, 0)))
+      return;
+   buf[n] = '\0';
+   if ((p = strstr(buf, "rchar:"))) f->bytes = strtoull(p + 6, NULL, 10);
+   if ((p = strstr(buf, "syscr:"))) f->reads = strtoull(p + 6, NULL, 10);
+} // end: frame_ios
+
+
+        /*
+         * This guy settles what the frame just made has cost us, both the
+         * elapsed time (as some /proc reads can stall) and cpu time (as our
+         * pool's threads add up).  Should that cost exceed our share of the
+         * delay, the delay will be stretched (within reason) so we're never
+         * the busiest process on some already overburdened host.
+         * Everything it cost is also kept, for the View_FRAMES line. */
+static void frame_cost (const FRM_t *beg, double wall, double cpu) {
+   double cost, want;
+   int i;
+
+   wall = secs_now(CLOCK_MONOTONIC) - wall;
+   cpu = secs_now(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+
+   // whatever the other phases didn't claim went to showing the frame
+   Frame_phases[PHASE_show] = wall;
+   for (i = 0; i < PHASE_show; i++)
+      Frame_phases[PHASE_show] -= Frame_phases[i];
+
+   frame_ios(&Frame_costs);
+   Frame_costs.reads -= beg->reads;
+   Frame_costs.bytes -= beg->bytes;
+   Frame_costs.allocs -= beg->allocs;
+   Frame_costs.tasks = Frame_maxtask;
+   memcpy(Frame_costs.secs, Frame_phases, sizeof(Frame_phases));
+
+   cost = wall > cpu ? wall : cpu;
+   if (cost > Throttle_cost) Throttle_cost = cost;
+   else Throttle_cost = (3 * Throttle_cost + cost) / 4;
+
+   Throttle_delay = 0;
+   if (0 < Rc.throttle_pct && 0 < Rc.delay_time) {
+      want = Throttle_cost * 100 / Rc.throttle_pct;
+      if (want > Rc.delay_time * THROTLMAX) want = Rc.delay_time * THROTLMAX;
+      if (want > Rc.delay_time) Throttle_delay = want;
+   }
+} // end: frame_cost
+
+
         /*
          * This guy's just a *Helper* function who apportions the
          * remaining amount of screen real estate under multiple windows */
@@ -5644,23 +8225,45 @@ static void frame_hlp (int wix, int max) {
          */
 static void frame_make (void) {
    WIN_t *w = Curwin;             // avoid gcc bloat with a local copy
+   double wall, cpu, t;
    int i, scrlins;
+   FRM_t beg;
 
    // deal with potential signal(s) since the last time around...
    if (Frames_signal)
       zap_fieldstab();
 
+   Frame_tally = 0;
    // whoa either first time or thread/task mode change, (re)prime the pump...
    if (Pseudo_row == PROC_XTRA) {
-      cpus_refresh();
+      if (!Rec_mode) cpus_refresh();
+      if (!Rec_mode && CHKw(w, View_MEMNOD)) nodes_refresh();
       procs_refresh();
-      usleep(LIB_USLEEP);
+      if (REC_play != Rec_mode) usleep(LIB_USLEEP);
       putp(Cap_clr_scr);
-   } else
+   } else if (!Emit_mode)
       putp(Batch ? "\n\n" : Cap_home);
 
+   // the cost of this frame begins here (any priming wait isn't ours)
+   memset(Frame_phases, 0, sizeof(Frame_phases));
+   frame_ios(&beg);
+   wall = secs_now(CLOCK_MONOTONIC);
+   cpu = secs_now(CLOCK_PROCESS_CPUTIME_ID);
+
    sysinfo_refresh(0);
+   t = secs_now(CLOCK_MONOTONIC);
+   Frame_phases[PHASE_sysinfo] += t - wall;
    procs_refresh();
+   Frame_phases[PHASE_procs] += secs_now(CLOCK_MONOTONIC) - t;
+
+   // with csv or json, it's an altogether different sort of frame
+   if (Emit_mode) {
+      Tree_idx = 0;                            // the forest is per frame too
+      emit_frame(w);
+      Pseudo_row = 0;                          // primed, that's once only
+      frame_cost(&beg, wall, cpu);
+      return;
+   }
 
    Tree_idx = Pseudo_row = Msg_row = scrlins = 0;
    summary_show();
@@ -5671,7 +8274,11 @@ static void frame_make (void) {
       [ now that this is positioned after the call to summary_show(), ]
       [ we no longer need or employ tg2(0, Msg_row) since all summary ]
       [ lines end with a newline, and header lines begin with newline ] */
-   if (VIZISw(w) && CHKw(w, View_SCROLL)) PUTT(Scroll_fmts, Frame_maxtask);
+   if (VIZISw(w) && CHKw(w, View_SCROLL)) PUTT(Scroll_fmts, w->pptcnt, Frame_bytes);
+   else if (REC_play == Rec_mode) PUTT("%s  %.*s%s", Caps_off, Screen_cols - 3
+      , rec_status(), Cap_clr_eol);
+   else if (Throttle_delay) PUTT("%s  %.*s%s", Caps_off, Screen_cols - 3
+      , fmtmk(N_fmt(THROTL_delay_fmt), Throttle_delay, Throttle_cost * 1000), Cap_clr_eol);
    else putp(Cap_clr_eol);
 
    if (!Rc.mode_altscr) {
@@ -5696,6 +8303,8 @@ static void frame_make (void) {
       PSU_CLREOS(Pseudo_row);
    }
    fflush(stdout);
+   Frame_bytes = Frame_tally;
+   frame_cost(&beg, wall, cpu);
 
    /* we'll deem any terminal not supporting tgoto as dumb and disable
       the normal non-interactive output optimization... */
@@ -5722,18 +8331,24 @@ int main (int dont_care_argc, char **argv) {
 
    for (;;) {
       struct timespec ts;
+      float delay;
 
       frame_make();
 
       if (0 < Loops) --Loops;
       if (!Loops) bye_bye(NULL);
+      // (and a batch replay is over at the recording's end)
+      if (Batch && REC_play == Rec_mode && Rec_pos >= Rec_len) bye_bye(NULL);
 
-      ts.tv_sec = Rc.delay_time;
-      ts.tv_nsec = (Rc.delay_time - (int)Rc.delay_time) * 1000000000;
+      // should our frames be costing too much, we'll wait a little longer
+      delay = Throttle_delay > Rc.delay_time ? Throttle_delay : Rc.delay_time;
+      ts.tv_sec = delay;
+      ts.tv_nsec = (delay - (int)delay) * 1000000000;
 
-      if (Batch)
-         pselect(0, NULL, NULL, NULL, &ts, NULL);
-      else {
+      if (Batch) {
+         if (REC_play != Rec_mode)      // (a batch replay needn't wait)
+            pselect(0, NULL, NULL, NULL, &ts, NULL);
+      } else {
          if (ioa(&ts))
             do_key(iokey(1));
       }
@@ -21,6 +21,7 @@
 #define _Itop
 
 #include "../proc/readproc.h"
+#include "../proc/sysinfo.h"
 
         /* Defines represented in configure.ac ----------------------------- */
 //#define BOOST_MEMORY            /* enable extra precision for mem fields   */
@@ -40,8 +41,10 @@
 //#define INSP_SAVEBUF            /* preserve 'Insp_buf' contents in a file  */
 //#define INSP_SLIDE_1            /* when scrolling left/right don't move 8  */
 //#define MEMGRAPH_OLD            /* don't use 'available' when graphing Mem */
+//#define OFF_CELLDIFF            /* resend entire rows, not changed cells   */
 //#define OFF_HST_HASH            /* use BOTH qsort+bsrch vs. hashing scheme */
 //#define OFF_NUMASKIP            /* do NOT skip numa nodes if discontinuous */
+//#define OFF_SCANPOOL            /* read /proc with the main thread only    */
 //#define OFF_SCROLLBK            /* disable tty emulators scrollback buffer */
 //#define OFF_STDERROR            /* disable our stderr buffering (redirect) */
 //#define OFF_STDIOLBF            /* disable our own stdout _IOFBF override  */
@@ -119,6 +122,25 @@ char *strcasestr(const char *haystack, const char *needle);
         /* Specific process id monitoring support (command line only) */
 #define MONPIDMAX  20
 
+        /* Threads reading /proc, most we'll allow and, when the rcfile
+           leaves it to us, most we'll choose (less if fewer cpus) */
+#define POOLTHDMAX  64
+#define POOLTHDDEF  8
+
+        /* The share (percent) of the delay our own frames may cost before
+           the delay is stretched, and the most it can be stretched (times) */
+#define THROTLDEF   20
+#define THROTLMAX   10
+
+        /* Samples kept for each task in the history ring (one per frame),
+           and of those, the most recent ones a sparkline column shows */
+#define HRING_len   60
+#define HRING_spark 15
+
+        /* Frames a recording (--record) holds between its key frames, each
+           of which starts afresh so that a replay can begin there */
+#define REC_KEYFRM  60
+
         /* Output override minimums (the -w switch and/or env vars) */
 #define W_MIN_COL  3
 #define W_MIN_ROW  3
@@ -145,6 +167,8 @@ char *strcasestr(const char *haystack, const char *needle);
 #define READMINSZ  2048
    // size of preallocated search string buffers, same as ioline()
 #define FNDBUFSIZ  MEDBUFSIZ
+   // size of the buffer building each csv or json frame (see emit_frame)
+#define EMITBUFSIZ ( 1024 * 128 )
 
 
    // space between task fields/columns
@@ -205,6 +229,9 @@ enum pflag {
    EU_RZA, EU_RZF, EU_RZL, EU_RZS,
    EU_CGN,
    EU_NMA,
+   EU_DLC, EU_DLB, EU_DLS, EU_DLR,
+   EU_CPA, EU_CPG, EU_RSG, EU_FLA,
+   EU_NMP, EU_NMK,
 #ifdef USE_X_COLHDR
    // not really pflags, used with tbl indexing
    EU_MAXPFLGS
@@ -234,6 +261,10 @@ typedef          long long SIC_t;
         /* Sort support, callback function signature */
 typedef int (*QFP_t)(const void *, const void *);
 
+        /* This typedef is for the sort key extraction callbacks, used
+           with those fields whose values can be sorted numerically */
+typedef unsigned long long (*KFP_t)(const proc_t *);
+
         /* This structure consolidates the information that's used
            in a variety of display roles. */
 typedef struct FLD_t {
@@ -241,6 +272,7 @@ typedef struct FLD_t {
    int           scale;         // scaled target, if applicable
    const int     align;         // the default column alignment flag
    const QFP_t   sort;          // sort function
+   const KFP_t   key;           // sort key function, if a numeric field
    const int     lflg;          // PROC_FILLxxx flag(s) needed by this field
 } FLD_t;
 
@@ -251,7 +283,11 @@ typedef struct FLD_t {
 typedef struct HST_t {
    TIC_t tics;                  // last frame's tics count
    unsigned long maj, min;      // last frame's maj/min_flt counts
+   unsigned long long dlc, dlb, // last frame's taskstats delays
+      dls, dlr;                 //  ( cpu, blkio, swapin & reclaim )
+   unsigned long long stm;      // start time, so a reused pid is new
    int pid;                     // record 'key'
+   int hslot;                   // its history ring slot, else -1
 } HST_t;
 #else
         /* This structure supports 'history' processing and records the bare
@@ -262,11 +298,58 @@ typedef struct HST_t {
 typedef struct HST_t {
    TIC_t tics;                  // last frame's tics count
    unsigned long maj, min;      // last frame's maj/min_flt counts
+   unsigned long long dlc, dlb, // last frame's taskstats delays
+      dls, dlr;                 //  ( cpu, blkio, swapin & reclaim )
+   unsigned long long stm;      // record 'key', with pid (as pids get reused)
    int pid;                     // record 'key'
-   int lnk;                     // next on hash chain
+   int slot;                    // where it landed in the hash table
+   int hslot;                   // its history ring slot, else -1
 } HST_t;
 #endif
 
+        /* This structure is one task group, all those tasks sharing some
+           cgroup (or lxc container), with their totals in a proc_t which
+           is then shown as any task would be (see groups_add) */
+typedef struct GRP_t {
+   proc_t p;                    // the totals, plus its first task's others
+   char  *name;                 // the interned cgroup (or container) name
+   char  *vec[2];               // that name as a vector, for p.cmdline
+   int    link;                 // next group on its hash chain, else -1
+   int    seen;                 // the last frame having any of its tasks
+} GRP_t;
+
+        /* This structure supports our forest view, where each one marks
+           a level of the depth first traversal performed by forest_adds */
+typedef struct TRE_t {
+   int self;                    // the Seed_ppt index of a parent
+   int level;                   // its nesting level (before any limit)
+   int node;                    // next candidate child on its hash chain
+} TRE_t;
+
+        /* This structure represents one slice of a frame's pid list, which
+           is read from /proc by whichever worker thread claims it first */
+typedef struct PSL_t {
+   PROCTAB *PT;                 // opened by the main thread, for this slice
+   proc_t **ppt;                // its own proc_t's, reused frame to frame
+   int      n_alloc;            // number of ppt slots
+   int      n_read;             // number of tasks read in this frame
+} PSL_t;
+
+        /* This structure holds a task's sort key, extracted but once
+           for sorting by a numeric field (see sort_keys) */
+typedef struct SRT_t {
+   unsigned long long key;      // ordered so, whatever the field's type
+   proc_t *p;                   // the task it represents
+} SRT_t;
+
+        /* This structure locates one cell of a PUFF row, as painted, so
+           that only the cells which change need be sent (see row_diff) */
+typedef struct CEL_t {
+   unsigned long long atr;      // hash of the attribute escapes in effect
+   int off;                     // offset of its (printable) char in the row
+   int rst;                     // offset of the Cap_norm before it, else -1
+} CEL_t;
+
         /* These 2 structures store a frame's cpu tics used in history
            calculations.  They exist primarily for SMP support but serve
            all environments. */
@@ -309,6 +392,9 @@ typedef struct CPU_t {
 #define View_LOADAV  0x004000     // 'l' - display load avg and uptime summary
 #define View_STATES  0x002000     // 't' - display task/cpu(s) states summary
 #define View_MEMORY  0x001000     // 'm' - display memory summary
+#define View_PRESSR  0x800000     // 'p' - display pressure stall summary
+#define View_FRAMES 0x1000000     // 'D' - display our own costs, last frame
+#define View_MEMNOD 0x2000000     // '4' - display memory by numa node ('m' too)
 #define View_NOBOLD  0x000008     // 'B' - disable 'bold' attribute globally
 #define View_SCROLL  0x080000     // 'C' - enable coordinates msg w/ scrolling
         // 'Show_' & 'Qsrt_' flags are for task display in a visible window
@@ -324,6 +410,9 @@ typedef struct CPU_t {
 #define Qsrt_NORMAL  0x000004     // 'R' - reversed column sort (high to low)
 #define Show_JRSTRS  0x040000     // 'j' - right justify "string" data cols
 #define Show_JRNUMS  0x020000     // 'J' - right justify "numeric" data cols
+#define Show_GRPCGR 0x4000000     // 'v' - show task totals by cgroup
+#define Show_GRPLXC 0x8000000     // 'v' - show task totals by lxc container
+#define Show_GROUPS (Show_GRPCGR | Show_GRPLXC)
         // these flag(s) have no command as such - they're for internal use
 #define INFINDS_xxx  0x010000     // build rows for find_string, not display
 #define EQUWINS_xxx  0x000001     // rebalance all wins & tasks (off i,n,u/U)
@@ -361,6 +450,74 @@ enum warn_enum {
    Warn_ALT, Warn_VIZ
 };
 
+        /* Batch mode output formats, as set by -O (see emit_frame) */
+enum emit_enum {
+   EMIT_off = 0, EMIT_csv, EMIT_json
+};
+
+        /* Recording (--record) and replay (--replay), as set by parse_args */
+enum rec_enum {
+   REC_off = 0, REC_save, REC_play
+};
+
+        /* How each proc_t field is recorded, as a number or as the id of
+           a string -- the latter from an array, a pointer or a vector */
+enum rec_fld {
+   RF_num, RF_arr, RF_ptr, RF_vec
+};
+
+        /* The summary values of a recorded frame, which are followed by each
+           cpu's numa node (+1) then, for the summary line and each cpu line,
+           its id (+1) and 8 tics and lastly, for each memory node, the 8
+           values of its node_mem (see rec_save) */
+enum rec_sys {
+   RS_uptime, RS_load1, RS_load5, RS_load15, RS_upline,
+   RS_ncpus, RS_nodes, RS_lines, RS_mnodes,
+   RS_mtotal, RS_mfree, RS_mused, RS_mbuffs, RS_mcache, RS_mavail,
+   RS_stotal, RS_sfree, RS_sused,
+   RS_psi, RS_psome, RS_pfull = RS_psome + PSI_MAX, RS_pstamp = RS_pfull + PSI_MAX,
+   RS_MAX
+};
+
+        /* A recording, which begins with a REC_hdr.  Then come the frames,
+           each a REC_frm (on an 8 byte boundary, so the file can be mapped)
+           followed by varints: its new strings, the summary values and then
+           the tasks, all as deltas from the prior frame unless a key frame */
+#define REC_MAGIC   "top-rec1"
+#define REC_FRMMAG  0x6d726674        // "tfrm", lest a torn tail go unseen
+#define REC_fKEY    0x01              // a key frame, with no deltas
+#define REC_fTHD    0x02              // with threads, not processes
+typedef struct REC_hdr {
+   char     magic [8];                // REC_MAGIC
+   unsigned hertz;                    // clock tics per second, when recorded
+   unsigned pg2k;                     // our Pg2K_shft, when recorded
+} REC_hdr;
+
+typedef struct REC_frm {
+   unsigned magic;                    // REC_FRMMAG
+   unsigned len;                      // bytes, with this header and padding
+   unsigned long long usecs;          // when sampled, since the epoch
+   unsigned flags;                    // REC_fKEY, REC_fTHD
+   unsigned ntasks;                   // tasks, which follow the summary
+   unsigned nstrs;                    // new strings, which follow this
+   unsigned slen;                     //  and their bytes (with each nul)
+} REC_frm;
+
+        /* The phases of each frame, as timed for frame_cost */
+enum phase_enum {
+   PHASE_procs, PHASE_cpus, PHASE_sysinfo, PHASE_sort, PHASE_show, PHASE_MAX
+};
+
+        /* This structure holds what a frame cost us, as shown with View_FRAMES
+           -- our own reads and allocations are counted along with the time */
+typedef struct FRM_t {
+   int    tasks;                  // tasks in that frame
+   double secs [PHASE_MAX];       // elapsed, in each phase
+   unsigned long long reads,      // read calls, from /proc/self/io syscr
+                      bytes;      // bytes read, from /proc/self/io rchar
+   unsigned long allocs;          // calls to our alloc_c or alloc_r
+} FRM_t;
+
         /* This type helps support both a window AND the rcfile */
 typedef struct RCW_t {  // the 'window' portion of an rcfile
    int    sortindx,               // sort field (represented as procflag)
@@ -388,6 +545,8 @@ typedef struct RCF_t {
    int    summ_mscale;          // 'E' - scaling of summary memory values
    int    task_mscale;          // 'e' - scaling of process memory values
    int    zero_suppress;        // '0' - suppress scaled zeros toggle
+   int    pool_threads;         // threads reading /proc (0 = by the cpus)
+   int    throttle_pct;         // % of delay a frame may cost (0 = any)
 } RCF_t;
 
         /* This structure stores configurable information for each window.
@@ -433,6 +592,8 @@ typedef struct WIN_t {
    char  *findstr;                     // window's current/active search string
    int    findlen;                     // above's strlen, without call overhead
    proc_t **ppt;                       // this window's proc_t ptr array
+   int    pptcnt;                      // its entries (tasks, or 'v' groups)
+   int    srtcnt;                      // leading ppt entries now in sort order
    struct WIN_t *next,                 // next window in window stack
                 *prev;                 // prior window in window stack
 } WIN_t;
@@ -491,21 +652,39 @@ typedef struct WIN_t {
 
         /* Used to create *most* of the sort callback functions
            note: some of the callbacks are NOT your father's callbacks, they're
-                 highly optimized to save them ol' precious cycles! */
+                 highly optimized to save them ol' precious cycles!
+           ( the numeric ones also get a sort key callback, whose value is )
+           ( biased when signed so that all keys compare as if unsigned    ) */
 #define SCB_NAME(f) sort_EU_ ## f
+#define SCB_KEYS(f) keys_EU_ ## f
+#define SCB_KEYV(v) ( (__typeof__(v))-1 < 1 \
+   ? (unsigned long long)(long long)(v) ^ 1ull << 63 : (unsigned long long)(v) )
 #define SCB_NUM1(f,n) \
    static int SCB_NAME(f) (const proc_t **P, const proc_t **Q) { \
       if ( (*P)->n < (*Q)->n ) return SORT_lt; \
       if ( (*P)->n > (*Q)->n ) return SORT_gt; \
-      return SORT_eq; }
+      return SORT_eq; } \
+   static unsigned long long SCB_KEYS(f) (const proc_t *P) { \
+      return SCB_KEYV(P->n); }
 #define SCB_NUM2(f,n1,n2) \
    static int SCB_NAME(f) (const proc_t **P, const proc_t **Q) { \
       if ( ((*P)->n1+(*P)->n2) < ((*Q)->n1+(*Q)->n2) ) return SORT_lt; \
       if ( ((*P)->n1+(*P)->n2) > ((*Q)->n1+(*Q)->n2) ) return SORT_gt; \
-      return SORT_eq; }
+      return SORT_eq; } \
+   static unsigned long long SCB_KEYS(f) (const proc_t *P) { \
+      return SCB_KEYV(P->n1+P->n2); }
 #define SCB_NUMx(f,n) \
    static int SCB_NAME(f) (const proc_t **P, const proc_t **Q) { \
-      return Frame_srtflg * ( (*Q)->n - (*P)->n ); }
+      return Frame_srtflg * ( (*Q)->n - (*P)->n ); } \
+   static unsigned long long SCB_KEYS(f) (const proc_t *P) { \
+      return SCB_KEYV(P->n); }
+#define SCB_HIST(f,s) \
+   static int SCB_NAME(f) (const proc_t **P, const proc_t **Q) { \
+      if ( HRING_AVG(*P,s) < HRING_AVG(*Q,s) ) return SORT_lt; \
+      if ( HRING_AVG(*P,s) > HRING_AVG(*Q,s) ) return SORT_gt; \
+      return SORT_eq; } \
+   static unsigned long long SCB_KEYS(f) (const proc_t *P) { \
+      return HRING_AVG(P,s); }
 #define SCB_STRS(f,s) \
    static int SCB_NAME(f) (const proc_t **P, const proc_t **Q) { \
       if (!(*P)->s || !(*Q)->s) return SORT_eq; \
@@ -537,11 +716,31 @@ typedef struct WIN_t {
       putp(_str); \
    } while (0)
 
+        /**  putp - ours is the same as the curses putp, except
+               . every byte it sends to the terminal is tallied */
+#define putp(str) tputs(str, 1, putp_tally)
+
         /**  PUFF - Put for Frame (used in only 3 places)
                . for more permanent frame-oriented 'update' output
                . may NOT contain cursor motion terminfo escapes
                . assumed to represent a complete screen ROW
-               . subject to optimization, thus MAY be discarded */
+               . subject to optimization, thus MAY be discarded
+                 or, unless OFF_CELLDIFF, sent just in part */
+#ifndef OFF_CELLDIFF
+#define PUFF(fmt,arg...) do { \
+      char _str[ROWMAXSIZ], *_eol; \
+      _eol = _str + snprintf(_str, sizeof(_str), fmt, ## arg); \
+      if (Batch) { \
+         while (*(--_eol) == ' '); *(++_eol) = '\0'; putp(_str); } \
+      else { \
+         char *_ptr = &Pseudo_screen[Pseudo_row * ROWMAXSIZ]; \
+         if (Pseudo_row + 1 < Screen_rows) ++Pseudo_row; \
+         if (!strcmp(_ptr, _str)) putp("\n"); \
+         else { \
+            row_diff(_ptr, _str); \
+            strcpy(_ptr, _str); } } \
+   } while (0)
+#else
 #define PUFF(fmt,arg...) do { \
       char _str[ROWMAXSIZ], *_eol; \
       _eol = _str + snprintf(_str, sizeof(_str), fmt, ## arg); \
@@ -555,6 +754,7 @@ typedef struct WIN_t {
             strcpy(_ptr, _str); \
             putp(_ptr); } } \
    } while (0)
+#endif
 
         /**  POOF - Pulled Out of Frame (used in only 1 place)
                . for output that is/was sent directly to the terminal
@@ -631,7 +831,7 @@ typedef struct WIN_t {
    { EU_UEN, ALT_WINFLGS, 0, ALT_GRAPHS2, \
       COLOR_YELLOW, COLOR_YELLOW, COLOR_GREEN, COLOR_YELLOW, \
       "Usr", USR_FIELDS } \
-   }, 0, DEF_SCALES2, 0 }
+   }, 0, DEF_SCALES2, 0, 0, THROTLDEF }
 
         /* Summary Lines specially formatted string(s) --
            see 'show_special' for syntax details + other cautions. */
@@ -668,7 +868,9 @@ typedef struct WIN_t {
 /*atic int           sort_EU_XXX (const proc_t **P, const proc_t **Q);    */
 /*------  Tiny useful routine(s)  ----------------------------------------*/
 //atic const char   *fmtmk (const char *fmts, ...);
+//atic int           putp_tally (int c);
 //atic inline char  *scat (char *dst, const char *src);
+//atic inline double secs_now (clockid_t id);
 //atic const char   *tg2 (int x, int y);
 /*------  Exit/Interrput routines  ---------------------------------------*/
 //atic void          at_eoj (void);
@@ -680,6 +882,9 @@ typedef struct WIN_t {
 //atic void          sig_resize (int dont_care_sig);
 /*------  Misc Color/Display support  ------------------------------------*/
 //atic void          capsmk (WIN_t *q);
+//atic int           esc_len (const char *p);
+//atic int           row_cells (const char *row, CEL_t *cel, int *beg, int *end);
+//atic void          row_diff (const char *old, const char *row);
 //atic void          show_msg (const char *str);
 //atic int           show_pmt (const char *str);
 //atic void          show_special (int interact, const char *glob);
@@ -711,6 +916,7 @@ typedef struct WIN_t {
 //atic const char   *scale_num (unsigned long num, int width, int justr);
 //atic const char   *scale_pcnt (float num, int width, int justr);
 //atic const char   *scale_tics (TIC_t tics, int width, int justr);
+//atic const char   *spark_make (const proc_t *p, int cpu, int width);
 /*------  Fields Management support  -------------------------------------*/
 /*atic FLD_t         Fieldstab[] = { ... }                                */
 //atic void          adj_geometry (void);
@@ -720,6 +926,29 @@ typedef struct WIN_t {
 //atic void          fields_utility (void);
 //atic inline void   widths_resize (void);
 //atic void          zap_fieldstab (void);
+/*------  Record and Replay  ---------------------------------------------*/
+/*atic struct        Rec_flds[] = { ... }                                 */
+//atic void          rec_raw (int b, const void *src, size_t len);
+//atic inline void   rec_put (unsigned long long v);
+//atic inline unsigned long long rec_get (void);
+//atic void          rec_vput (const unsigned long long *v, const unsigned long long *old, int n);
+//atic void          rec_vget (unsigned long long *v, const unsigned long long *old, int n);
+//atic inline unsigned rec_hash (const char *s);
+//atic unsigned      rec_intern (const char *s, unsigned old);
+//atic void          rec_vals (const proc_t *p, unsigned long long *v, const unsigned long long *old);
+//atic int           rec_base (int tid, int want);
+//atic void          rec_save (proc_t **ppt, int n);
+//atic size_t        rec_walk (const char *map, size_t len, int keys);
+//atic void          rec_decode (void);
+//atic void          rec_task (proc_t *p, const unsigned long long *v);
+//atic int           rec_next (void);
+//atic int           rec_cpu (int n, int *id, TIC_t *tics);
+//atic int           rec_psi (psi_info *psi);
+//atic int           rec_nodes (node_mem *mem, int max);
+//atic unsigned long long rec_when (const char *str, unsigned long long from);
+//atic void          rec_seek (unsigned long long when);
+//atic const char   *rec_status (void);
+//atic void          rec_open (const char *when);
 /*------  Library Interface  ---------------------------------------------*/
 //atic void          cpus_refresh (void);
 #ifdef OFF_HST_HASH
@@ -728,7 +957,16 @@ typedef struct WIN_t {
 //atic inline HST_t *hstget (int pid);
 //atic inline void   hstput (unsigned idx);
 #endif
+//atic void          hring_frame (void);
+//atic inline int    hring_slot (HST_t *h);
+//atic inline void   hring_save (int s, const proc_t *p);
+//atic void          groups_hash (int b);
+//atic void          groups_frame (void);
+//atic void          groups_add (int b, const proc_t *p);
+//atic int           groups_ppt (int b, proc_t **ppt);
 //atic void          procs_hlp (proc_t *p);
+//atic void          psi_refresh (void);
+//atic void          nodes_refresh (void);
 //atic void          procs_refresh (void);
 //atic void          sysinfo_refresh (int forced);
 /*------  Inspect Other Output  ------------------------------------------*/
@@ -748,6 +986,7 @@ typedef struct WIN_t {
 //atic void          before (char *me);
 //atic int           config_cvt (WIN_t *q);
 //atic void          configs_read (void);
+//atic const char   *parse_long (const char *cp, char ***args, const char *name);
 //atic void          parse_args (char **args);
 //atic void          whack_terminal (void);
 /*------  Windows/Field Groups support  ----------------------------------*/
@@ -779,13 +1018,26 @@ typedef struct WIN_t {
 #endif
 //atic void          forest_create (WIN_t *q);
 //atic inline const char *forest_display (const WIN_t *q, const proc_t *p);
+/*------  Machine Readable Output  ---------------------------------------*/
+//atic void          emit_flush (void);
+//atic void          emit_frame (WIN_t *q);
+//atic void          emit_int (long long num, int dec);
+//atic void          emit_key (int first, const char *name);
+//atic void          emit_num (unsigned long long num, int dec);
+//atic void          emit_raw (const char *str, int len);
+//atic void          emit_str (const char *str);
+//atic void          emit_task (const WIN_t *q, const proc_t *p);
 /*------  Main Screen routines  ------------------------------------------*/
 //atic void          do_key (int ch);
 //atic void          summary_hlp (CPU_t *cpu, const char *pfx);
 //atic void          summary_show (void);
 //atic const char   *task_show (const WIN_t *q, const proc_t *p);
+//atic void          sort_keys (proc_t **ppt, int n, KFP_t key);
+//atic void          window_hlp (WIN_t *q, int need);
 //atic int           window_show (WIN_t *q, int wmax);
 /*------  Entry point plus two  ------------------------------------------*/
+//atic void          frame_ios (FRM_t *f);
+//atic void          frame_cost (const FRM_t *beg, double wall, double cpu);
 //atic void          frame_hlp (int wix, int max);
 //atic void          frame_make (void);
 //     int           main (int dont_care_argc, char **argv);
@@ -296,6 +296,36 @@ static void build_two_nlstabs (void) {
 /* Translation Hint: maximum 'NU' = 2 */
    Head_nlstab[EU_NMA] = _("NU");
    Desc_nlstab[EU_NMA] = _("Last Used NUMA node");
+/* Translation Hint: maximum 'DLYc' = 4 */
+   Head_nlstab[EU_DLC] = _("DLYc");
+   Desc_nlstab[EU_DLC] = _("CPU Delay %");
+/* Translation Hint: maximum 'DLYb' = 4 */
+   Head_nlstab[EU_DLB] = _("DLYb");
+   Desc_nlstab[EU_DLB] = _("Block IO Delay %");
+/* Translation Hint: maximum 'DLYs' = 4 */
+   Head_nlstab[EU_DLS] = _("DLYs");
+   Desc_nlstab[EU_DLS] = _("Swap-in Delay %");
+/* Translation Hint: maximum 'DLYr' = 4 */
+   Head_nlstab[EU_DLR] = _("DLYr");
+   Desc_nlstab[EU_DLR] = _("Reclaim Delay %");
+/* Translation Hint: maximum '%CPUa' = 5 */
+   Head_nlstab[EU_CPA] = _("%CPUa");
+   Desc_nlstab[EU_CPA] = _("CPU Usage, average");
+/* Translation Hint: maximum '%CPU~' = 15 */
+   Head_nlstab[EU_CPG] = _("%CPU~");
+   Desc_nlstab[EU_CPG] = _("CPU Usage, history");
+/* Translation Hint: maximum 'RES~' = 15 */
+   Head_nlstab[EU_RSG] = _("RES~");
+   Desc_nlstab[EU_RSG] = _("Resident Size, history");
+/* Translation Hint: maximum 'FLTa' = 4 */
+   Head_nlstab[EU_FLA] = _("FLTa");
+   Desc_nlstab[EU_FLA] = _("Page Faults, average");
+/* Translation Hint: maximum 'NUp' = 3 */
+   Head_nlstab[EU_NMP] = _("NUp");
+   Desc_nlstab[EU_NMP] = _("Preferred NUMA node");
+/* Translation Hint: maximum 'NODE:KiB' = 8 */
+   Head_nlstab[EU_NMK] = _("NODE:KiB");
+   Desc_nlstab[EU_NMK] = _("Memory by NUMA node");
 }
 
 
@@ -331,7 +361,12 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[LIMIT_exceed_fmt] = _("pid limit (%d) exceeded");
    Norm_nlstab[BAD_mon_pids_fmt] = _("bad pid '%s'");
    Norm_nlstab[MISSING_args_fmt] = _("-%c requires argument");
+   Norm_nlstab[MISSING_cgroup_txt] = _("--cgroup requires argument");
+   Norm_nlstab[BAD_cgrppath_fmt] = _("bad cgroup '%s': %s");
+   Norm_nlstab[NOT_cgroupfs_txt] = _("not within /sys/fs/cgroup");
+   Norm_nlstab[MISSING_lngarg_fmt] = _("--%s requires argument");
    Norm_nlstab[BAD_widtharg_fmt] = _("bad width arg '%s'");
+   Norm_nlstab[BAD_emitfmts_fmt] = _("bad output format '%s', try csv or json");
    Norm_nlstab[UNKNOWN_opts_fmt] = _(""
       "unknown option '%c'\n"
       "Usage:\n  %s%s");
@@ -341,7 +376,8 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[OFF_one_word_txt] = _("Off");
 /* Translation Hint: Only the following words should be translated
    .                 secs (seconds), max (maximum), user, field, cols (columns)*/
-   Norm_nlstab[USAGE_abbrev_txt] = _(" -hv | -bcEHiOSs1 -d secs -n max -u|U user -p pid(s) -o field -w [cols]");
+   Norm_nlstab[USAGE_abbrev_txt] = _(" -hv | -bcEHiOSs1 -d secs -n max -u|U user -p pid(s) -o field -w [cols]\n"
+      "  -O csv|json --cgroup path --record file | --replay file [--at when]");
    Norm_nlstab[FAIL_statget_txt] = _("failed /proc/stat read");
    Norm_nlstab[FOREST_modes_fmt] = _("Forest mode %s");
    Norm_nlstab[FAIL_tty_get_txt] = _("failed tty get");
@@ -367,8 +403,13 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[GET_max_task_fmt] = _("Maximum tasks = %d, change to (0 is unlimited)");
    Norm_nlstab[BAD_max_task_txt] = _("Invalid maximum");
    Norm_nlstab[GET_user_ids_txt] = _("Which user (blank for all)");
+   Norm_nlstab[GROUPS_modes_fmt] = _("Task groups %s");
+   Norm_nlstab[GROUPS_cgroup_txt] = _("by cgroup");
+   Norm_nlstab[GROUPS_lxcnam_txt] = _("by container");
    Norm_nlstab[UNKNOWN_cmds_txt] = _("Unknown command - try 'h' for help");
    Norm_nlstab[SCROLL_coord_fmt] = _("scroll coordinates: y = %d/%%d (tasks), x = %d/%d (fields)");
+   Norm_nlstab[SCROLL_bytes_fmt] = _("%lu bytes last frame");
+   Norm_nlstab[THROTL_delay_fmt] = _("throttled: delay now %.2f, as frames cost %.0f msec");
    Norm_nlstab[FAIL_alloc_c_txt] = _("failed memory allocate");
    Norm_nlstab[FAIL_alloc_r_txt] = _("failed memory re-allocate");
    Norm_nlstab[BAD_numfloat_txt] = _("Unacceptable floating point");
@@ -382,6 +423,17 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[NOT_smp_cpus_txt] = _("Only 1 cpu detected");
    Norm_nlstab[BAD_integers_txt] = _("Unacceptable integer");
    Norm_nlstab[SELECT_clash_txt] = _("conflicting process selections (U/p/u)");
+   Norm_nlstab[RECORD_failed_fmt] = _("failed '%s' write: %s");
+   Norm_nlstab[REPLAY_badfile_fmt] = _("'%s' is not a top recording");
+   Norm_nlstab[REPLAY_badwhen_fmt] = _("bad time '%s', try hh:mm[:ss] or +/-secs");
+   Norm_nlstab[REPLAY_clashes_txt] = _("conflicting options (--record/--replay/--cgroup)");
+   Norm_nlstab[REPLAY_notnow_txt] = _("Unavailable when replaying");
+   Norm_nlstab[REPLAY_onlyso_txt] = _("Only available when replaying");
+   Norm_nlstab[REPLAY_getwhen_txt] = _("Go to time (hh:mm[:ss] or +/-secs)");
+/* Translation Hint: the first %s is a file name, the second a date and
+   .                 time then the third, if not empty, REPLAY_at_end_txt */
+   Norm_nlstab[REPLAY_status_fmt] = _("replaying '%s', at %s%s");
+   Norm_nlstab[REPLAY_at_end_txt] = _(" (end of recording)");
 /* Translation Hint: This is an abbreviation (limit 3 characters) for:
    .                 kibibytes (1024 bytes) */
    Norm_nlstab[AMT_kilobyte_txt] = _("KiB");
@@ -478,10 +530,12 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[OSEL_statlin_fmt] = _("<Enter> to resume, filters: %s");
    Norm_nlstab[WORD_noneone_txt] = _("none");
 /* Translation Hint: The following word 'Node' should be exactly 4 characters */
+   Norm_nlstab[NUMA_memnot_txt] = _("sorry, NUMA node memory unavailable");
    Norm_nlstab[NUMA_nodenam_fmt] = _("Node%-2d:");
    Norm_nlstab[NUMA_nodeget_fmt] = _("expand which node (0-%d)");
    Norm_nlstab[NUMA_nodebad_txt] = _("invalid node");
    Norm_nlstab[NUMA_nodenot_txt] = _("sorry, NUMA extensions unavailable");
+   Norm_nlstab[PRESSR_nohave_txt] = _("sorry, pressure stall information unavailable");
 /* Translation Hint: 'Mem ' is an abbreviation for physical memory/ram
    .                 'Swap' represents the linux swap file --
    .                 please make both translations exactly 4 characters,
@@ -527,12 +581,13 @@ static void build_uniq_nlstab (void) {
       "Window ~1%s~6: ~1Cumulative mode ~3%s~2.  ~1System~6: ~1Delay ~3%.1f secs~2; ~1Secure mode ~3%s~2.\n"
       "\n"
       "  Z~5,~1B~5,E,e   Global: '~1Z~2' colors; '~1B~2' bold; '~1E~2'/'~1e~2' summary/task memory scale\n"
-      "  l,t,m     Toggle Summary: '~1l~2' load avg; '~1t~2' task/cpu stats; '~1m~2' memory info\n"
-      "  0,1,2,3,I Toggle: '~10~2' zeros; '~11~2/~12~2/~13~2' cpus or numa node views; '~1I~2' Irix mode\n"
+      "  l,t,m,p,D Summary: '~1l~2' load; '~1t~2' task/cpu; '~1m~2' memory; '~1p~2' stalls; '~1D~2' costs\n"
+      "  0-4,I     Toggle: '~10~2' zeros; '~11~2/~12~2/~13~2' cpu/node views; '~14~2' node memory; '~1I~2' Irix\n"
       "  f,F,X     Fields: '~1f~2'/'~1F~2' add/remove/order/sort; '~1X~2' increase fixed-width\n"
       "\n"
       "  L,&,<,> . Locate: '~1L~2'/'~1&~2' find/again; Move sort column: '~1<~2'/'~1>~2' left/right\n"
       "  R,H,V,J . Toggle: '~1R~2' Sort; '~1H~2' Threads; '~1V~2' Forest view; '~1J~2' Num justify\n"
+      "  v       . Toggle: '~1v~2' Task groups, totaled by cgroup, by container or off\n"
       "  c,i,S,j . Toggle: '~1c~2' Cmd name/line; '~1i~2' Idle; '~1S~2' Time; '~1j~2' Str justify\n"
       "  x~5,~1y~5     . Toggle highlights: '~1x~2' sort field; '~1y~2' running tasks\n"
       "  z~5,~1b~5     . Toggle: '~1z~2' color/mono; '~1b~2' bold/reverse (only if 'x' or 'y')\n"
@@ -541,7 +596,7 @@ static void build_uniq_nlstab (void) {
       "  C,...   . Toggle scroll coordinates msg for: ~1up~2,~1down~2,~1left~2,~1right~2,~1home~2,~1end~2\n"
       "\n"
       "%s"
-      "  W,Y       Write configuration file '~1W~2'; Inspect other output '~1Y~2'\n"
+      "  W,Y,@     Write config file '~1W~2'; Inspect other output '~1Y~2'; Replay at '~1@~2'\n"
       "  q         Quit\n"
       "          ( commands shown with '.' require a ~1visible~2 task display ~1window~2 ) \n"
       "Press '~1h~2' or '~1?~2' for help with ~1Windows~2,\n"
@@ -660,6 +715,23 @@ static void build_uniq_nlstab (void) {
       "%s %s:~3 %9.9s~2total,~3 %9.9s~2free,~3 %9.9s~2used,~3 %9.9s~2buff/cache~3\n"
       "%s %s:~3 %9.9s~2total,~3 %9.9s~2free,~3 %9.9s~2used.~3 %9.9s~2avail %s~3\n");
 
+/* Translation Hint: Only the following words need be translated
+   .                 file = page cache, anon = anonymous, hit/miss = pages
+   .                 allocated on this node as intended/though meant elsewhere */
+   Uniq_nlstab[MEMORY_nodes_fmt] = _(""
+      "%-9.9s~3 %9.9s~2total,~3 %9.9s~2free,~3 %9.9s~2file,~3 %9.9s~2anon,~3 %7llu~2/~3%-7llu~2hit/miss~3\n");
+
+/* Translation Hint: Only the following words need be translated
+   .                 some = some tasks stalled, full = all tasks stalled */
+   Uniq_nlstab[PRESSR_line_1_fmt] = _("%%Stall:~3"
+      " %#5.1f~2/~3%-#5.1f ~2cpu,~3 %#5.1f~2/~3%-#5.1f ~2memory,~3 %#5.1f~2/~3%-#5.1f ~2io~3   ~2(some/full)~3\n");
+
+/* Translation Hint: Only the following words need be translated
+   .                 usecs = microseconds, spent in each part of a frame */
+   Uniq_nlstab[FRAMES_lines_fmt] = _("Frame:~3"
+      " %6d ~2tasks,~3 %8llu ~2reads,~3 %10llu ~2bytes,~3 %7lu ~2allocs~3\n"
+      "usecs:~3 %6lu ~2procs,~3 %6lu ~2cpus,~3 %6lu ~2sysinfo,~3 %6lu ~2sort,~3 %6lu ~2show~3\n");
+
    Uniq_nlstab[YINSP_hdsels_fmt] = _(""
       "Inspection~2 Pause at: pid ~1%d~6, running ~1%s~6\n"
       "Use~2:  left/right then <Enter> to ~1select~5 an option; 'q' or <Esc> to ~1end~5 !\n"
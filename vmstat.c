@@ -78,6 +78,9 @@ static int w_option;
 /* "-t" means "show timestamp" */
 static int t_option;
 
+/* "-P" means "show pressure stalls" */
+static int P_option;
+
 static unsigned sleep_time = 1;
 static int infinite_updates = 0;
 static unsigned long num_updates;
@@ -104,6 +107,7 @@ static void __attribute__ ((__noreturn__))
 	fputs(_(" -S, --unit <char>      define display unit\n"), out);
 	fputs(_(" -w, --wide             wide output\n"), out);
 	fputs(_(" -t, --timestamp        show timestamp\n"), out);
+	fputs(_(" -P, --pressure         show pressure stall percentages\n"), out);
 	fputs(USAGE_SEPARATOR, out);
 	fputs(USAGE_HELP, out);
 	fputs(USAGE_VERSION, out);
@@ -196,6 +200,7 @@ static void new_header(void)
 	const char *wide_header =
 	    _("procs -----------------------memory---------------------- ---swap-- -----io---- -system-- --------cpu--------");
 	const char *timestamp_header = _(" -----timestamp-----");
+	const char *pressure_header = _(" ---------stall---------");
 
 	const char format[] =
 	    "%2s %2s %6s %6s %6s %6s %4s %4s %5s %5s %4s %4s %2s %2s %2s %2s %2s";
@@ -205,6 +210,10 @@ static void new_header(void)
 
 	printf("%s", w_option ? wide_header : header);
 
+	if (P_option) {
+		printf("%s", pressure_header);
+	}
+
 	if (t_option) {
 		printf("%s", timestamp_header);
 	}
@@ -252,6 +261,22 @@ static void new_header(void)
 	    /* Translation Hint: max 2 chars */
 	     _("st"));
 
+	if (P_option) {
+		printf(" %3s %3s %3s %3s %3s %3s",
+		/* Translation Hint: max 3 chars, cpu some */
+		       _("c-s"),
+		/* Translation Hint: max 3 chars, cpu full */
+		       _("c-f"),
+		/* Translation Hint: max 3 chars, memory some */
+		       _("m-s"),
+		/* Translation Hint: max 3 chars, memory full */
+		       _("m-f"),
+		/* Translation Hint: max 3 chars, io some */
+		       _("i-s"),
+		/* Translation Hint: max 3 chars, io full */
+		       _("i-f"));
+	}
+
 	if (t_option) {
 		(void) time( &the_time );
 		tm_ptr = localtime( &the_time );
@@ -273,6 +298,18 @@ static unsigned long unitConvert(unsigned long size)
 	return ((unsigned long)cvSize);
 }
 
+/* the PSI columns, for the interval between two samples */
+static void pressure_format(const psi_info *now, const psi_info *prev)
+{
+	double some[PSI_MAX], full[PSI_MAX];
+
+	pressure_pct(now, prev, some, full);
+	printf(" %3u %3u %3u %3u %3u %3u",
+	       (unsigned)(some[PSI_CPU] + 0.5), (unsigned)(full[PSI_CPU] + 0.5),
+	       (unsigned)(some[PSI_MEM] + 0.5), (unsigned)(full[PSI_MEM] + 0.5),
+	       (unsigned)(some[PSI_IO] + 0.5), (unsigned)(full[PSI_IO] + 0.5));
+}
+
 static void new_format(void)
 {
 	const char format[] =
@@ -289,6 +326,7 @@ static void new_format(void)
 	jiff duse, dsys, didl, diow, dstl, Div, divo2;
 	unsigned long pgpgin[2], pgpgout[2], pswpin[2], pswpout[2];
 	unsigned int intr[2], ctxt[2];
+	psi_info psi[2];
 	unsigned int sleep_half;
 	unsigned long kb_per_page = sysconf(_SC_PAGESIZE) / 1024ul;
 	int debt = 0;		/* handle idle ticks running backwards */
@@ -303,6 +341,10 @@ static void new_format(void)
 	getstat(cpu_use, cpu_nic, cpu_sys, cpu_idl, cpu_iow, cpu_xxx, cpu_yyy,
 		cpu_zzz, pgpgin, pgpgout, pswpin, pswpout, intr, ctxt, &running,
 		&blocked, &dummy_1, &dummy_2);
+	if (P_option) {
+		getpressure(psi);
+		memset(psi + 1, 0, sizeof(psi_info));
+	}
 
 	if (t_option) {
 		(void) time( &the_time );
@@ -336,6 +378,10 @@ static void new_format(void)
 	       (unsigned)( (100*dstl			+ divo2) / Div )
 	);
 
+	/* like the rest, the first line is the average since boot */
+	if (P_option)
+		pressure_format(psi, psi + 1);
+
 	if (t_option) {
 		printf(" %s", timebuf);
 	}
@@ -356,6 +402,8 @@ static void new_format(void)
 			cpu_yyy + tog, cpu_zzz + tog, pgpgin + tog,
 			pgpgout + tog, pswpin + tog, pswpout + tog, intr + tog,
 			ctxt + tog, &running, &blocked, &dummy_1, &dummy_2);
+		if (P_option)
+			getpressure(psi + tog);
 
 		if (t_option) {
 			(void) time( &the_time );
@@ -415,6 +463,9 @@ static void new_format(void)
 		       (unsigned)( (100*dstl+divo2)/Div )
 		);
 
+		if (P_option)
+			pressure_format(psi + tog, psi + !tog);
+
 		if (t_option) {
 			printf(" %s", timebuf);
 		}
@@ -867,6 +918,7 @@ int main(int argc, char *argv[])
 		{"unit", required_argument, NULL, 'S'},
 		{"wide", no_argument, NULL, 'w'},
 		{"timestamp", no_argument, NULL, 't'},
+		{"pressure", no_argument, NULL, 'P'},
 		{"help", no_argument, NULL, 'h'},
 		{"version", no_argument, NULL, 'V'},
 		{NULL, 0, NULL, 0}
@@ -881,7 +933,7 @@ int main(int argc, char *argv[])
 	atexit(close_stdout);
 
 	while ((c =
-		getopt_long(argc, argv, "afmnsdDp:S:wthV", longopts,
+		getopt_long(argc, argv, "afmnsdDp:S:wtPhV", longopts,
 			    NULL)) != EOF)
 		switch (c) {
 		case 'V':
@@ -950,6 +1002,9 @@ int main(int argc, char *argv[])
 		case 't':
 			t_option = 1;
 			break;
+		case 'P':
+			P_option = 1;
+			break;
 		default:
 			/* no other aguments defined yet. */
 			usage(stderr);
@@ -971,6 +1026,13 @@ int main(int argc, char *argv[])
 	if (optind < argc)
 		usage(stderr);
 
+	if (P_option) {
+		psi_info psi;
+		if (!getpressure(&psi))
+			xerrx(EXIT_FAILURE,
+			     _("your kernel does not support pressure stall information. (4.20 or above required)"));
+	}
+
 	if (moreheaders) {
 		int wheight = winhi() - 3;
 		height = ((wheight > 0) ? wheight : 22);